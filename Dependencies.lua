@@ -30,4 +30,10 @@ Library["ShaderC_Release"]			= "%{LibraryDir.VulkanSDK}/shaderc_shared.lib"
 Library["SPIRV_Cross_Release"]		= "%{LibraryDir.VulkanSDK}/spirv-cross-core.lib"
 Library["SPIRV_Cross_GLSL_Release"]	= "%{LibraryDir.VulkanSDK}/spirv-cross-glsl.lib"
 
-Library["GLFW3"]					= "%{LibraryDir.GLFW3Lib}/glfw3.lib"
\ No newline at end of file
+Library["GLFW3"]					= "%{LibraryDir.GLFW3Lib}/glfw3.lib"
+
+-- Linux links against the SDK or distribution packages found on the library path
+Library["Vulkan_Linux"]				= "vulkan"
+Library["ShaderC_Linux"]			= "shaderc_shared"
+Library["SPIRV_Cross_Linux"]		= "spirv-cross-core"
+Library["SPIRV_Cross_GLSL_Linux"]	= "spirv-cross-glsl"
\ No newline at end of file
@@ -32,11 +32,6 @@ project "VulkanEngine"
 		"%{IncludeDir.GLM}",
 		"%{IncludeDir.VulkanSDK}"
 	}
-	
-	links
-	{
-		"GLFW"
-	}
 
 	filter "system:windows"
 		systemversion "latest"
@@ -45,11 +40,37 @@ project "VulkanEngine"
 		{
 		}
 
+		links
+		{
+			"GLFW",
+			"Winmm"
+		}
+
+	-- Linux only builds the headless window, GLFW and the Windows platform code are left out
+	filter "system:linux"
+		pic "on"
+
+		removefiles
+		{
+			"src/Platform/Windows/**"
+		}
+
+		links
+		{
+			"%{Library.Vulkan_Linux}",
+			"%{Library.ShaderC_Linux}",
+			"%{Library.SPIRV_Cross_Linux}",
+			"%{Library.SPIRV_Cross_GLSL_Linux}",
+			"pthread",
+			"dl"
+		}
+
 	filter "configurations:Debug"
 		defines "VE_DEBUG"
 		runtime "Debug"
 		symbols "on"
-		
+
+	filter { "system:windows", "configurations:Debug" }
 		links
 		{
 			"%{Library.ShaderC_Debug}",
@@ -63,7 +84,8 @@ project "VulkanEngine"
 		defines "VE_RELEASE"
 		runtime "Release"
 		optimize "on"
-		
+
+	filter { "system:windows", "configurations:Release" }
 		links
 		{
 			"%{Library.ShaderC_Release}",
@@ -77,7 +99,8 @@ project "VulkanEngine"
 		defines "VE_DIST"
 		runtime "Release"
 		optimize "on"
-		
+
+	filter { "system:windows", "configurations:Dist" }
 		links
 		{
 			"%{Library.ShaderC_Release}",
@@ -1,7 +1,11 @@
 #include "vepch.h"
 #include "Core/Application.h"
 
-#include <GLFW/glfw3.h>
+#include "Core/JobSystem.h"
+
+#include "Renderer/ShaderCompiler.h"
+
+#include "Platform/Vulkan/VulkanInstance.h"
 
 namespace VE
 {
@@ -9,38 +13,108 @@ namespace VE
 	Application* Application::s_Instance;
 
 	Application::Application( const ApplicationSpecification& specification )
-		: m_Specification( specification )
+		: m_RenderThread( specification.CoreThreadingPolicy ), m_Specification( specification )
 	{
 		VE_ASSERT( !s_Instance, "Application already exists!" );
 		s_Instance = this;
 
-		WindowSpecification windowSepcification;
-		windowSepcification.Title = specification.Name;
-		windowSepcification.Width = specification.WindowWidth;
-		windowSepcification.Height = specification.WindowHeight;
-		windowSepcification.VSync = specification.VSync;
-		m_Window = std::unique_ptr<Window>( Window::Create( windowSepcification ) );
-		m_Window->Init();
-		m_Window->SetEventCallback( [this]( Event& e ) { return OnEvent( e ); } );
-		m_Window->SetResizable( specification.Resizable );
-		m_Window->SetVSync( false );
+		Profiler::Init();
+		if ( specification.ProfileStartup )
+			Profiler::BeginCapture();
+
+		{
+			VE_PROFILE_SCOPE( "Application initialization" );
+
+			{
+				VE_PROFILE_SCOPE( "JobSystem::Init" );
+				JobSystem::Init( specification.WorkerThreadCount );
+			}
+			{
+				VE_PROFILE_SCOPE( "Renderer::Init" );
+				Renderer::SetConfig( specification.RenderConfig );
+				Renderer::Init();
+			}
+			{
+				VE_PROFILE_SCOPE( "ShaderCompiler::Init" );
+				ShaderCompiler::Init();
+			}
+
+			WindowSpecification windowSepcification;
+			windowSepcification.Title = specification.Name;
+			windowSepcification.Width = specification.WindowWidth;
+			windowSepcification.Height = specification.WindowHeight;
+			windowSepcification.VSync = specification.VSync;
+			windowSepcification.Headless = specification.Headless;
+			m_Window = std::unique_ptr<Window>( Window::Create( windowSepcification ) );
+			m_Window->Init();
+			m_Window->SetResizable( specification.Resizable );
+			m_Window->SetVSync( specification.VSync );
+			m_FrameLimiter.SetTargetFrameRate( specification.MaxFrameRate );
+
+			m_RenderThread.Run();
+		}
+
+		if ( specification.ProfileStartup )
+			Profiler::EndCapture( "profile/startup.json" );
+
+		Log::ReportStatistics( "startup" );
 	}
 
 	Application::~Application()
 	{
-		m_Window->SetEventCallback( []( Event& e ) {} );
+		// Layers may still submit render commands while they detach
+		m_LayerStack.Clear();
+		m_RenderThread.Terminate();
+
+		const EventQueueStatistics& events = m_Window->GetEventQueue().GetTotalStatistics();
+		VE_INFO( "events: {0} received, {1} merged into a later event", events.ReceivedCount, events.CoalescedCount );
+		VE_INFO( "frames: {0} rendered, {1} skipped while idle", m_RenderedFrameCount, m_IdleFrameCount );
+
+		ShaderCompiler::Shutdown();
+		Renderer::Shutdown();
+		JobSystem::Shutdown();
+		Profiler::Shutdown();
 	}
 
 	void Application::Close()
 	{
 		m_Running = false;
+		if ( m_Window )
+			m_Window->Wake();
+	}
+
+	void Application::RequestRedraw()
+	{
+		m_RedrawRequested = true;
+		if ( m_Window )
+			m_Window->Wake();
+	}
+
+	void Application::PushLayer( Layer* layer )
+	{
+		m_LayerStack.PushLayer( layer );
 	}
 
-	void Application::OnEvent( Event& event )
+	void Application::PushOverlay( Layer* overlay )
 	{
-		EventDispatcher dispatcher( event );
-		dispatcher.Dispatch<WindowResizeEvent>( [this]( WindowResizeEvent& e ) { return OnWindowResize( e ); } );
-		dispatcher.Dispatch<WindowCloseEvent>( [this]( WindowCloseEvent& e ) { return OnWindowClose( e ); } );
+		m_LayerStack.PushOverlay( overlay );
+	}
+
+	void Application::OnEvent( Event& event, EventType type )
+	{
+		switch ( type )
+		{
+			case EventType::WindowResize:
+				event.Handled |= OnWindowResize( static_cast< WindowResizeEvent& >( event ) );
+				break;
+			case EventType::WindowClose:
+				event.Handled |= OnWindowClose( static_cast< WindowCloseEvent& >( event ) );
+				break;
+			default:
+				break;
+		}
+
+		m_LayerStack.OnEvent( event, type );
 	}
 
 	bool Application::OnWindowResize( WindowResizeEvent& e )
@@ -53,7 +127,11 @@ namespace VE
 		}
 		m_Minimized = false;
 
-		m_Window->GetSwapChain().OnResize( width, height );
+		VulkanSwapChain& swapChain = m_Window->GetSwapChain();
+		Renderer::Submit( [&swapChain, width, height]()
+			{
+				swapChain.OnResize( width, height );
+			} );
 
 		return false;
 	}
@@ -66,14 +144,113 @@ namespace VE
 
 	void Application::Run()
 	{
+		const double fixedStep = 1.0 / m_Specification.FixedUpdateRate;
+		const double maxFrameTime = fixedStep * m_Specification.MaxUpdatesPerFrame;
+		double accumulator = 0.0;
+
+		Timer frameTimer;
+		// The frame submitted in one iteration is only handed to the render thread in the next one
+		bool frameSubmitted = false;
 		while ( m_Running )
 		{
-			m_Window->ProcessEvents();
+			VE_PROFILE_SCOPE( "Application::Run frame" );
+
+			// The render thread must be done with the previous frame before it is handed the next one
+			{
+				VE_PROFILE_SCOPE( "Wait for render thread" );
+				m_RenderThread.BlockUntilRenderComplete();
+			}
 
-			if ( !m_Minimized )
+			// With nothing to show, sleep in the OS until input arrives instead of rendering identical frames.
+			// A frame submitted last iteration still has to be kicked first or it would wait for the next event.
+			bool idle = !frameSubmitted && ( m_Minimized || ( m_Specification.RenderOnDemand && !m_RedrawRequested && !m_LayerStack.IsDirty() ) );
+			if ( idle )
+				m_Window->WaitEvents( m_Specification.IdleTimeout );
+			else
+				m_Window->ProcessEvents();
+
+			// Everything that arrived since the last frame is handled in one go, after mouse moves and resizes
+			// have been merged
 			{
-				m_Window->GetSwapChain().DrawFrame();
+				VE_PROFILE_SCOPE( "Dispatch events" );
+				m_Window->GetEventQueue().Dispatch( [this]( Event& e, EventType type ) { OnEvent( e, type ); } );
+			}
+			bool eventsArrived = m_Window->GetEventQueue().GetStatistics().DispatchedCount > 0;
+
+			// Render the frame submitted last iteration while this iteration submits the next one
+			m_RenderThread.NextFrame();
+			m_RenderThread.Kick();
+
+			m_FrameTime = frameTimer.Elapsed();
+			frameTimer.Reset();
+
+			// After a stall (a breakpoint, a window drag) the simulation skips ahead instead of running a burst
+			// of updates that would make the next frame even longer
+			accumulator += std::min( ( double )m_FrameTime.GetSeconds(), maxFrameTime );
+
+			{
+				VE_PROFILE_SCOPE( "Application::OnUpdate" );
+				while ( accumulator >= fixedStep )
+				{
+					OnUpdate( Timestep( ( float )fixedStep ) );
+
+					for ( Layer* layer : m_LayerStack )
+					{
+						layer->OnUpdate( Timestep( ( float )fixedStep ) );
+					}
+
+					accumulator -= fixedStep;
+				}
 			}
+
+			// Skipped frames neither acquire nor present, the render thread only gets an empty queue
+			bool redraw = !m_Minimized;
+			if ( redraw && m_Specification.RenderOnDemand )
+			{
+				bool redrawRequested = m_RedrawRequested.exchange( false );
+				redraw = eventsArrived || redrawRequested || m_LayerStack.IsDirty();
+			}
+
+			frameSubmitted = redraw;
+			if ( redraw )
+			{
+				// Layers that keep animating mark themselves dirty again in OnRender
+				m_LayerStack.ClearDirty();
+
+				{
+					VE_PROFILE_SCOPE( "Application::OnRender" );
+					float alpha = ( float )( accumulator / fixedStep );
+					OnRender( alpha );
+
+					for ( Layer* layer : m_LayerStack )
+					{
+						layer->OnRender( alpha );
+					}
+				}
+
+				VulkanSwapChain& swapChain = m_Window->GetSwapChain();
+				Renderer::Submit( [&swapChain]()
+					{
+						swapChain.DrawFrame();
+					} );
+
+				// Pipelines created while attaching layers and drawing the first frame make up the startup cost
+				if ( m_RenderedFrameCount == 0 )
+				{
+					Renderer::Submit( []()
+						{
+							VulkanInstance::GetCurrentDevice()->GetPipelineCache().LogStatistics( "startup" );
+						} );
+				}
+
+				m_RenderedFrameCount++;
+			}
+			else
+			{
+				m_IdleFrameCount++;
+			}
+
+			m_FrameLimiter.Wait();
 		}
 	}
 
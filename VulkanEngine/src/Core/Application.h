@@ -1,9 +1,15 @@
 #pragma once
 
+#include "Core/FrameLimiter.h"
+#include "Core/LayerStack.h"
+#include "Core/Timestep.h"
 #include "Core/Window.h"
 
 #include "Events/ApplicationEvent.h"
 
+#include "Renderer/Renderer.h"
+#include "Renderer/RenderThread.h"
+
 #include <vulkan/vulkan.h>
 
 namespace VE
@@ -15,6 +21,25 @@ namespace VE
 		uint32_t WindowHeight = 900;
 		bool VSync = true;
 		bool Resizable = true;
+		// Renders offscreen without a window, for benchmarks and build machines
+		bool Headless = false;
+		// 0 uses one worker per hardware thread
+		uint32_t WorkerThreadCount = 0;
+		ThreadingPolicy CoreThreadingPolicy = ThreadingPolicy::MultiThreaded;
+		// Captures engine initialization and writes it to profile/startup.json
+		bool ProfileStartup = false;
+		// Rate of the OnUpdate calls, in Hz
+		float FixedUpdateRate = 60.0f;
+		// Updates one frame may run to catch up after a stall, the remaining time is dropped
+		uint32_t MaxUpdatesPerFrame = 8;
+		// 0 leaves the frame rate to the swapchain
+		uint32_t MaxFrameRate = 0;
+		// Only renders a frame after input, a RequestRedraw or a dirty layer. Otherwise the main thread sleeps
+		// in the OS until an event arrives or IdleTimeout seconds have passed.
+		bool RenderOnDemand = false;
+		float IdleTimeout = 0.5f;
+
+		RendererConfig RenderConfig;
 	};
 
 	class Application
@@ -25,8 +50,35 @@ namespace VE
 
 		void Run();
 		void Close();
+		// Any thread: renders at least one more frame when rendering on demand, e.g. after a resource changed
+		void RequestRedraw();
 
-		virtual void OnEvent( Event& event );
+		void PushLayer( Layer* layer );
+		void PushOverlay( Layer* overlay );
+
+		// Handles the events the application itself cares about, then passes the event down the layer stack
+		void OnEvent( Event& event, EventType type );
+		void OnEvent( Event& event )
+		{
+			OnEvent( event, event.GetEventType() );
+		}
+		// Main thread, at FixedUpdateRate. A frame runs as many updates as the time since the last frame
+		// covers, which may be none.
+		virtual void OnUpdate( Timestep ts )
+		{
+		}
+		// Main thread, once per frame after the updates while the render thread renders the previous frame.
+		// alpha is how far the frame lies between the last update and the next one, for interpolating state.
+		// Render commands submitted here belong to this frame.
+		virtual void OnRender( float alpha )
+		{
+		}
+
+		// Wall clock time of the last frame
+		Timestep GetFrameTime() const
+		{
+			return m_FrameTime;
+		}
 
 		Window& GetWindow()
 		{
@@ -49,6 +101,14 @@ namespace VE
 
 	private:
 		Scope<Window> m_Window;
+		RenderThread m_RenderThread;
+		LayerStack m_LayerStack;
+		FrameLimiter m_FrameLimiter;
+		Timestep m_FrameTime;
+
+		std::atomic<bool> m_RedrawRequested = true;
+		uint64_t m_RenderedFrameCount = 0;
+		uint64_t m_IdleFrameCount = 0;
 		bool m_Running = true;
 		bool m_Minimized = false;
 
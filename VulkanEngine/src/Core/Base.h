@@ -11,6 +11,9 @@
 		/* Windows x86 */
 		#error "x86 Builds are not supported!"
 	#endif
+#elif defined(__linux__)
+	/* Linux, headless only */
+	#define VE_PLATFORM_LINUX
 #else
 	/* Unknown compiler/platform */
 	#error "Unknown platform!"
@@ -19,6 +22,9 @@
 #ifdef VE_DEBUG
 	#ifdef VE_PLATFORM_WINDOWS
 		#define VE_DEBUGBREAK() __debugbreak()
+	#elif defined(VE_PLATFORM_LINUX)
+		#include <signal.h>
+		#define VE_DEBUGBREAK() raise(SIGTRAP)
 	#else
 		#error "Platform doesn't support debugbreak yet!"
 	#endif
@@ -52,6 +58,7 @@ namespace VE
 }
 
 #include "Core/Log.h"
+#include "Core/Profiler.h"
 #include <filesystem>
 
 #ifdef VE_ENABLE_ASSERTS
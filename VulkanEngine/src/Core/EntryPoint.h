@@ -1,6 +1,6 @@
 #pragma once
 
-#ifdef VE_PLATFORM_WINDOWS
+#if defined(VE_PLATFORM_WINDOWS) || defined(VE_PLATFORM_LINUX)
 
 extern VE::Application* VE::CreateApplication( int argc, char** argv );
 
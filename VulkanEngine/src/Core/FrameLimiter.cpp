@@ -0,0 +1,75 @@
+#include "vepch.h"
+#include "Core/FrameLimiter.h"
+
+#include <thread>
+
+namespace VE
+{
+
+	FrameLimiter::FrameLimiter()
+	{
+#ifdef VE_PLATFORM_WINDOWS
+		// The default timer resolution of 15.6ms makes every sleep far too coarse
+		timeBeginPeriod( 1 );
+#endif
+		m_NextFrame = Clock::now();
+	}
+
+	FrameLimiter::~FrameLimiter()
+	{
+#ifdef VE_PLATFORM_WINDOWS
+		timeEndPeriod( 1 );
+#endif
+	}
+
+	void FrameLimiter::SetTargetFrameRate( uint32_t framesPerSecond )
+	{
+		m_FrameInterval = framesPerSecond > 0 ? std::chrono::duration_cast< Clock::duration >( std::chrono::duration<double>( 1.0 / framesPerSecond ) ) : Clock::duration::zero();
+		m_NextFrame = Clock::now() + m_FrameInterval;
+	}
+
+	// Yielding for longer than this costs more CPU than an occasional late frame is worth
+	static constexpr double s_MaxSpinTime = 0.002;
+
+	void FrameLimiter::Wait()
+	{
+		if ( m_FrameInterval == Clock::duration::zero() )
+			return;
+
+		VE_PROFILE_FUNCTION();
+
+		while ( true )
+		{
+			Clock::time_point now = Clock::now();
+			Clock::duration remaining = m_NextFrame - now;
+			if ( remaining <= Clock::duration::zero() )
+				break;
+
+			// Two standard deviations above the mean covers nearly every sleep
+			double spinTime = std::min( m_OvershootMean + 2.0 * std::sqrt( m_OvershootVariance ), s_MaxSpinTime );
+			Clock::duration spin = std::chrono::duration_cast< Clock::duration >( std::chrono::duration<double>( spinTime ) );
+
+			if ( remaining > spin )
+			{
+				Clock::duration request = remaining - spin;
+				std::this_thread::sleep_for( request );
+
+				double overshoot = std::chrono::duration<double>( ( Clock::now() - now ) - request ).count();
+				double delta = overshoot - m_OvershootMean;
+				m_OvershootMean += delta / 16.0;
+				m_OvershootVariance += ( delta * delta - m_OvershootVariance ) / 16.0;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// A frame that ran late does not make the following ones run early to catch up
+		Clock::time_point now = Clock::now();
+		m_NextFrame += m_FrameInterval;
+		if ( m_NextFrame < now )
+			m_NextFrame = now + m_FrameInterval;
+	}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+
+namespace VE
+{
+	// Caps the frame rate by sleeping until the next frame is due. Sleeping alone overshoots by up to the
+	// scheduler granularity, so the limiter sleeps until it is within its measured overshoot of the deadline
+	// and yields for the rest. That keeps the pacing precise without spinning a core for the whole wait.
+	class FrameLimiter
+	{
+	public:
+		FrameLimiter();
+		~FrameLimiter();
+
+		// 0 disables the limit
+		void SetTargetFrameRate( uint32_t framesPerSecond );
+
+		// Main thread, once per frame. Returns once the frame interval since the previous call has passed.
+		void Wait();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		Clock::duration m_FrameInterval = Clock::duration::zero();
+		Clock::time_point m_NextFrame;
+
+		// Running mean and variance of how much longer than requested a sleep takes, in seconds
+		double m_OvershootMean = 0.0005;
+		double m_OvershootVariance = 0.0;
+	};
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string_view>
+
+namespace VE
+{
+	// 64-bit FNV-1a. Not suitable for anything adversarial, but fast, stable across runs and platforms, and
+	// good enough to key caches on content.
+	class Hash
+	{
+	public:
+		static constexpr uint64_t FNVOffsetBasis = 14695981039346656037ull;
+		static constexpr uint64_t FNVPrime = 1099511628211ull;
+
+		static uint64_t FNV( const void* data, size_t size, uint64_t hash = FNVOffsetBasis )
+		{
+			const uint8_t* bytes = ( const uint8_t* )data;
+			for ( size_t i = 0; i < size; i++ )
+			{
+				hash ^= bytes[ i ];
+				hash *= FNVPrime;
+			}
+			return hash;
+		}
+
+		static uint64_t FNV( std::string_view string, uint64_t hash = FNVOffsetBasis )
+		{
+			return FNV( string.data(), string.size(), hash );
+		}
+
+		template<typename T>
+		static uint64_t FNVValue( const T& value, uint64_t hash = FNVOffsetBasis )
+		{
+			static_assert( std::is_trivially_copyable_v<T> );
+			return FNV( &value, sizeof( T ), hash );
+		}
+	};
+}
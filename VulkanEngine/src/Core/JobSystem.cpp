@@ -0,0 +1,279 @@
+#include "vepch.h"
+#include "Core/JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace VE
+{
+
+	struct JobEntry
+	{
+		Job Function;
+		JobCounter* Counter = nullptr;
+	};
+
+	// The owning thread pushes and pops at the back, other threads steal from the front
+	struct JobQueue
+	{
+		std::mutex Mutex;
+		std::deque<JobEntry> Jobs;
+	};
+
+	struct JobSystemData
+	{
+		// Queue 0 belongs to every non-worker thread, queues 1..N to the workers
+		std::vector<Scope<JobQueue>> Queues;
+		std::vector<std::thread> Workers;
+
+		std::atomic<uint32_t> PendingJobs = 0;
+		std::atomic<uint32_t> ActiveWorkers = 0;
+		std::atomic<bool> Running = false;
+
+		std::mutex WakeMutex;
+		std::condition_variable WakeCondition;
+	};
+
+	static JobSystemData* s_Data = nullptr;
+	static thread_local uint32_t s_ThreadIndex = 0;
+
+	void JobSystem::Init( uint32_t workerCount )
+	{
+		VE_ASSERT( !s_Data, "JobSystem already initialized!" );
+
+		if ( workerCount == 0 )
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		s_Data = new JobSystemData();
+		s_Data->Running = true;
+		s_Data->ActiveWorkers = workerCount;
+
+		for ( uint32_t i = 0; i <= workerCount; i++ )
+		{
+			s_Data->Queues.push_back( CreateScope<JobQueue>() );
+		}
+
+		for ( uint32_t i = 1; i <= workerCount; i++ )
+		{
+			s_Data->Workers.emplace_back( &JobSystem::WorkerMain, i );
+		}
+
+		VE_INFO( "JobSystem started with {0} worker threads", workerCount );
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if ( !s_Data )
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock( s_Data->WakeMutex );
+			s_Data->Running = false;
+		}
+		s_Data->WakeCondition.notify_all();
+
+		for ( auto& worker : s_Data->Workers )
+		{
+			worker.join();
+		}
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void JobSystem::Run( Job job, JobCounter* counter, JobCounter* dependency )
+	{
+		if ( counter )
+			counter->m_Count.fetch_add( 1, std::memory_order_relaxed );
+
+		if ( dependency )
+		{
+			std::lock_guard<std::mutex> lock( dependency->m_Mutex );
+			if ( dependency->m_Count.load( std::memory_order_acquire ) != 0 )
+			{
+				dependency->m_Continuations.push_back( [job = std::move( job ), counter]() mutable
+					{
+						Schedule( std::move( job ), counter );
+					} );
+				return;
+			}
+		}
+
+		Schedule( std::move( job ), counter );
+	}
+
+	void JobSystem::ParallelFor( uint32_t count, uint32_t batchSize, const std::function<void( uint32_t, uint32_t )>& func )
+	{
+		if ( count == 0 )
+			return;
+
+		batchSize = std::max( batchSize, 1u );
+
+		if ( !s_Data || count <= batchSize )
+		{
+			func( 0, count );
+			return;
+		}
+
+		JobCounter counter;
+		for ( uint32_t begin = 0; begin < count; begin += batchSize )
+		{
+			uint32_t end = std::min( begin + batchSize, count );
+			Run( [&func, begin, end]() { func( begin, end ); }, &counter );
+		}
+
+		Wait( counter );
+	}
+
+	void JobSystem::Wait( JobCounter& counter )
+	{
+		while ( !counter.IsDone() )
+		{
+			if ( !s_Data || !ExecuteNext( s_ThreadIndex ) )
+				std::this_thread::yield();
+		}
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return s_Data ? ( uint32_t )s_Data->Workers.size() : 0;
+	}
+
+	void JobSystem::SetActiveWorkerCount( uint32_t count )
+	{
+		VE_ASSERT( s_Data, "JobSystem not initialized!" );
+
+		{
+			std::lock_guard<std::mutex> lock( s_Data->WakeMutex );
+			s_Data->ActiveWorkers = std::min( count, ( uint32_t )s_Data->Workers.size() );
+		}
+		s_Data->WakeCondition.notify_all();
+	}
+
+	uint32_t JobSystem::GetActiveWorkerCount()
+	{
+		return s_Data ? s_Data->ActiveWorkers.load( std::memory_order_relaxed ) : 0;
+	}
+
+	uint32_t JobSystem::GetThreadIndex()
+	{
+		return s_ThreadIndex;
+	}
+
+	void JobSystem::Schedule( Job job, JobCounter* counter )
+	{
+		if ( !s_Data )
+		{
+			job();
+			Finish( counter );
+			return;
+		}
+
+		JobQueue& queue = *s_Data->Queues[ s_ThreadIndex ];
+		{
+			std::lock_guard<std::mutex> lock( queue.Mutex );
+			queue.Jobs.push_back( { std::move( job ), counter } );
+		}
+
+		s_Data->PendingJobs.fetch_add( 1, std::memory_order_release );
+		{
+			// Pairs with the predicate check in WorkerMain so the wake up cannot be lost
+			std::lock_guard<std::mutex> lock( s_Data->WakeMutex );
+		}
+		// notify_one could wake a parked worker that goes straight back to sleep
+		if ( s_Data->ActiveWorkers.load( std::memory_order_relaxed ) < s_Data->Workers.size() )
+			s_Data->WakeCondition.notify_all();
+		else
+			s_Data->WakeCondition.notify_one();
+	}
+
+	void JobSystem::Finish( JobCounter* counter )
+	{
+		if ( !counter )
+			return;
+
+		// The counter may be destroyed as soon as a waiter sees it reach zero, so the last access to it has to
+		// happen under the mutex that IsDone takes after seeing zero
+		std::vector<Job> continuations;
+		{
+			std::lock_guard<std::mutex> lock( counter->m_Mutex );
+			if ( counter->m_Count.fetch_sub( 1, std::memory_order_acq_rel ) != 1 )
+				return;
+
+			continuations.swap( counter->m_Continuations );
+		}
+
+		for ( auto& continuation : continuations )
+		{
+			continuation();
+		}
+	}
+
+	bool JobSystem::ExecuteNext( uint32_t threadIndex )
+	{
+		const uint32_t queueCount = ( uint32_t )s_Data->Queues.size();
+
+		JobEntry entry;
+		bool found = false;
+
+		{
+			JobQueue& own = *s_Data->Queues[ threadIndex ];
+			std::lock_guard<std::mutex> lock( own.Mutex );
+			if ( !own.Jobs.empty() )
+			{
+				entry = std::move( own.Jobs.back() );
+				own.Jobs.pop_back();
+				found = true;
+			}
+		}
+
+		for ( uint32_t i = 1; i < queueCount && !found; i++ )
+		{
+			JobQueue& victim = *s_Data->Queues[ ( threadIndex + i ) % queueCount ];
+			std::lock_guard<std::mutex> lock( victim.Mutex );
+			if ( !victim.Jobs.empty() )
+			{
+				entry = std::move( victim.Jobs.front() );
+				victim.Jobs.pop_front();
+				found = true;
+			}
+		}
+
+		if ( !found )
+			return false;
+
+		s_Data->PendingJobs.fetch_sub( 1, std::memory_order_relaxed );
+
+		entry.Function();
+		Finish( entry.Counter );
+		return true;
+	}
+
+	void JobSystem::WorkerMain( uint32_t threadIndex )
+	{
+		s_ThreadIndex = threadIndex;
+		Profiler::SetThreadName( "Worker " + std::to_string( threadIndex ) );
+
+		while ( true )
+		{
+			bool active = threadIndex <= s_Data->ActiveWorkers.load( std::memory_order_relaxed );
+			if ( active && ExecuteNext( threadIndex ) )
+				continue;
+
+			std::unique_lock<std::mutex> lock( s_Data->WakeMutex );
+			s_Data->WakeCondition.wait( lock, [threadIndex]()
+				{
+					return !s_Data->Running || ( threadIndex <= s_Data->ActiveWorkers.load( std::memory_order_relaxed ) &&
+						s_Data->PendingJobs.load( std::memory_order_acquire ) > 0 );
+				} );
+
+			if ( !s_Data->Running )
+				break;
+		}
+	}
+
+}
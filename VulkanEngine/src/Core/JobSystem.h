@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+namespace VE
+{
+	using Job = std::function<void()>;
+
+	// Counts outstanding jobs. Jobs attached to a counter increment it when they are scheduled and decrement
+	// it when they finish, so a counter doubles as a completion handle and as a dependency for other jobs.
+	// A counter must outlive every job that references it. Once IsDone has returned true the jobs are finished
+	// with it, so it can be destroyed right away.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter( const JobCounter& ) = delete;
+		JobCounter& operator=( const JobCounter& ) = delete;
+
+		bool IsDone() const
+		{
+			if ( m_Count.load( std::memory_order_acquire ) != 0 )
+				return false;
+
+			// The last job decrements under the mutex and only lets go of the counter when it unlocks
+			std::lock_guard<std::mutex> lock( m_Mutex );
+			return true;
+		}
+
+	private:
+		std::atomic<uint32_t> m_Count = 0;
+
+		mutable std::mutex m_Mutex;
+		std::vector<Job> m_Continuations;
+
+		friend class JobSystem;
+	};
+
+	class JobSystem
+	{
+	public:
+		// workerCount = 0 uses one worker per hardware thread, minus the calling thread
+		static void Init( uint32_t workerCount = 0 );
+		static void Shutdown();
+
+		// Schedules a job. If counter is given it is incremented now and decremented when the job finishes.
+		// If dependency is given the job only becomes runnable once the dependency counter reaches zero.
+		static void Run( Job job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr );
+
+		// Runs func( begin, end ) over [0, count) in chunks of at most batchSize and returns when every chunk is done
+		static void ParallelFor( uint32_t count, uint32_t batchSize, const std::function<void( uint32_t, uint32_t )>& func );
+
+		// Blocks until the counter reaches zero. The calling thread executes pending jobs while it waits.
+		static void Wait( JobCounter& counter );
+
+		static uint32_t GetWorkerCount();
+
+		// Workers above count stop taking jobs until the count is raised again, so parallel code can be measured
+		// at every thread count without restarting the job system. Defaults to every worker.
+		static void SetActiveWorkerCount( uint32_t count );
+		static uint32_t GetActiveWorkerCount();
+		// 0 for any thread that is not a worker, 1..GetWorkerCount() for the workers
+		static uint32_t GetThreadIndex();
+
+	private:
+		static void Schedule( Job job, JobCounter* counter );
+		static void Finish( JobCounter* counter );
+		static bool ExecuteNext( uint32_t threadIndex );
+		static void WorkerMain( uint32_t threadIndex );
+	};
+}
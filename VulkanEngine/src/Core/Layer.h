@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Core/Timestep.h"
+
+#include "Events/Event.h"
+
+namespace VE
+{
+	using EventHandlerFn = std::function<bool( Event& )>;
+
+	// Part of the application that receives events and updates every frame. A layer declares the event
+	// categories it accepts and subscribes handlers per event type, normally in its constructor or OnAttach.
+	// The layer stack indexes the handlers by event type when the layer is pushed, so dispatching an event
+	// never calls into layers that have no handler for its type.
+	class Layer
+	{
+	public:
+		Layer( const std::string& name = "Layer", int eventCategories = EventCategory::None )
+			: m_Name( name ), m_EventCategories( eventCategories )
+		{
+		}
+		virtual ~Layer() = default;
+
+		virtual void OnAttach()
+		{
+		}
+		virtual void OnDetach()
+		{
+		}
+		// Fixed rate, see Application::OnUpdate
+		virtual void OnUpdate( Timestep ts )
+		{
+		}
+		// Once per frame, see Application::OnRender
+		virtual void OnRender( float alpha )
+		{
+		}
+
+		const std::string& GetName() const
+		{
+			return m_Name;
+		}
+		int GetEventCategories() const
+		{
+			return m_EventCategories;
+		}
+
+		// Asks for another frame when the application renders on demand. A layer that animates calls this
+		// from every OnRender for as long as the animation runs.
+		void MarkDirty()
+		{
+			m_Dirty = true;
+		}
+		bool IsDirty() const
+		{
+			return m_Dirty;
+		}
+
+	protected:
+		// func( T& ) returns true when the event is handled, which stops it from reaching the layers below.
+		// Subscriptions must be made before the layer is pushed, later ones are not seen by the layer stack.
+		template<typename T, typename F>
+		void Subscribe( F&& func )
+		{
+			static_assert( std::is_base_of_v<Event, T>, "T must derive from Event!" );
+
+			if ( !( T::GetStaticCategoryFlags() & m_EventCategories ) )
+			{
+				VE_WARN( "layer {0} does not accept the category of {1}, the handler is ignored", m_Name, ( int )T::GetStaticType() );
+				return;
+			}
+
+			m_Handlers[ ( size_t )T::GetStaticType() ] = [handler = std::forward<F>( func )]( Event& event )
+			{
+				return handler( static_cast< T& >( event ) );
+			};
+		}
+
+	private:
+		std::string m_Name;
+		int m_EventCategories;
+		// A new layer has never been rendered
+		bool m_Dirty = true;
+
+		std::array<EventHandlerFn, ( size_t )EventType::Count> m_Handlers;
+
+		friend class LayerStack;
+	};
+}
@@ -0,0 +1,108 @@
+#include "vepch.h"
+#include "Core/LayerStack.h"
+
+namespace VE
+{
+
+	LayerStack::~LayerStack()
+	{
+		Clear();
+	}
+
+	void LayerStack::PushLayer( Layer* layer )
+	{
+		m_Layers.emplace( m_Layers.begin() + m_LayerInsertIndex, layer );
+		m_LayerInsertIndex++;
+		layer->OnAttach();
+
+		BuildDispatchTable();
+	}
+
+	void LayerStack::PushOverlay( Layer* overlay )
+	{
+		m_Layers.emplace_back( overlay );
+		overlay->OnAttach();
+
+		BuildDispatchTable();
+	}
+
+	void LayerStack::PopLayer( Layer* layer )
+	{
+		auto it = std::find( m_Layers.begin(), m_Layers.begin() + m_LayerInsertIndex, layer );
+		if ( it == m_Layers.begin() + m_LayerInsertIndex )
+			return;
+
+		layer->OnDetach();
+		m_Layers.erase( it );
+		m_LayerInsertIndex--;
+
+		BuildDispatchTable();
+	}
+
+	void LayerStack::PopOverlay( Layer* overlay )
+	{
+		auto it = std::find( m_Layers.begin() + m_LayerInsertIndex, m_Layers.end(), overlay );
+		if ( it == m_Layers.end() )
+			return;
+
+		overlay->OnDetach();
+		m_Layers.erase( it );
+
+		BuildDispatchTable();
+	}
+
+	void LayerStack::Clear()
+	{
+		for ( auto it = m_Layers.rbegin(); it != m_Layers.rend(); ++it )
+		{
+			( *it )->OnDetach();
+			delete *it;
+		}
+		m_Layers.clear();
+		m_LayerInsertIndex = 0;
+
+		BuildDispatchTable();
+	}
+
+	bool LayerStack::IsDirty() const
+	{
+		return std::any_of( m_Layers.begin(), m_Layers.end(), []( const Layer* layer ) { return layer->m_Dirty; } );
+	}
+
+	void LayerStack::ClearDirty()
+	{
+		for ( Layer* layer : m_Layers )
+		{
+			layer->m_Dirty = false;
+		}
+	}
+
+	void LayerStack::OnEvent( Event& event, EventType type )
+	{
+		for ( const EventHandlerFn* handler : m_DispatchTable[ ( size_t )type ] )
+		{
+			if ( event.Handled )
+				break;
+
+			event.Handled |= ( *handler )( event );
+		}
+	}
+
+	void LayerStack::BuildDispatchTable()
+	{
+		for ( auto& handlers : m_DispatchTable )
+		{
+			handlers.clear();
+		}
+
+		for ( auto it = m_Layers.rbegin(); it != m_Layers.rend(); ++it )
+		{
+			for ( size_t type = 0; type < m_DispatchTable.size(); type++ )
+			{
+				if ( ( *it )->m_Handlers[ type ] )
+					m_DispatchTable[ type ].push_back( &( *it )->m_Handlers[ type ] );
+			}
+		}
+	}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Core/Layer.h"
+
+namespace VE
+{
+	// Layers are updated bottom to top and receive events top to bottom, overlays always sit above layers.
+	// The stack owns the layers pushed onto it.
+	class LayerStack
+	{
+	public:
+		LayerStack() = default;
+		~LayerStack();
+
+		LayerStack( const LayerStack& ) = delete;
+		LayerStack& operator=( const LayerStack& ) = delete;
+
+		void PushLayer( Layer* layer );
+		void PushOverlay( Layer* overlay );
+		// Hands ownership back to the caller
+		void PopLayer( Layer* layer );
+		void PopOverlay( Layer* overlay );
+		// Detaches and destroys every layer, top to bottom
+		void Clear();
+
+		// True if any layer has asked for a frame since ClearDirty
+		bool IsDirty() const;
+		void ClearDirty();
+
+		// Calls the handlers subscribed to type, top to bottom, until one of them handles the event
+		void OnEvent( Event& event, EventType type );
+
+		std::vector<Layer*>::iterator begin()
+		{
+			return m_Layers.begin();
+		}
+		std::vector<Layer*>::iterator end()
+		{
+			return m_Layers.end();
+		}
+
+	private:
+		void BuildDispatchTable();
+
+	private:
+		std::vector<Layer*> m_Layers;
+		uint32_t m_LayerInsertIndex = 0;
+
+		// Per event type, the handlers in dispatch order
+		std::array<std::vector<const EventHandlerFn*>, ( size_t )EventType::Count> m_DispatchTable;
+	};
+}
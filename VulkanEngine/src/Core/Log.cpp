@@ -1,28 +1,63 @@
 #include "vepch.h"
 #include "Core/Log.h"
 
+#include <spdlog/async.h>
+#include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 namespace VE
 {
+	// Messages the queue holds before the oldest are dropped
+	static constexpr size_t s_QueueSize = 8192;
+	static constexpr size_t s_MaxFileSize = 5 * 1024 * 1024;
+	static constexpr size_t s_MaxFileCount = 3;
+
 	std::shared_ptr<spdlog::logger> Log::s_Logger;
+	std::shared_ptr<spdlog::logger> Log::s_ErrorLogger;
+	std::atomic<uint64_t> Log::s_SkippedCount = 0;
 
 	void Log::Init()
 	{
+		spdlog::init_thread_pool( s_QueueSize, 1 );
+
 		std::vector<spdlog::sink_ptr> VESink =
 		{
-			std::make_shared<spdlog::sinks::stdout_color_sink_mt>()
+			std::make_shared<spdlog::sinks::stdout_color_sink_mt>(),
+			std::make_shared<spdlog::sinks::rotating_file_sink_mt>( "logs/VulkanEngine.log", s_MaxFileSize, s_MaxFileCount )
 		};
 
 		VESink[ 0 ]->set_pattern( "%^[%T] %n: %v%$" );
+		VESink[ 1 ]->set_pattern( "[%Y-%m-%d %T.%e] [%l] [%t] %v" );
 
-		s_Logger = std::make_shared<spdlog::logger>( "VulkanEngine", VESink.begin(), VESink.end() );
-		s_Logger->set_level( spdlog::level::trace );
+		s_Logger = std::make_shared<spdlog::async_logger>( "VulkanEngine", VESink.begin(), VESink.end(), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest );
+		s_Logger->set_level( ( spdlog::level::level_enum )VE_LOG_LEVEL );
+		spdlog::register_logger( s_Logger );
+
+		// Errors usually come right before an assert breaks, so they can neither wait in the queue nor be
+		// overwritten by a full one. Messages still queued may show up after them.
+		s_ErrorLogger = std::make_shared<spdlog::logger>( "VulkanEngine", VESink.begin(), VESink.end() );
+		s_ErrorLogger->set_level( spdlog::level::err );
+		s_ErrorLogger->flush_on( spdlog::level::err );
+		spdlog::flush_every( std::chrono::seconds( 1 ) );
 	}
 
 	void Log::Shutdown()
 	{
+		ReportStatistics( "shutdown" );
+
+		// Writes whatever is still queued and joins the background thread
+		s_Logger->flush();
 		s_Logger.reset();
-		spdlog::drop_all();
+		s_ErrorLogger.reset();
+		spdlog::shutdown();
+	}
+
+	void Log::ReportStatistics( const char* when )
+	{
+		// Info, unless that is compiled out. Dist builds only log warnings, the report goes out at that level
+		// rather than not at all.
+		spdlog::level::level_enum level = ( spdlog::level::level_enum )std::max( VE_LOG_LEVEL, VE_LOG_LEVEL_INFO );
+		s_Logger->log( level, "log ({0}): level {1}, {2} messages skipped by Log::ShouldLog checks (compiled out messages are not counted), {3} dropped by a full queue", when,
+			spdlog::level::to_string_view( s_Logger->level() ), s_SkippedCount.load( std::memory_order_relaxed ), spdlog::thread_pool()->overrun_counter() );
 	}
 }
@@ -2,8 +2,31 @@
 
 #include "spdlog/spdlog.h"
 
+#include <atomic>
+
+// Same values as spdlog::level
+#define VE_LOG_LEVEL_TRACE     0
+#define VE_LOG_LEVEL_INFO      2
+#define VE_LOG_LEVEL_WARN      3
+#define VE_LOG_LEVEL_ERROR     4
+#define VE_LOG_LEVEL_CRITICAL  5
+
+// Messages below this level are compiled out. Their arguments are never evaluated but stay referenced, so
+// variables that only feed a log message do not turn into unused variable warnings.
+#ifndef VE_LOG_LEVEL
+	#ifdef VE_DIST
+		#define VE_LOG_LEVEL VE_LOG_LEVEL_WARN
+	#else
+		#define VE_LOG_LEVEL VE_LOG_LEVEL_TRACE
+	#endif
+#endif
+
 namespace VE
 {
+	// Messages are formatted on the calling thread and queued for a background thread that writes them to the
+	// console and a rotating log file, so logging never waits on I/O. When the queue is full the oldest
+	// messages are dropped instead of blocking the caller. Errors bypass the queue: they are written and
+	// flushed before the call returns, so the message of an assert that breaks right after is never lost.
 	class Log
 	{
 	public:
@@ -15,13 +38,55 @@ namespace VE
 			return s_Logger;
 		}
 
+		// Same sinks, written synchronously
+		inline static std::shared_ptr<spdlog::logger>& GetErrorLogger()
+		{
+			return s_ErrorLogger;
+		}
+
+		inline static std::shared_ptr<spdlog::logger>& GetLogger( spdlog::level::level_enum level )
+		{
+			return level >= spdlog::level::err ? s_ErrorLogger : s_Logger;
+		}
+
+		// For messages that are expensive to build: whether a message at this level would be written at all
+		static bool ShouldLog( spdlog::level::level_enum level )
+		{
+			return level >= VE_LOG_LEVEL && s_Logger->should_log( level );
+		}
+
+		// Messages that were never formatted because ShouldLog said no, or that were folded into another message.
+		// Only call sites that report here are counted, not every message below the level.
+		static void CountSkipped( uint32_t count = 1 )
+		{
+			s_SkippedCount.fetch_add( count, std::memory_order_relaxed );
+		}
+
+		// Logs what was skipped or dropped so far
+		static void ReportStatistics( const char* when );
+
 	private:
 		static std::shared_ptr<spdlog::logger> s_Logger;
+		static std::shared_ptr<spdlog::logger> s_ErrorLogger;
+		static std::atomic<uint64_t> s_SkippedCount;
 	};
 }
 
-#define VE_TRACE(...)     ::VE::Log::GetLogger()->trace(__VA_ARGS__)
-#define VE_INFO(...)      ::VE::Log::GetLogger()->info(__VA_ARGS__)
-#define VE_WARN(...)      ::VE::Log::GetLogger()->warn(__VA_ARGS__)
-#define VE_ERROR(...)     ::VE::Log::GetLogger()->error(__VA_ARGS__)
-#define VE_CRITICAL(...)  ::VE::Log::GetLogger()->critical(__VA_ARGS__)
+#if VE_LOG_LEVEL <= VE_LOG_LEVEL_TRACE
+	#define VE_TRACE(...)     ::VE::Log::GetLogger()->trace(__VA_ARGS__)
+#else
+	#define VE_TRACE(...)     do { if ( false ) ::VE::Log::GetLogger()->trace(__VA_ARGS__); } while ( 0 )
+#endif
+#if VE_LOG_LEVEL <= VE_LOG_LEVEL_INFO
+	#define VE_INFO(...)      ::VE::Log::GetLogger()->info(__VA_ARGS__)
+#else
+	#define VE_INFO(...)      do { if ( false ) ::VE::Log::GetLogger()->info(__VA_ARGS__); } while ( 0 )
+#endif
+#if VE_LOG_LEVEL <= VE_LOG_LEVEL_WARN
+	#define VE_WARN(...)      ::VE::Log::GetLogger()->warn(__VA_ARGS__)
+#else
+	#define VE_WARN(...)      do { if ( false ) ::VE::Log::GetLogger()->warn(__VA_ARGS__); } while ( 0 )
+#endif
+// Always compiled in, asserts report through VE_ERROR
+#define VE_ERROR(...)     ::VE::Log::GetErrorLogger()->error(__VA_ARGS__)
+#define VE_CRITICAL(...)  ::VE::Log::GetErrorLogger()->critical(__VA_ARGS__)
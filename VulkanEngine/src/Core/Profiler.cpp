@@ -0,0 +1,193 @@
+#include "vepch.h"
+#include "Core/Profiler.h"
+
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+
+namespace VE
+{
+	struct ProfileEvent
+	{
+		const char* Name;
+		uint64_t Start;
+		uint64_t End;
+	};
+
+	static constexpr uint32_t s_ChunkSize = 8192;
+	// Per thread and capture, events beyond this are dropped
+	static constexpr uint32_t s_MaxChunks = 256;
+
+	struct ProfileThreadBuffer
+	{
+		uint32_t ThreadID = 0;
+		std::string Name;
+
+		// Chunks are only allocated by the owning thread before the events in them are published through Count
+		std::array<ProfileEvent*, s_MaxChunks> Chunks{};
+		std::atomic<uint32_t> Count = 0;
+		// Capture the events belong to. The owner starts over when it sees that a new capture has begun.
+		std::atomic<uint32_t> Capture = 0;
+		std::atomic<uint32_t> DroppedCount = 0;
+
+		~ProfileThreadBuffer()
+		{
+			for ( auto chunk : Chunks )
+			{
+				delete[] chunk;
+			}
+		}
+	};
+
+	std::atomic<bool> Profiler::s_Capturing = false;
+
+	static std::mutex s_Mutex;
+	// Buffers live until exit, threads keep a raw pointer to theirs
+	static std::vector<Scope<ProfileThreadBuffer>> s_Buffers;
+	static std::atomic<uint32_t> s_Capture = 0;
+	static uint64_t s_CaptureStart = 0;
+
+	static thread_local ProfileThreadBuffer* s_ThreadBuffer = nullptr;
+
+	static ProfileThreadBuffer* GetThreadBuffer()
+	{
+		if ( !s_ThreadBuffer )
+		{
+			std::lock_guard<std::mutex> lock( s_Mutex );
+			auto& buffer = s_Buffers.emplace_back( CreateScope<ProfileThreadBuffer>() );
+			buffer->ThreadID = ( uint32_t )s_Buffers.size();
+			buffer->Name = "Thread " + std::to_string( buffer->ThreadID );
+			s_ThreadBuffer = buffer.get();
+		}
+
+		return s_ThreadBuffer;
+	}
+
+	static void WriteEscaped( std::ostream& stream, const char* string )
+	{
+		for ( const char* c = string; *c; c++ )
+		{
+			if ( *c == '"' || *c == '\\' )
+				stream << '\\';
+			stream << *c;
+		}
+	}
+
+	void Profiler::Init()
+	{
+		SetThreadName( "Main Thread" );
+	}
+
+	void Profiler::Shutdown()
+	{
+		s_Capturing = false;
+	}
+
+	void Profiler::BeginCapture()
+	{
+		std::lock_guard<std::mutex> lock( s_Mutex );
+
+		s_CaptureStart = Now();
+		s_Capture.fetch_add( 1, std::memory_order_release );
+		s_Capturing = true;
+	}
+
+	void Profiler::EndCapture( const std::filesystem::path& path )
+	{
+		s_Capturing = false;
+
+		std::lock_guard<std::mutex> lock( s_Mutex );
+
+		if ( path.has_parent_path() )
+			std::filesystem::create_directories( path.parent_path() );
+
+		std::ofstream stream( path );
+		if ( !stream )
+		{
+			VE_ERROR( "profiler: could not write {0}", path.string() );
+			return;
+		}
+
+		stream << std::fixed << std::setprecision( 3 );
+		stream << "{\"otherData\":{},\"traceEvents\":[";
+
+		uint32_t capture = s_Capture.load( std::memory_order_acquire );
+		uint32_t eventCount = 0, droppedCount = 0;
+		bool first = true;
+		for ( const auto& buffer : s_Buffers )
+		{
+			stream << ( first ? "" : "," ) << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->ThreadID
+				<< ",\"args\":{\"name\":\"";
+			WriteEscaped( stream, buffer->Name.c_str() );
+			stream << "\"}}";
+			first = false;
+
+			if ( buffer->Capture.load( std::memory_order_acquire ) != capture )
+				continue;
+
+			uint32_t count = buffer->Count.load( std::memory_order_acquire );
+			for ( uint32_t i = 0; i < count; i++ )
+			{
+				const ProfileEvent& event = buffer->Chunks[ i / s_ChunkSize ][ i % s_ChunkSize ];
+				if ( event.Start < s_CaptureStart )
+					continue;
+
+				eventCount++;
+				stream << ",\n{\"name\":\"";
+				WriteEscaped( stream, event.Name );
+				stream << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->ThreadID
+					<< ",\"ts\":" << ( event.Start - s_CaptureStart ) * 0.001 << ",\"dur\":" << ( event.End - event.Start ) * 0.001 << "}";
+			}
+
+			droppedCount += buffer->DroppedCount.exchange( 0 );
+		}
+
+		stream << "\n]}\n";
+
+		VE_INFO( "profiler: wrote {0} events from {1} threads to {2}", eventCount, s_Buffers.size(), path.string() );
+		if ( droppedCount > 0 )
+			VE_WARN( "profiler: {0} events were dropped, the capture was too long", droppedCount );
+	}
+
+	void Profiler::SetThreadName( const std::string& name )
+	{
+		ProfileThreadBuffer* buffer = GetThreadBuffer();
+
+		std::lock_guard<std::mutex> lock( s_Mutex );
+		buffer->Name = name;
+	}
+
+	uint64_t Profiler::Now()
+	{
+		return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+	}
+
+	void Profiler::Record( const char* name, uint64_t start, uint64_t end )
+	{
+		if ( !IsCapturing() )
+			return;
+
+		ProfileThreadBuffer* buffer = GetThreadBuffer();
+
+		uint32_t capture = s_Capture.load( std::memory_order_acquire );
+		if ( buffer->Capture.load( std::memory_order_relaxed ) != capture )
+		{
+			buffer->Count.store( 0, std::memory_order_relaxed );
+			buffer->Capture.store( capture, std::memory_order_release );
+		}
+
+		uint32_t index = buffer->Count.load( std::memory_order_relaxed );
+		uint32_t chunk = index / s_ChunkSize;
+		if ( chunk >= s_MaxChunks )
+		{
+			buffer->DroppedCount.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+
+		if ( !buffer->Chunks[ chunk ] )
+			buffer->Chunks[ chunk ] = new ProfileEvent[ s_ChunkSize ];
+
+		buffer->Chunks[ chunk ][ index % s_ChunkSize ] = { name, start, end };
+		buffer->Count.store( index + 1, std::memory_order_release );
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+
+#ifndef VE_DIST
+	#define VE_PROFILE 1
+#else
+	#define VE_PROFILE 0
+#endif
+
+namespace VE
+{
+	// Collects CPU scopes into one buffer per thread. Only the owning thread writes a buffer and it publishes
+	// each event with a single atomic store, so recording never takes a lock. Events are only kept while a
+	// capture is running, outside of one a scope costs an atomic load.
+	class Profiler
+	{
+	public:
+		static void Init();
+		static void Shutdown();
+
+		// Drops whatever the previous capture recorded
+		static void BeginCapture();
+		// Writes every event recorded since BeginCapture as Chrome trace JSON (chrome://tracing, Perfetto)
+		static void EndCapture( const std::filesystem::path& path );
+
+		static bool IsCapturing()
+		{
+			return s_Capturing.load( std::memory_order_relaxed );
+		}
+
+		// Shown as the track name in the trace
+		static void SetThreadName( const std::string& name );
+
+		// Nanoseconds on a monotonic clock
+		static uint64_t Now();
+		// name must outlive the capture, in practice a string literal
+		static void Record( const char* name, uint64_t start, uint64_t end );
+
+	private:
+		static std::atomic<bool> s_Capturing;
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope( const char* name )
+			: m_Name( name ), m_Start( Profiler::IsCapturing() ? Profiler::Now() : 0 )
+		{
+		}
+
+		~ProfileScope()
+		{
+			if ( m_Start )
+				Profiler::Record( m_Name, m_Start, Profiler::Now() );
+		}
+
+		ProfileScope( const ProfileScope& ) = delete;
+		ProfileScope& operator=( const ProfileScope& ) = delete;
+
+	private:
+		const char* m_Name;
+		uint64_t m_Start;
+	};
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+	#define VE_FUNC_SIG __PRETTY_FUNCTION__
+#elif defined(_MSC_VER)
+	#define VE_FUNC_SIG __FUNCSIG__
+#else
+	#define VE_FUNC_SIG __func__
+#endif
+
+#if VE_PROFILE
+	#define VE_PROFILE_CONCAT_IMPL(a, b) a##b
+	#define VE_PROFILE_CONCAT(a, b) VE_PROFILE_CONCAT_IMPL(a, b)
+	#define VE_PROFILE_SCOPE(name) ::VE::ProfileScope VE_PROFILE_CONCAT(profileScope, __LINE__)( name )
+	#define VE_PROFILE_FUNCTION() VE_PROFILE_SCOPE( VE_FUNC_SIG )
+#else
+	#define VE_PROFILE_SCOPE(name)
+	#define VE_PROFILE_FUNCTION()
+#endif
@@ -0,0 +1,26 @@
+#include "vepch.h"
+#include "Core/Window.h"
+
+#include "Platform/Headless/HeadlessWindow.h"
+
+#ifdef VE_PLATFORM_WINDOWS
+	#include "Platform/Windows/WindowsWindow.h"
+#endif
+
+namespace VE
+{
+
+	Window* Window::Create( const WindowSpecification& specification )
+	{
+		if ( specification.Headless )
+			return new HeadlessWindow( specification );
+
+#ifdef VE_PLATFORM_WINDOWS
+		return new WindowsWindow( specification );
+#else
+		VE_ASSERT( false, "Only headless windows are supported on this platform!" );
+		return nullptr;
+#endif
+	}
+
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Events/Event.h"
+#include "Events/EventQueue.h"
 
 #include "Platform/Vulkan/VulkanInstance.h"
 #include "Platform/Vulkan/VulkanSwapChain.h"
@@ -13,24 +13,29 @@ namespace VE
 		uint32_t Width = 1600;
 		uint32_t Height = 900;
 		bool VSync = true;
+		// No OS window or surface, frames are rendered into offscreen images
+		bool Headless = false;
 	};
 
 	class Window
 	{
 	public:
-		using EventCallbackFn = std::function<void( Event& )>;
-
 		virtual ~Window() = default;
 
 		virtual void Init() = 0;
+		// Queues the events that arrived since the last call, they are dispatched by the application
 		virtual void ProcessEvents() = 0;
+		// Like ProcessEvents, but blocks until an event arrives, Wake is called or timeout seconds have passed
+		virtual void WaitEvents( float timeout ) = 0;
+		// Any thread: makes a blocked WaitEvents return
+		virtual void Wake() = 0;
+		virtual EventQueue& GetEventQueue() = 0;
 
 		virtual uint32_t GetWidth() const = 0;
 		virtual uint32_t GetHeight() const = 0;
 		virtual std::pair<uint32_t, uint32_t> GetSize() const = 0;
 		virtual std::pair<float, float> GetWindowPos() const = 0;
 
-		virtual void SetEventCallback( const EventCallbackFn& callback ) = 0;
 		virtual void SetVSync( bool enabled ) = 0;
 		virtual bool IsVSync()const = 0;
 		virtual void SetResizable( bool resizable ) const = 0;
@@ -9,6 +9,8 @@ namespace VE
 	class WindowResizeEvent : public Event
 	{
 	public:
+		static constexpr bool Coalescable = true;
+
 		WindowResizeEvent( unsigned int width, unsigned int height )
 			:m_Width( width ), m_Height( height )
 		{
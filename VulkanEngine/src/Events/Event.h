@@ -10,7 +10,8 @@ namespace VE
 		WindowClose, WindowResize, WindowFocus, WindowLostFocus, WindowMoved,
 		AppTick, AppUpdate, AppRender,
 		KeyPressed, KeyReleased, KeyTyped,
-		MouseButtonPressed, MouseButtonReleased, MouseMoved, MouseScrolled
+		MouseButtonPressed, MouseButtonReleased, MouseMoved, MouseScrolled,
+		Count
 	};
 
 	enum EventCategory
@@ -23,17 +24,21 @@ namespace VE
 		EventCategoryMouseButton	= BIT( 4 )
 	};
 
-#define EVENT_CLASS_TYPE(type)	static  EventType GetStaticType() { return EventType::type; }\
+#define EVENT_CLASS_TYPE(type)	static constexpr EventType GetStaticType() { return EventType::type; }\
 								virtual EventType GetEventType() const override { return GetStaticType(); }\
 								virtual const char* GetName() const override { return #type; }
 
-#define EVENT_CLASS_CATEGORY(category) virtual int GetCategoryFlags() const override { return category; }
+#define EVENT_CLASS_CATEGORY(category)	static constexpr int GetStaticCategoryFlags() { return category; }\
+										virtual int GetCategoryFlags() const override { return GetStaticCategoryFlags(); }
 
 	class Event
 	{
 	public:
 		virtual ~Event() = default;
 
+		// Consecutive queued events of a coalescable type are merged, only the latest one is dispatched
+		static constexpr bool Coalescable = false;
+
 		bool Handled = false;
 
 		virtual EventType GetEventType() const = 0;
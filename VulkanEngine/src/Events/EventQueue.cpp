@@ -0,0 +1,59 @@
+#include "vepch.h"
+#include "Events/EventQueue.h"
+
+namespace VE
+{
+
+	EventQueue::~EventQueue()
+	{
+		for ( auto& queued : m_Events )
+		{
+			queued.Instance->~Event();
+		}
+	}
+
+	void* EventQueue::Allocate( size_t size, size_t alignment )
+	{
+		VE_ASSERT( size <= s_BlockSize, "Event is larger than an event queue block!" );
+
+		// Blocks never move, so events already queued stay valid while handlers push more
+		while ( true )
+		{
+			if ( m_BlockIndex == m_Blocks.size() )
+			{
+				m_Blocks.emplace_back( new uint8_t[ s_BlockSize ] );
+				m_BlockOffset = 0;
+			}
+
+			size_t offset = ( m_BlockOffset + alignment - 1 ) & ~( alignment - 1 );
+			if ( offset + size <= s_BlockSize )
+			{
+				m_BlockOffset = offset + size;
+				return m_Blocks[ m_BlockIndex ].get() + offset;
+			}
+
+			m_BlockIndex++;
+			m_BlockOffset = 0;
+		}
+	}
+
+	void EventQueue::Reset()
+	{
+		for ( auto& queued : m_Events )
+		{
+			queued.Instance->~Event();
+		}
+		m_Events.clear();
+		m_DispatchedCount = 0;
+
+		m_BlockIndex = 0;
+		m_BlockOffset = 0;
+
+		m_Statistics = m_FrameStatistics;
+		m_TotalStatistics.ReceivedCount += m_FrameStatistics.ReceivedCount;
+		m_TotalStatistics.CoalescedCount += m_FrameStatistics.CoalescedCount;
+		m_TotalStatistics.DispatchedCount += m_FrameStatistics.DispatchedCount;
+		m_FrameStatistics = {};
+	}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Events/Event.h"
+
+namespace VE
+{
+	struct EventQueueStatistics
+	{
+		// Events pushed, including the ones merged into an earlier event
+		uint32_t ReceivedCount = 0;
+		// Events that replaced the previous event of the same type instead of being queued
+		uint32_t CoalescedCount = 0;
+		uint32_t DispatchedCount = 0;
+	};
+
+	// Collects the events of a frame so they can be dispatched together. Events are constructed in place in
+	// blocks that are kept from frame to frame, so queueing does not allocate once the blocks have grown to
+	// the busiest frame. A coalescable event that directly follows a queued event of the same type replaces it.
+	class EventQueue
+	{
+	public:
+		EventQueue() = default;
+		~EventQueue();
+
+		EventQueue( const EventQueue& ) = delete;
+		EventQueue& operator=( const EventQueue& ) = delete;
+
+		template<typename T, typename... Args>
+		void Push( Args&&... args )
+		{
+			static_assert( std::is_base_of_v<Event, T>, "T must derive from Event!" );
+
+			m_FrameStatistics.ReceivedCount++;
+
+			// Events that have already been dispatched this frame are not merged into
+			if constexpr ( T::Coalescable )
+			{
+				if ( m_Events.size() > m_DispatchedCount && m_Events.back().Type == T::GetStaticType() )
+				{
+					Event* event = m_Events.back().Instance;
+					event->~Event();
+					new ( event ) T( std::forward<Args>( args )... );
+
+					m_FrameStatistics.CoalescedCount++;
+					return;
+				}
+			}
+
+			void* memory = Allocate( sizeof( T ), alignof( T ) );
+			m_Events.push_back( { new ( memory ) T( std::forward<Args>( args )... ), T::GetStaticType() } );
+		}
+
+		// Calls func( event, type ) for every queued event in the order they were pushed, including events pushed
+		// by func, then empties the queue. The type is recorded at push time, so no virtual call is needed.
+		template<typename F>
+		void Dispatch( F&& func )
+		{
+			while ( m_DispatchedCount < m_Events.size() )
+			{
+				QueuedEvent& queued = m_Events[ m_DispatchedCount++ ];
+				func( *queued.Instance, queued.Type );
+			}
+
+			m_FrameStatistics.DispatchedCount = m_DispatchedCount;
+			Reset();
+		}
+
+		// Counts of the last dispatched frame
+		const EventQueueStatistics& GetStatistics() const
+		{
+			return m_Statistics;
+		}
+		// Since the queue was created
+		const EventQueueStatistics& GetTotalStatistics() const
+		{
+			return m_TotalStatistics;
+		}
+
+	private:
+		void* Allocate( size_t size, size_t alignment );
+		void Reset();
+
+	private:
+		static constexpr size_t s_BlockSize = 16 * 1024;
+
+		std::vector<Scope<uint8_t[]>> m_Blocks;
+		uint32_t m_BlockIndex = 0;
+		size_t m_BlockOffset = 0;
+
+		struct QueuedEvent
+		{
+			Event* Instance;
+			EventType Type;
+		};
+		std::vector<QueuedEvent> m_Events;
+		size_t m_DispatchedCount = 0;
+
+		EventQueueStatistics m_FrameStatistics;
+		EventQueueStatistics m_Statistics;
+		EventQueueStatistics m_TotalStatistics;
+	};
+}
@@ -9,6 +9,8 @@ namespace VE
 	class MouseMovedEvent : public Event
 	{
 	public:
+		static constexpr bool Coalescable = true;
+
 		MouseMovedEvent( float x, float y )
 			: m_MouseX( x ), m_MouseY( y )
 		{
@@ -0,0 +1,78 @@
+#include "vepch.h"
+#include "Platform/Headless/HeadlessWindow.h"
+
+#include "Events/ApplicationEvent.h"
+
+namespace VE
+{
+
+	HeadlessWindow::HeadlessWindow( const WindowSpecification& specification )
+		: m_Specification( specification )
+	{
+	}
+
+	HeadlessWindow::~HeadlessWindow()
+	{
+		m_SwapChain.CleanUp();
+	}
+
+	void HeadlessWindow::Init()
+	{
+		m_Data.Title = m_Specification.Title;
+		m_Data.Width = m_Specification.Width;
+		m_Data.Height = m_Specification.Height;
+		m_Data.VSync = false;
+
+		VE_INFO( "Creating headless window {0} ({1}, {2})", m_Specification.Title, m_Specification.Width, m_Specification.Height );
+
+		VE_PROFILE_SCOPE( "Vulkan initialization" );
+		m_VulkanInstance = CreateRef<VulkanInstance>( true );
+		m_VulkanInstance->Init();
+
+		m_SwapChain.Init( VulkanInstance::GetInstance(), m_VulkanInstance->GetDevice() );
+		m_SwapChain.CreateHeadless( m_Data.Width, m_Data.Height );
+	}
+
+	void HeadlessWindow::ProcessEvents()
+	{
+		VE_PROFILE_FUNCTION();
+	}
+
+	void HeadlessWindow::WaitEvents( float timeout )
+	{
+		VE_PROFILE_FUNCTION();
+
+		// Nothing produces events without a window, so only Wake or the timeout end the wait
+		std::unique_lock<std::mutex> lock( m_WakeMutex );
+		m_WakeCondition.wait_for( lock, std::chrono::duration<float>( timeout ), [this]() { return m_WakeRequested; } );
+		m_WakeRequested = false;
+	}
+
+	void HeadlessWindow::Wake()
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_WakeMutex );
+			m_WakeRequested = true;
+		}
+		m_WakeCondition.notify_one();
+	}
+
+	void HeadlessWindow::Resize( uint32_t width, uint32_t height )
+	{
+		m_Data.Width = width;
+		m_Data.Height = height;
+
+		m_Data.Events.Push<WindowResizeEvent>( width, height );
+	}
+
+	void HeadlessWindow::SetVSync( bool enabled )
+	{
+		// There is no display to synchronize with, frames are always rendered as fast as possible
+	}
+
+	bool HeadlessWindow::IsVSync() const
+	{
+		return m_Data.VSync;
+	}
+
+}
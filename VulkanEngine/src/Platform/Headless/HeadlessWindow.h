@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Core/Window.h"
+
+#include "Platform/Vulkan/VulkanInstance.h"
+#include "Platform/Vulkan/VulkanSwapChain.h"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace VE
+{
+	// A window without an OS window or surface. Frames go through the regular swapchain path but are rendered
+	// into offscreen images, so it runs on build machines through a software ICD such as lavapipe.
+	class HeadlessWindow : public Window
+	{
+	public:
+		HeadlessWindow( const WindowSpecification& specification );
+		virtual ~HeadlessWindow();
+
+		virtual void Init() override;
+		virtual void ProcessEvents() override;
+		virtual void WaitEvents( float timeout ) override;
+		virtual void Wake() override;
+
+		inline uint32_t GetWidth() const override
+		{
+			return m_Data.Width;
+		}
+		inline uint32_t GetHeight() const override
+		{
+			return m_Data.Height;
+		}
+
+		virtual std::pair<uint32_t, uint32_t> GetSize() const override
+		{
+			return { m_Data.Width, m_Data.Height };
+		}
+		virtual std::pair<float, float> GetWindowPos() const override
+		{
+			return { 0.0f, 0.0f };
+		}
+
+		virtual EventQueue& GetEventQueue() override
+		{
+			return m_Data.Events;
+		}
+		virtual void SetVSync( bool enabled ) override;
+		virtual bool IsVSync() const override;
+		virtual void SetResizable( bool resizable ) const override
+		{
+		}
+
+		virtual Ref<VulkanInstance> GetVulkanInstance() override
+		{
+			return m_VulkanInstance;
+		}
+		virtual VulkanSwapChain& GetSwapChain() override
+		{
+			return m_SwapChain;
+		}
+
+		inline void* GetNativeWindow() const override
+		{
+			return nullptr;
+		};
+
+		// Queues a WindowResizeEvent as if the window had been resized, the offscreen images follow the new size
+		void Resize( uint32_t width, uint32_t height );
+
+	private:
+		WindowSpecification m_Specification;
+
+		struct WindowData
+		{
+			std::string Title;
+			unsigned int Width, Height;
+			bool VSync;
+
+			EventQueue Events;
+		};
+
+		WindowData m_Data;
+
+		Ref<VulkanInstance> m_VulkanInstance;
+		VulkanSwapChain m_SwapChain;
+
+		std::mutex m_WakeMutex;
+		std::condition_variable m_WakeCondition;
+		bool m_WakeRequested = false;
+	};
+}
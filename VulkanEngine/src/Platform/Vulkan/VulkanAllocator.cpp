@@ -0,0 +1,424 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanAllocator.h"
+
+#include "Platform/Vulkan/VulkanDevice.h"
+
+namespace VE
+{
+
+	static constexpr VkDeviceSize s_MinAllocationSize = 256;
+	static constexpr VkDeviceSize s_LargeHeapBlockSize = 64ull * 1024 * 1024;
+	static constexpr VkDeviceSize s_SmallHeapMaxSize = 1024ull * 1024 * 1024;
+
+	struct VulkanMemoryBlock
+	{
+		VkDeviceMemory Memory = nullptr;
+		void* MappedData = nullptr;
+		uint32_t PoolIndex = 0;
+		VulkanMemoryBlockMetadata Metadata;
+
+		VulkanMemoryBlock( VkDeviceSize size )
+			: Metadata( size, s_MinAllocationSize )
+		{
+		}
+	};
+
+	class VulkanLogicalDeviceMemory : public VulkanDeviceMemory
+	{
+	public:
+		VulkanLogicalDeviceMemory( VkDevice device )
+			: m_Device( device )
+		{
+		}
+
+		virtual VkResult Allocate( const VkMemoryAllocateInfo& allocateInfo, VkDeviceMemory& outMemory ) override
+		{
+			return vkAllocateMemory( m_Device, &allocateInfo, nullptr, &outMemory );
+		}
+
+		virtual void Free( VkDeviceMemory memory ) override
+		{
+			vkFreeMemory( m_Device, memory, nullptr );
+		}
+
+		virtual VkResult Map( VkDeviceMemory memory, void*& outData ) override
+		{
+			return vkMapMemory( m_Device, memory, 0, VK_WHOLE_SIZE, 0, &outData );
+		}
+
+		virtual void Unmap( VkDeviceMemory memory ) override
+		{
+			vkUnmapMemory( m_Device, memory );
+		}
+
+	private:
+		VkDevice m_Device;
+	};
+
+	static uint32_t CountBits( uint32_t value )
+	{
+		uint32_t count = 0;
+		for ( ; value; value &= value - 1 )
+			count++;
+		return count;
+	}
+
+	VulkanAllocator::VulkanAllocator( VulkanLogicalDevice* device )
+		: m_Device( device ), m_Memory( CreateScope<VulkanLogicalDeviceMemory>( device->GetVulkanLogicalDevice() ) )
+	{
+		VkPhysicalDevice physicalDevice = m_Device->GetPhysicalDevice()->GetVulkanPhysicalDevice();
+		vkGetPhysicalDeviceMemoryProperties( physicalDevice, &m_MemoryProperties );
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties( physicalDevice, &properties );
+		m_MaxAllocationCount = properties.limits.maxMemoryAllocationCount;
+
+		m_DedicatedAllocationCount.resize( m_MemoryProperties.memoryTypeCount, 0 );
+		m_DedicatedAllocationBytes.resize( m_MemoryProperties.memoryTypeCount, 0 );
+	}
+
+	VulkanAllocator::VulkanAllocator( Scope<VulkanDeviceMemory> memory, const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t maxAllocationCount )
+		: m_Memory( std::move( memory ) ), m_MemoryProperties( memoryProperties ), m_MaxAllocationCount( maxAllocationCount )
+	{
+		m_DedicatedAllocationCount.resize( m_MemoryProperties.memoryTypeCount, 0 );
+		m_DedicatedAllocationBytes.resize( m_MemoryProperties.memoryTypeCount, 0 );
+	}
+
+	VulkanAllocator::~VulkanAllocator()
+	{
+		for ( auto& pool : m_Pools )
+		{
+			for ( auto& block : pool.Blocks )
+			{
+				VE_ASSERT( block->Metadata.IsEmpty(), "Device memory block destroyed with live allocations!" );
+				FreeDeviceMemory( block->Memory, block->MappedData != nullptr );
+			}
+		}
+	}
+
+	VulkanAllocation* VulkanAllocator::AllocateBuffer( const VkBufferCreateInfo& bufferCreateInfo, VulkanMemoryUsage usage, VkBuffer& outBuffer )
+	{
+		VkDevice device = m_Device->GetVulkanLogicalDevice();
+		VK_CHECK_RESULT( vkCreateBuffer( device, &bufferCreateInfo, nullptr, &outBuffer ) );
+
+		VkBufferMemoryRequirementsInfo2 requirementsInfo{};
+		requirementsInfo.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+		requirementsInfo.buffer = outBuffer;
+
+		VkMemoryDedicatedRequirements dedicatedRequirements{};
+		dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+
+		VkMemoryRequirements2 requirements{};
+		requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+		requirements.pNext = &dedicatedRequirements;
+		vkGetBufferMemoryRequirements2( device, &requirementsInfo, &requirements );
+
+		bool dedicated = dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation;
+		VulkanAllocation* allocation = Allocate( requirements.memoryRequirements, usage, true, dedicated, outBuffer, nullptr );
+		VK_CHECK_RESULT( vkBindBufferMemory( device, outBuffer, allocation->Memory, allocation->Offset ) );
+		return allocation;
+	}
+
+	VulkanAllocation* VulkanAllocator::AllocateImage( const VkImageCreateInfo& imageCreateInfo, VulkanMemoryUsage usage, VkImage& outImage )
+	{
+		VkDevice device = m_Device->GetVulkanLogicalDevice();
+		VK_CHECK_RESULT( vkCreateImage( device, &imageCreateInfo, nullptr, &outImage ) );
+
+		VkImageMemoryRequirementsInfo2 requirementsInfo{};
+		requirementsInfo.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+		requirementsInfo.image = outImage;
+
+		VkMemoryDedicatedRequirements dedicatedRequirements{};
+		dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+
+		VkMemoryRequirements2 requirements{};
+		requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+		requirements.pNext = &dedicatedRequirements;
+		vkGetImageMemoryRequirements2( device, &requirementsInfo, &requirements );
+
+		// Render targets and other large images are usually better off in their own allocation
+		bool dedicated = dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation;
+		bool linear = imageCreateInfo.tiling == VK_IMAGE_TILING_LINEAR;
+		VulkanAllocation* allocation = Allocate( requirements.memoryRequirements, usage, linear, dedicated, nullptr, outImage );
+		VK_CHECK_RESULT( vkBindImageMemory( device, outImage, allocation->Memory, allocation->Offset ) );
+		return allocation;
+	}
+
+	VulkanAllocation* VulkanAllocator::AllocateMemory( const VkMemoryRequirements& requirements, VulkanMemoryUsage usage, bool linear, bool dedicated )
+	{
+		return Allocate( requirements, usage, linear, dedicated, nullptr, nullptr );
+	}
+
+	VulkanAllocation* VulkanAllocator::Allocate( const VkMemoryRequirements& requirements, VulkanMemoryUsage usage, bool linear, bool dedicated, VkBuffer buffer, VkImage image )
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		uint32_t memoryTypeIndex = FindMemoryType( requirements.memoryTypeBits, usage );
+
+		MemoryPool& pool = GetPool( memoryTypeIndex, linear );
+		if ( dedicated || requirements.size > pool.BlockSize / 2 )
+			return AllocateDedicated( requirements.size, memoryTypeIndex, buffer, image );
+
+		uint64_t offset = 0;
+		VulkanMemoryBlock* block = nullptr;
+		for ( auto& candidate : pool.Blocks )
+		{
+			if ( candidate->Metadata.Allocate( requirements.size, requirements.alignment, offset ) )
+			{
+				block = candidate.get();
+				break;
+			}
+		}
+
+		if ( !block )
+		{
+			auto newBlock = CreateScope<VulkanMemoryBlock>( pool.BlockSize );
+			newBlock->PoolIndex = ( uint32_t )( &pool - m_Pools.data() );
+			newBlock->Memory = AllocateDeviceMemory( pool.BlockSize, memoryTypeIndex, &newBlock->MappedData );
+
+			bool success = newBlock->Metadata.Allocate( requirements.size, requirements.alignment, offset );
+			VE_ASSERT( success );
+
+			block = newBlock.get();
+			pool.Blocks.push_back( std::move( newBlock ) );
+		}
+
+		VulkanAllocation* allocation = new VulkanAllocation();
+		allocation->Memory = block->Memory;
+		allocation->Offset = offset;
+		allocation->Size = requirements.size;
+		allocation->MappedData = block->MappedData ? ( uint8_t* )block->MappedData + offset : nullptr;
+		allocation->MemoryTypeIndex = memoryTypeIndex;
+		allocation->Block = block;
+		return allocation;
+	}
+
+	void VulkanAllocator::Free( VulkanAllocation* allocation )
+	{
+		if ( !allocation )
+			return;
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		if ( VulkanMemoryBlock* block = allocation->Block )
+		{
+			block->Metadata.Free( allocation->Offset );
+
+			// Keep one empty block per pool around so a pool that drains and refills does not thrash
+			MemoryPool& pool = m_Pools[ block->PoolIndex ];
+			if ( block->Metadata.IsEmpty() && pool.Blocks.size() > 1 )
+			{
+				auto it = std::find_if( pool.Blocks.begin(), pool.Blocks.end(), [block]( const Scope<VulkanMemoryBlock>& b ) { return b.get() == block; } );
+				FreeDeviceMemory( block->Memory, block->MappedData != nullptr );
+				pool.Blocks.erase( it );
+			}
+		}
+		else
+		{
+			m_DedicatedAllocationCount[ allocation->MemoryTypeIndex ]--;
+			m_DedicatedAllocationBytes[ allocation->MemoryTypeIndex ] -= allocation->Size;
+			FreeDeviceMemory( allocation->Memory, allocation->MappedData != nullptr );
+		}
+
+		delete allocation;
+	}
+
+	void VulkanAllocator::DestroyBuffer( VkBuffer buffer, VulkanAllocation* allocation )
+	{
+		vkDestroyBuffer( m_Device->GetVulkanLogicalDevice(), buffer, nullptr );
+		Free( allocation );
+	}
+
+	void VulkanAllocator::DestroyImage( VkImage image, VulkanAllocation* allocation )
+	{
+		vkDestroyImage( m_Device->GetVulkanLogicalDevice(), image, nullptr );
+		Free( allocation );
+	}
+
+	std::vector<VulkanAllocator::HeapStatistics> VulkanAllocator::GetHeapStatistics()
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		std::vector<HeapStatistics> heaps( m_MemoryProperties.memoryHeapCount );
+		std::vector<VkDeviceSize> freeBytes( m_MemoryProperties.memoryHeapCount, 0 );
+		for ( uint32_t i = 0; i < m_MemoryProperties.memoryHeapCount; i++ )
+		{
+			heaps[ i ].HeapIndex = i;
+			heaps[ i ].HeapSize = m_MemoryProperties.memoryHeaps[ i ].size;
+		}
+
+		for ( auto& pool : m_Pools )
+		{
+			HeapStatistics& heap = heaps[ m_MemoryProperties.memoryTypes[ pool.MemoryTypeIndex ].heapIndex ];
+			for ( auto& block : pool.Blocks )
+			{
+				const auto& metadata = block->Metadata;
+				heap.BlockCount++;
+				heap.AllocationCount += metadata.GetAllocationCount();
+				heap.ReservedBytes += metadata.GetSize();
+				heap.UsedBytes += metadata.GetUsedSize();
+				heap.LargestFreeRange = std::max( heap.LargestFreeRange, metadata.GetLargestFreeRange() );
+				freeBytes[ heap.HeapIndex ] += metadata.GetFreeSize();
+			}
+		}
+
+		for ( uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; i++ )
+		{
+			HeapStatistics& heap = heaps[ m_MemoryProperties.memoryTypes[ i ].heapIndex ];
+			heap.AllocationCount += m_DedicatedAllocationCount[ i ];
+			heap.DedicatedAllocationCount += m_DedicatedAllocationCount[ i ];
+			heap.ReservedBytes += m_DedicatedAllocationBytes[ i ];
+			heap.UsedBytes += m_DedicatedAllocationBytes[ i ];
+		}
+
+		for ( auto& heap : heaps )
+		{
+			VkDeviceSize heapFreeBytes = freeBytes[ heap.HeapIndex ];
+			heap.Fragmentation = heapFreeBytes > 0 ? 1.0f - ( float )heap.LargestFreeRange / ( float )heapFreeBytes : 0.0f;
+		}
+
+		return heaps;
+	}
+
+	uint32_t VulkanAllocator::GetDeviceAllocationCount()
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		return m_DeviceAllocationCount;
+	}
+
+	void VulkanAllocator::DumpStatistics()
+	{
+		const auto heaps = GetHeapStatistics();
+
+		VE_INFO( "VulkanAllocator: {0} device allocations (limit {1})", GetDeviceAllocationCount(), m_MaxAllocationCount );
+		for ( const auto& heap : heaps )
+		{
+			if ( heap.ReservedBytes == 0 )
+				continue;
+
+			VE_INFO( "  Heap {0}: {1} blocks, {2} allocations ({3} dedicated), {4:.2f} / {5:.2f} MB used of {6:.2f} MB, fragmentation {7:.1f}%",
+				heap.HeapIndex, heap.BlockCount, heap.AllocationCount, heap.DedicatedAllocationCount,
+				heap.UsedBytes / ( 1024.0f * 1024.0f ), heap.ReservedBytes / ( 1024.0f * 1024.0f ), heap.HeapSize / ( 1024.0f * 1024.0f ),
+				heap.Fragmentation * 100.0f );
+		}
+	}
+
+	uint32_t VulkanAllocator::FindMemoryType( uint32_t memoryTypeBits, VulkanMemoryUsage usage ) const
+	{
+		VkMemoryPropertyFlags requiredFlags = 0;
+		VkMemoryPropertyFlags preferredFlags = 0;
+		switch ( usage )
+		{
+			case VulkanMemoryUsage::GPUOnly:
+				preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+				break;
+			case VulkanMemoryUsage::CPUToGPU:
+				requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+				break;
+			case VulkanMemoryUsage::GPUToCPU:
+				requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+				preferredFlags = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+				break;
+		}
+
+		uint32_t bestIndex = UINT32_MAX;
+		uint32_t bestCost = UINT32_MAX;
+		for ( uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; i++ )
+		{
+			if ( ( memoryTypeBits & ( 1u << i ) ) == 0 )
+				continue;
+
+			VkMemoryPropertyFlags flags = m_MemoryProperties.memoryTypes[ i ].propertyFlags;
+			if ( ( flags & requiredFlags ) != requiredFlags )
+				continue;
+
+			uint32_t cost = CountBits( preferredFlags & ~flags );
+			if ( cost < bestCost )
+			{
+				bestIndex = i;
+				bestCost = cost;
+			}
+		}
+
+		VE_ASSERT( bestIndex != UINT32_MAX, "Failed to find a suitable memory type!" );
+		return bestIndex;
+	}
+
+	VkDeviceMemory VulkanAllocator::AllocateDeviceMemory( VkDeviceSize size, uint32_t memoryTypeIndex, void** outMappedData, const void* pNext )
+	{
+		if ( m_DeviceAllocationCount + 1 > m_MaxAllocationCount )
+			VE_WARN( "VulkanAllocator: exceeding maxMemoryAllocationCount ({0})", m_MaxAllocationCount );
+
+		VkMemoryAllocateInfo allocateInfo{};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocateInfo.pNext = pNext;
+		allocateInfo.allocationSize = size;
+		allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+		VkDeviceMemory memory;
+		VK_CHECK_RESULT( m_Memory->Allocate( allocateInfo, memory ) );
+		m_DeviceAllocationCount++;
+
+		*outMappedData = nullptr;
+		if ( m_MemoryProperties.memoryTypes[ memoryTypeIndex ].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT )
+			VK_CHECK_RESULT( m_Memory->Map( memory, *outMappedData ) );
+
+		return memory;
+	}
+
+	void VulkanAllocator::FreeDeviceMemory( VkDeviceMemory memory, bool mapped )
+	{
+		if ( mapped )
+			m_Memory->Unmap( memory );
+
+		m_Memory->Free( memory );
+		m_DeviceAllocationCount--;
+	}
+
+	VulkanAllocation* VulkanAllocator::AllocateDedicated( VkDeviceSize size, uint32_t memoryTypeIndex, VkBuffer buffer, VkImage image )
+	{
+		VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+		dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+		dedicatedInfo.buffer = buffer;
+		dedicatedInfo.image = image;
+		const bool hasResource = buffer || image;
+
+		VulkanAllocation* allocation = new VulkanAllocation();
+		allocation->Memory = AllocateDeviceMemory( size, memoryTypeIndex, &allocation->MappedData, hasResource ? &dedicatedInfo : nullptr );
+		allocation->Offset = 0;
+		allocation->Size = size;
+		allocation->MemoryTypeIndex = memoryTypeIndex;
+
+		m_DedicatedAllocationCount[ memoryTypeIndex ]++;
+		m_DedicatedAllocationBytes[ memoryTypeIndex ] += size;
+		return allocation;
+	}
+
+	VulkanAllocator::MemoryPool& VulkanAllocator::GetPool( uint32_t memoryTypeIndex, bool linear )
+	{
+		for ( auto& pool : m_Pools )
+		{
+			if ( pool.MemoryTypeIndex == memoryTypeIndex && pool.Linear == linear )
+				return pool;
+		}
+
+		// Buffers and optimal images live in separate pools so bufferImageGranularity never applies
+		MemoryPool pool;
+		pool.MemoryTypeIndex = memoryTypeIndex;
+		pool.Linear = linear;
+
+		VkDeviceSize heapSize = m_MemoryProperties.memoryHeaps[ m_MemoryProperties.memoryTypes[ memoryTypeIndex ].heapIndex ].size;
+		pool.BlockSize = s_LargeHeapBlockSize;
+		if ( heapSize <= s_SmallHeapMaxSize )
+		{
+			// Power of two no larger than an eighth of the heap
+			pool.BlockSize = 1024 * 1024;
+			while ( pool.BlockSize * 2 <= heapSize / 8 )
+				pool.BlockSize *= 2;
+		}
+
+		m_Pools.push_back( std::move( pool ) );
+		return m_Pools.back();
+	}
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+#include "Platform/Vulkan/VulkanMemoryBlockMetadata.h"
+
+#include <mutex>
+
+namespace VE
+{
+	class VulkanLogicalDevice;
+
+	enum class VulkanMemoryUsage
+	{
+		// Device local, not mappable
+		GPUOnly = 0,
+		// Host visible and coherent, written by the CPU and read by the GPU (staging, uniforms)
+		CPUToGPU,
+		// Host visible and preferably cached, written by the GPU and read back by the CPU
+		GPUToCPU
+	};
+
+	struct VulkanMemoryBlock;
+
+	// The device memory calls the allocator makes, so its bookkeeping can also run against a fake device
+	class VulkanDeviceMemory
+	{
+	public:
+		virtual ~VulkanDeviceMemory() = default;
+
+		virtual VkResult Allocate( const VkMemoryAllocateInfo& allocateInfo, VkDeviceMemory& outMemory ) = 0;
+		virtual void Free( VkDeviceMemory memory ) = 0;
+		// Maps the whole allocation
+		virtual VkResult Map( VkDeviceMemory memory, void*& outData ) = 0;
+		virtual void Unmap( VkDeviceMemory memory ) = 0;
+	};
+
+	struct VulkanAllocation
+	{
+		VkDeviceMemory Memory = nullptr;
+		VkDeviceSize Offset = 0;
+		VkDeviceSize Size = 0;
+		// Host visible memory stays mapped for its whole lifetime
+		void* MappedData = nullptr;
+		uint32_t MemoryTypeIndex = 0;
+
+		// Null for dedicated allocations
+		VulkanMemoryBlock* Block = nullptr;
+	};
+
+	// Sub-allocates buffers and images from large blocks per memory type instead of calling vkAllocateMemory
+	// per resource. Resources that are large or that the driver wants in their own allocation get a
+	// dedicated VkDeviceMemory.
+	class VulkanAllocator
+	{
+	public:
+		struct HeapStatistics
+		{
+			uint32_t HeapIndex = 0;
+			VkDeviceSize HeapSize = 0;
+			uint32_t BlockCount = 0;
+			uint32_t AllocationCount = 0;
+			uint32_t DedicatedAllocationCount = 0;
+			// Bytes obtained from the device, in blocks and dedicated allocations
+			VkDeviceSize ReservedBytes = 0;
+			// Bytes handed out to resources
+			VkDeviceSize UsedBytes = 0;
+			VkDeviceSize LargestFreeRange = 0;
+			// 0 when all free block memory is one contiguous range, approaching 1 as it gets scattered
+			float Fragmentation = 0.0f;
+		};
+
+	public:
+		VulkanAllocator( VulkanLogicalDevice* device );
+		// Without a device, only AllocateMemory and Free can be used
+		VulkanAllocator( Scope<VulkanDeviceMemory> memory, const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t maxAllocationCount );
+		~VulkanAllocator();
+
+		VulkanAllocation* AllocateBuffer( const VkBufferCreateInfo& bufferCreateInfo, VulkanMemoryUsage usage, VkBuffer& outBuffer );
+		VulkanAllocation* AllocateImage( const VkImageCreateInfo& imageCreateInfo, VulkanMemoryUsage usage, VkImage& outImage );
+		// linear must be false for memory that will be bound to an optimal tiling image
+		VulkanAllocation* AllocateMemory( const VkMemoryRequirements& requirements, VulkanMemoryUsage usage, bool linear, bool dedicated = false );
+		void Free( VulkanAllocation* allocation );
+
+		void DestroyBuffer( VkBuffer buffer, VulkanAllocation* allocation );
+		void DestroyImage( VkImage image, VulkanAllocation* allocation );
+
+		template<typename T>
+		T* MapMemory( VulkanAllocation* allocation )
+		{
+			VE_ASSERT( allocation->MappedData, "Allocation is not host visible!" );
+			return ( T* )allocation->MappedData;
+		}
+
+		std::vector<HeapStatistics> GetHeapStatistics();
+		// VkDeviceMemory objects currently allocated, counted against maxMemoryAllocationCount
+		uint32_t GetDeviceAllocationCount();
+		void DumpStatistics();
+
+	private:
+		struct MemoryPool
+		{
+			uint32_t MemoryTypeIndex = 0;
+			bool Linear = true;
+			VkDeviceSize BlockSize = 0;
+			std::vector<Scope<VulkanMemoryBlock>> Blocks;
+		};
+
+		VulkanAllocation* Allocate( const VkMemoryRequirements& requirements, VulkanMemoryUsage usage, bool linear, bool dedicated, VkBuffer buffer, VkImage image );
+		uint32_t FindMemoryType( uint32_t memoryTypeBits, VulkanMemoryUsage usage ) const;
+		VkDeviceMemory AllocateDeviceMemory( VkDeviceSize size, uint32_t memoryTypeIndex, void** outMappedData, const void* pNext = nullptr );
+		void FreeDeviceMemory( VkDeviceMemory memory, bool mapped );
+
+		VulkanAllocation* AllocateDedicated( VkDeviceSize size, uint32_t memoryTypeIndex, VkBuffer buffer, VkImage image );
+		MemoryPool& GetPool( uint32_t memoryTypeIndex, bool linear );
+
+	private:
+		VulkanLogicalDevice* m_Device = nullptr;
+		Scope<VulkanDeviceMemory> m_Memory;
+		VkPhysicalDeviceMemoryProperties m_MemoryProperties;
+		uint32_t m_MaxAllocationCount = 0;
+		uint32_t m_DeviceAllocationCount = 0;
+
+		std::vector<MemoryPool> m_Pools;
+		std::vector<uint32_t> m_DedicatedAllocationCount;
+		std::vector<VkDeviceSize> m_DedicatedAllocationBytes;
+
+		std::mutex m_Mutex;
+	};
+}
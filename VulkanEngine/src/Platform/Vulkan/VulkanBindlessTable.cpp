@@ -0,0 +1,241 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanBindlessTable.h"
+
+#include "Platform/Vulkan/VulkanDevice.h"
+
+#include "Renderer/Renderer.h"
+
+namespace VE
+{
+
+	static constexpr VkDescriptorType s_DescriptorTypes[] =
+	{
+		VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+		VK_DESCRIPTOR_TYPE_SAMPLER,
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+	};
+
+	// Upper bounds, the device limits may lower them
+	static constexpr uint32_t s_MaxCapacities[] = { 16384, 256, 16384, 4096 };
+
+	bool VulkanBindlessTable::EnableFeatures( const VkPhysicalDeviceVulkan12Features& supported, VkPhysicalDeviceVulkan12Features& features )
+	{
+		bool isSupported = supported.descriptorIndexing
+			&& supported.runtimeDescriptorArray
+			&& supported.descriptorBindingPartiallyBound
+			&& supported.descriptorBindingUpdateUnusedWhilePending
+			&& supported.descriptorBindingSampledImageUpdateAfterBind
+			&& supported.descriptorBindingStorageImageUpdateAfterBind
+			&& supported.descriptorBindingStorageBufferUpdateAfterBind
+			&& supported.shaderSampledImageArrayNonUniformIndexing
+			&& supported.shaderStorageImageArrayNonUniformIndexing
+			&& supported.shaderStorageBufferArrayNonUniformIndexing;
+		if ( !isSupported )
+			return false;
+
+		features.descriptorIndexing = VK_TRUE;
+		features.runtimeDescriptorArray = VK_TRUE;
+		features.descriptorBindingPartiallyBound = VK_TRUE;
+		features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		features.descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
+		features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+		features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		features.shaderStorageImageArrayNonUniformIndexing = VK_TRUE;
+		features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+		return true;
+	}
+
+	VulkanBindlessTable::VulkanBindlessTable( VulkanLogicalDevice* device )
+		: m_Device( device )
+	{
+		VkDevice logicalDevice = m_Device->GetVulkanLogicalDevice();
+
+		VkPhysicalDeviceVulkan12Properties properties12{};
+		properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &properties12;
+		vkGetPhysicalDeviceProperties2( m_Device->GetPhysicalDevice()->GetVulkanPhysicalDevice(), &properties2 );
+
+		const uint32_t limits[] =
+		{
+			std::min( properties12.maxDescriptorSetUpdateAfterBindSampledImages, properties12.maxPerStageDescriptorUpdateAfterBindSampledImages ),
+			std::min( properties12.maxDescriptorSetUpdateAfterBindSamplers, properties12.maxPerStageDescriptorUpdateAfterBindSamplers ),
+			std::min( properties12.maxDescriptorSetUpdateAfterBindStorageBuffers, properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers ),
+			std::min( properties12.maxDescriptorSetUpdateAfterBindStorageImages, properties12.maxPerStageDescriptorUpdateAfterBindStorageImages ),
+		};
+
+		std::array<VkDescriptorSetLayoutBinding, ( size_t )BindlessResourceType::Count> bindings{};
+		std::array<VkDescriptorBindingFlags, ( size_t )BindlessResourceType::Count> bindingFlags{};
+		std::array<VkDescriptorPoolSize, ( size_t )BindlessResourceType::Count> poolSizes{};
+		for ( uint32_t i = 0; i < ( uint32_t )BindlessResourceType::Count; i++ )
+		{
+			m_Slots[ i ].Capacity = std::min( s_MaxCapacities[ i ], limits[ i ] );
+
+			bindings[ i ].binding = i;
+			bindings[ i ].descriptorType = s_DescriptorTypes[ i ];
+			bindings[ i ].descriptorCount = m_Slots[ i ].Capacity;
+			bindings[ i ].stageFlags = VK_SHADER_STAGE_ALL;
+
+			// Unused slots may hold stale descriptors, and slots can be filled while the set is in use
+			bindingFlags[ i ] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+			poolSizes[ i ].type = s_DescriptorTypes[ i ];
+			poolSizes[ i ].descriptorCount = m_Slots[ i ].Capacity;
+		}
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+		bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		bindingFlagsInfo.bindingCount = ( uint32_t )bindingFlags.size();
+		bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.pNext = &bindingFlagsInfo;
+		layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		layoutInfo.bindingCount = ( uint32_t )bindings.size();
+		layoutInfo.pBindings = bindings.data();
+		VK_CHECK_RESULT( vkCreateDescriptorSetLayout( logicalDevice, &layoutInfo, nullptr, &m_SetLayout ) );
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_ALL;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = PushConstantSize;
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &m_SetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		VK_CHECK_RESULT( vkCreatePipelineLayout( logicalDevice, &pipelineLayoutInfo, nullptr, &m_PipelineLayout ) );
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		poolInfo.maxSets = 1;
+		poolInfo.poolSizeCount = ( uint32_t )poolSizes.size();
+		poolInfo.pPoolSizes = poolSizes.data();
+		VK_CHECK_RESULT( vkCreateDescriptorPool( logicalDevice, &poolInfo, nullptr, &m_Pool ) );
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_Pool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_SetLayout;
+		VK_CHECK_RESULT( vkAllocateDescriptorSets( logicalDevice, &allocInfo, &m_Set ) );
+
+		VE_TRACE( "bindless table: {0} textures, {1} samplers, {2} storage buffers, {3} storage images", m_Slots[ 0 ].Capacity, m_Slots[ 1 ].Capacity, m_Slots[ 2 ].Capacity, m_Slots[ 3 ].Capacity );
+	}
+
+	VulkanBindlessTable::~VulkanBindlessTable()
+	{
+		VkDevice logicalDevice = m_Device->GetVulkanLogicalDevice();
+
+		vkDestroyDescriptorPool( logicalDevice, m_Pool, nullptr );
+		vkDestroyPipelineLayout( logicalDevice, m_PipelineLayout, nullptr );
+		vkDestroyDescriptorSetLayout( logicalDevice, m_SetLayout, nullptr );
+	}
+
+	BindlessHandle VulkanBindlessTable::RegisterTexture( VkImageView imageView, VkImageLayout layout )
+	{
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageView = imageView;
+		imageInfo.imageLayout = layout;
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		BindlessHandle handle = Allocate( BindlessResourceType::Texture );
+		Write( BindlessResourceType::Texture, handle, &imageInfo, nullptr );
+		return handle;
+	}
+
+	BindlessHandle VulkanBindlessTable::RegisterSampler( VkSampler sampler )
+	{
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.sampler = sampler;
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		BindlessHandle handle = Allocate( BindlessResourceType::Sampler );
+		Write( BindlessResourceType::Sampler, handle, &imageInfo, nullptr );
+		return handle;
+	}
+
+	BindlessHandle VulkanBindlessTable::RegisterStorageBuffer( VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range )
+	{
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = buffer;
+		bufferInfo.offset = offset;
+		bufferInfo.range = range;
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		BindlessHandle handle = Allocate( BindlessResourceType::StorageBuffer );
+		Write( BindlessResourceType::StorageBuffer, handle, nullptr, &bufferInfo );
+		return handle;
+	}
+
+	BindlessHandle VulkanBindlessTable::RegisterStorageImage( VkImageView imageView )
+	{
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageView = imageView;
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		BindlessHandle handle = Allocate( BindlessResourceType::StorageImage );
+		Write( BindlessResourceType::StorageImage, handle, &imageInfo, nullptr );
+		return handle;
+	}
+
+	void VulkanBindlessTable::Release( BindlessResourceType type, BindlessHandle handle )
+	{
+		if ( !handle.IsValid() )
+			return;
+
+		Renderer::SubmitResourceFree( [this, type, handle]()
+			{
+				std::lock_guard<std::mutex> lock( m_Mutex );
+				m_Slots[ ( uint32_t )type ].FreeIndices.push_back( handle.Index );
+			} );
+	}
+
+	void VulkanBindlessTable::Bind( VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint ) const
+	{
+		vkCmdBindDescriptorSets( commandBuffer, bindPoint, m_PipelineLayout, 0, 1, &m_Set, 0, nullptr );
+	}
+
+	BindlessHandle VulkanBindlessTable::Allocate( BindlessResourceType type )
+	{
+		Slots& slots = m_Slots[ ( uint32_t )type ];
+
+		BindlessHandle handle;
+		if ( !slots.FreeIndices.empty() )
+		{
+			handle.Index = slots.FreeIndices.back();
+			slots.FreeIndices.pop_back();
+		}
+		else
+		{
+			VE_ASSERT( slots.Next < slots.Capacity, "Bindless table is full!" );
+			handle.Index = slots.Next++;
+		}
+		return handle;
+	}
+
+	void VulkanBindlessTable::Write( BindlessResourceType type, BindlessHandle handle, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo )
+	{
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_Set;
+		write.dstBinding = ( uint32_t )type;
+		write.dstArrayElement = handle.Index;
+		write.descriptorCount = 1;
+		write.descriptorType = s_DescriptorTypes[ ( uint32_t )type ];
+		write.pImageInfo = imageInfo;
+		write.pBufferInfo = bufferInfo;
+
+		// Called with m_Mutex held, updates of the one set must be externally synchronized
+		vkUpdateDescriptorSets( m_Device->GetVulkanLogicalDevice(), 1, &write, 0, nullptr );
+	}
+
+}
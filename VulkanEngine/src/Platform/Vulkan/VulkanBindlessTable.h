@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+
+#include <mutex>
+
+namespace VE
+{
+	class VulkanLogicalDevice;
+
+	enum class BindlessResourceType : uint32_t
+	{
+		Texture = 0, Sampler, StorageBuffer, StorageImage, Count
+	};
+
+	// Index of a resource in the global table. Handles stay valid until released, so materials can store them
+	// and pass them to shaders, which index the matching array declared as
+	//   layout( set = 0, binding = 0 ) uniform texture2D u_Textures[];
+	//   layout( set = 0, binding = 1 ) uniform sampler u_Samplers[];
+	//   layout( set = 0, binding = 2 ) buffer StorageBuffer { ... } u_Buffers[];
+	//   layout( set = 0, binding = 3, ... ) uniform image2D u_Images[];
+	struct BindlessHandle
+	{
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+		uint32_t Index = InvalidIndex;
+
+		bool IsValid() const
+		{
+			return Index != InvalidIndex;
+		}
+	};
+
+	// One update-after-bind descriptor set holding every texture, sampler, storage buffer and storage image,
+	// bound once per command buffer together with a push constant range for per-draw indices. Only created
+	// when RendererConfig::Bindless is set and the device supports descriptor indexing.
+	class VulkanBindlessTable
+	{
+	public:
+		static constexpr uint32_t PushConstantSize = 128;
+
+		VulkanBindlessTable( VulkanLogicalDevice* device );
+		~VulkanBindlessTable();
+
+		// Enables the descriptor indexing features bindless needs in features, if supported
+		static bool EnableFeatures( const VkPhysicalDeviceVulkan12Features& supported, VkPhysicalDeviceVulkan12Features& features );
+
+		BindlessHandle RegisterTexture( VkImageView imageView, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL );
+		BindlessHandle RegisterSampler( VkSampler sampler );
+		BindlessHandle RegisterStorageBuffer( VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE );
+		BindlessHandle RegisterStorageImage( VkImageView imageView );
+
+		// The index is reused once every frame that may still reference it has completed
+		void Release( BindlessResourceType type, BindlessHandle handle );
+
+		void Bind( VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint ) const;
+
+		VkDescriptorSetLayout GetDescriptorSetLayout() const
+		{
+			return m_SetLayout;
+		}
+		// Layout every bindless pipeline is created with: the global set and PushConstantSize bytes of push constants
+		VkPipelineLayout GetPipelineLayout() const
+		{
+			return m_PipelineLayout;
+		}
+
+		uint32_t GetCapacity( BindlessResourceType type ) const
+		{
+			return m_Slots[ ( uint32_t )type ].Capacity;
+		}
+
+	private:
+		struct Slots
+		{
+			uint32_t Capacity = 0;
+			uint32_t Next = 0;
+			std::vector<uint32_t> FreeIndices;
+		};
+
+		BindlessHandle Allocate( BindlessResourceType type );
+		void Write( BindlessResourceType type, BindlessHandle handle, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo );
+
+	private:
+		VulkanLogicalDevice* m_Device;
+
+		VkDescriptorSetLayout m_SetLayout = nullptr;
+		VkPipelineLayout m_PipelineLayout = nullptr;
+		VkDescriptorPool m_Pool = nullptr;
+		VkDescriptorSet m_Set = nullptr;
+
+		std::array<Slots, ( size_t )BindlessResourceType::Count> m_Slots;
+
+		std::mutex m_Mutex;
+	};
+}
@@ -0,0 +1,123 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanCommandRecorder.h"
+
+#include "Platform/Vulkan/VulkanDevice.h"
+
+#include "Core/JobSystem.h"
+#include "Core/Timer.h"
+
+namespace VE
+{
+
+	VulkanCommandRecorder::VulkanCommandRecorder( VulkanLogicalDevice* device, uint32_t framesInFlight )
+		: m_Device( device )
+	{
+		uint32_t contextCount = JobSystem::GetWorkerCount() + 1;
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.queueFamilyIndex = m_Device->GetPhysicalDevice()->GetQueueFamilyIndices().Graphics;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+		m_Contexts.resize( framesInFlight );
+		for ( auto& contexts : m_Contexts )
+		{
+			contexts.resize( contextCount );
+			for ( auto& context : contexts )
+			{
+				VK_CHECK_RESULT( vkCreateCommandPool( m_Device->GetVulkanLogicalDevice(), &poolInfo, nullptr, &context.Pool ) );
+			}
+		}
+	}
+
+	VulkanCommandRecorder::~VulkanCommandRecorder()
+	{
+		// Destroying a pool frees its command buffers
+		for ( auto& contexts : m_Contexts )
+		{
+			for ( auto& context : contexts )
+			{
+				vkDestroyCommandPool( m_Device->GetVulkanLogicalDevice(), context.Pool, nullptr );
+			}
+		}
+	}
+
+	void VulkanCommandRecorder::BeginFrame( uint32_t frameIndex )
+	{
+		m_FrameIndex = frameIndex;
+		m_Statistics = {};
+
+		for ( auto& context : m_Contexts[ frameIndex ] )
+		{
+			if ( context.UsedCount == 0 )
+				continue;
+
+			VK_CHECK_RESULT( vkResetCommandPool( m_Device->GetVulkanLogicalDevice(), context.Pool, 0 ) );
+			context.UsedCount = 0;
+		}
+	}
+
+	void VulkanCommandRecorder::RecordParallel( VkCommandBuffer primary, const VkCommandBufferInheritanceInfo& inheritance, uint32_t count, const RecordFunc& record )
+	{
+		if ( count == 0 )
+			return;
+
+		Timer timer;
+
+		auto& contexts = m_Contexts[ m_FrameIndex ];
+		// One secondary per thread that can take a job, so a lowered active worker count is not paid for in
+		// extra secondaries
+		uint32_t contextCount = std::min( { ( uint32_t )contexts.size(), JobSystem::GetActiveWorkerCount() + 1, count } );
+		uint32_t itemsPerContext = ( count + contextCount - 1 ) / contextCount;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		if ( inheritance.renderPass )
+			beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		beginInfo.pInheritanceInfo = &inheritance;
+
+		// Each job owns one context for its whole run, whichever thread ends up executing it
+		std::vector<VkCommandBuffer> secondaries( contextCount );
+		JobSystem::ParallelFor( contextCount, 1, [&]( uint32_t contextBegin, uint32_t contextEnd )
+			{
+				for ( uint32_t i = contextBegin; i < contextEnd; i++ )
+				{
+					VkCommandBuffer commandBuffer = GetCommandBuffer( contexts[ i ] );
+					VK_CHECK_RESULT( vkBeginCommandBuffer( commandBuffer, &beginInfo ) );
+
+					uint32_t begin = i * itemsPerContext;
+					uint32_t end = std::min( begin + itemsPerContext, count );
+					if ( begin < end )
+						record( commandBuffer, begin, end );
+
+					VK_CHECK_RESULT( vkEndCommandBuffer( commandBuffer ) );
+					secondaries[ i ] = commandBuffer;
+				}
+			} );
+
+		vkCmdExecuteCommands( primary, contextCount, secondaries.data() );
+
+		m_Statistics.SecondaryCount += contextCount;
+		m_Statistics.RecordTime += timer.ElapsedMillis();
+	}
+
+	VkCommandBuffer VulkanCommandRecorder::GetCommandBuffer( RecordingContext& context )
+	{
+		if ( context.UsedCount == context.CommandBuffers.size() )
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = context.Pool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			allocInfo.commandBufferCount = 1;
+
+			VkCommandBuffer commandBuffer;
+			VK_CHECK_RESULT( vkAllocateCommandBuffers( m_Device->GetVulkanLogicalDevice(), &allocInfo, &commandBuffer ) );
+			context.CommandBuffers.push_back( commandBuffer );
+		}
+
+		return context.CommandBuffers[ context.UsedCount++ ];
+	}
+
+}
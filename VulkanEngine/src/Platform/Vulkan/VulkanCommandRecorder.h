@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+
+#include <functional>
+
+namespace VE
+{
+	class VulkanLogicalDevice;
+
+	struct CommandRecorderStatistics
+	{
+		uint32_t SecondaryCount = 0;
+		// Wall clock time spent in RecordParallel during the frame
+		float RecordTime = 0.0f;
+	};
+
+	// Records secondary command buffers in parallel on the job system. Every recording context, one per worker
+	// plus one for the thread that waits on them, owns a command pool per frame in flight, so no pool is ever
+	// touched by two threads at once and all buffers of a frame are recycled with a single pool reset.
+	class VulkanCommandRecorder
+	{
+	public:
+		// Records the items [begin, end) into commandBuffer, which is already begun
+		using RecordFunc = std::function<void( VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end )>;
+
+		VulkanCommandRecorder( VulkanLogicalDevice* device, uint32_t framesInFlight );
+		~VulkanCommandRecorder();
+
+		// The previous work of the frame slot has completed, its command buffers can be reused
+		void BeginFrame( uint32_t frameIndex );
+
+		// Splits count items across the recording contexts and executes the resulting secondary command buffers
+		// in primary, in item order. Inside a render pass, primary must have begun it with
+		// VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS and inheritance must name the render pass and subpass.
+		void RecordParallel( VkCommandBuffer primary, const VkCommandBufferInheritanceInfo& inheritance, uint32_t count, const RecordFunc& record );
+
+		const CommandRecorderStatistics& GetStatistics() const
+		{
+			return m_Statistics;
+		}
+
+	private:
+		struct RecordingContext
+		{
+			VkCommandPool Pool = nullptr;
+			std::vector<VkCommandBuffer> CommandBuffers;
+			uint32_t UsedCount = 0;
+		};
+
+		VkCommandBuffer GetCommandBuffer( RecordingContext& context );
+
+	private:
+		VulkanLogicalDevice* m_Device;
+
+		// Indexed by frame, then by context
+		std::vector<std::vector<RecordingContext>> m_Contexts;
+		uint32_t m_FrameIndex = 0;
+
+		CommandRecorderStatistics m_Statistics;
+	};
+}
@@ -0,0 +1,171 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanComputeScheduler.h"
+
+#include "Platform/Vulkan/VulkanDevice.h"
+
+#include "Renderer/Renderer.h"
+
+namespace VE
+{
+
+	// Passes beyond this still run each frame, they are just not timed
+	static constexpr uint32_t s_MaxTimedPasses = 32;
+
+	VulkanComputeScheduler::VulkanComputeScheduler( VulkanLogicalDevice* device )
+		: m_Device( device )
+	{
+		VkDevice logicalDevice = m_Device->GetVulkanLogicalDevice();
+		const auto& physicalDevice = m_Device->GetPhysicalDevice();
+
+		uint32_t computeFamily = physicalDevice->GetQueueFamilyIndices().Compute;
+		uint32_t validBits = physicalDevice->GetQueueFamilyProperties()[ computeFamily ].timestampValidBits;
+		m_TimestampsSupported = validBits > 0;
+		m_TimestampMask = validBits >= 64 ? ~0ull : ( ( 1ull << validBits ) - 1 );
+		m_TimestampPeriod = physicalDevice->GetProperties().limits.timestampPeriod;
+
+		m_Frames.resize( Renderer::GetConfig().FramesInFlight );
+
+		std::vector<VkCommandBuffer> commandBuffers( m_Frames.size() );
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = m_Device->GetComputeCommandPool();
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = ( uint32_t )commandBuffers.size();
+		VK_CHECK_RESULT( vkAllocateCommandBuffers( logicalDevice, &allocInfo, commandBuffers.data() ) );
+
+		VkQueryPoolCreateInfo queryPoolInfo{};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolInfo.queryCount = s_MaxTimedPasses * 2;
+
+		for ( size_t i = 0; i < m_Frames.size(); i++ )
+		{
+			auto& frame = m_Frames[ i ];
+			frame.CommandBuffer = commandBuffers[ i ];
+
+			if ( m_TimestampsSupported )
+				VK_CHECK_RESULT( vkCreateQueryPool( logicalDevice, &queryPoolInfo, nullptr, &frame.QueryPool ) );
+		}
+
+		if ( !m_TimestampsSupported )
+			VE_WARN( "compute queue does not support timestamps, compute passes will not be timed" );
+	}
+
+	VulkanComputeScheduler::~VulkanComputeScheduler()
+	{
+		VkDevice logicalDevice = m_Device->GetVulkanLogicalDevice();
+
+		for ( auto& frame : m_Frames )
+		{
+			vkFreeCommandBuffers( logicalDevice, m_Device->GetComputeCommandPool(), 1, &frame.CommandBuffer );
+			if ( frame.QueryPool )
+				vkDestroyQueryPool( logicalDevice, frame.QueryPool, nullptr );
+		}
+	}
+
+	void VulkanComputeScheduler::AddPass( const std::string& name, VkPipelineStageFlags consumerStage, RecordFunc&& record )
+	{
+		m_Passes.push_back( { name, consumerStage, std::move( record ) } );
+	}
+
+	void VulkanComputeScheduler::Submit( uint32_t frameIndex, VulkanSemaphoreWaitList& waits )
+	{
+		FrameData& frame = m_Frames[ frameIndex ];
+		auto& timeline = m_Device->GetComputeTimeline();
+
+		// The graphics work of the frame that last used this slot waited on its compute work, so once that
+		// frame has completed the command buffer and queries are free again
+		if ( frame.TimelineValue )
+		{
+			VE_ASSERT( timeline.IsComplete( frame.TimelineValue ) );
+			ReadTimings( frame );
+			frame.TimelineValue = 0;
+		}
+
+		if ( m_Passes.empty() )
+			return;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VK_CHECK_RESULT( vkBeginCommandBuffer( frame.CommandBuffer, &beginInfo ) );
+
+		uint32_t timedPasses = std::min( ( uint32_t )m_Passes.size(), s_MaxTimedPasses );
+		if ( frame.QueryPool )
+			vkCmdResetQueryPool( frame.CommandBuffer, frame.QueryPool, 0, timedPasses * 2 );
+
+		VkPipelineStageFlags consumerStage = 0;
+		frame.PassNames.clear();
+		for ( uint32_t i = 0; i < m_Passes.size(); i++ )
+		{
+			auto& pass = m_Passes[ i ];
+			bool timed = frame.QueryPool && i < timedPasses;
+
+			if ( timed )
+				vkCmdWriteTimestamp( frame.CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.QueryPool, i * 2 );
+
+			pass.Record( frame.CommandBuffer );
+
+			if ( timed )
+			{
+				vkCmdWriteTimestamp( frame.CommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.QueryPool, i * 2 + 1 );
+				frame.PassNames.push_back( pass.Name );
+			}
+
+			consumerStage |= pass.ConsumerStage;
+		}
+
+		VK_CHECK_RESULT( vkEndCommandBuffer( frame.CommandBuffer ) );
+
+		frame.TimelineValue = timeline.Next();
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &frame.TimelineValue;
+
+		VkSemaphore timelineSemaphore = timeline.GetSemaphore();
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &frame.CommandBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &timelineSemaphore;
+		VK_CHECK_RESULT( vkQueueSubmit( m_Device->GetComputeQueue(), 1, &submitInfo, VK_NULL_HANDLE ) );
+
+		waits.Add( timelineSemaphore, consumerStage ? consumerStage : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.TimelineValue );
+
+		m_Passes.clear();
+	}
+
+	void VulkanComputeScheduler::ReadTimings( FrameData& frame )
+	{
+		if ( frame.PassNames.empty() )
+			return;
+
+		uint32_t queryCount = ( uint32_t )frame.PassNames.size() * 2;
+		std::vector<uint64_t> timestamps( queryCount );
+		VkResult result = vkGetQueryPoolResults( m_Device->GetVulkanLogicalDevice(), frame.QueryPool, 0, queryCount,
+			timestamps.size() * sizeof( uint64_t ), timestamps.data(), sizeof( uint64_t ), VK_QUERY_RESULT_64_BIT );
+		if ( result != VK_SUCCESS )
+			return;
+
+		uint64_t origin = timestamps[ 0 ] & m_TimestampMask;
+		auto toMillis = [&]( uint64_t timestamp )
+		{
+			return ( float )( ( double )( ( timestamp & m_TimestampMask ) - origin ) * m_TimestampPeriod / 1000000.0 );
+		};
+
+		m_PassTimings.resize( frame.PassNames.size() );
+		for ( size_t i = 0; i < frame.PassNames.size(); i++ )
+		{
+			auto& timing = m_PassTimings[ i ];
+			timing.Name = frame.PassNames[ i ];
+			timing.Begin = toMillis( timestamps[ i * 2 ] );
+			timing.End = toMillis( timestamps[ i * 2 + 1 ] );
+		}
+		m_PassTimingsOrigin = ( uint64_t )( ( double )origin * m_TimestampPeriod );
+	}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+#include "Platform/Vulkan/VulkanTimelineSemaphore.h"
+
+#include <functional>
+
+namespace VE
+{
+	class VulkanLogicalDevice;
+
+	struct ComputePassTiming
+	{
+		std::string Name;
+		// Milliseconds relative to the start of the first pass of the frame
+		float Begin = 0.0f;
+		float End = 0.0f;
+	};
+
+	// Runs compute passes on the async compute queue. Passes queued during a frame are recorded into one
+	// command buffer per frame in flight and submitted just before the frame's graphics work, which waits on
+	// the compute timeline only at the stages that consume the results, so the two queues can overlap.
+	// Resources written by a pass and read by graphics should either be created with concurrent sharing or
+	// have their ownership transferred by the pass when the compute and graphics families differ.
+	class VulkanComputeScheduler
+	{
+	public:
+		using RecordFunc = std::function<void( VkCommandBuffer )>;
+
+		VulkanComputeScheduler( VulkanLogicalDevice* device );
+		~VulkanComputeScheduler();
+
+		// Render thread: queues a pass for the current frame. consumerStage is the first graphics stage that
+		// reads what the pass writes.
+		void AddPass( const std::string& name, VkPipelineStageFlags consumerStage, RecordFunc&& record );
+
+		// Render thread: records and submits the passes queued for the frame. The frame slot must be free again,
+		// i.e. its graphics work has completed. The graphics submission must wait on what is added to waits.
+		void Submit( uint32_t frameIndex, VulkanSemaphoreWaitList& waits );
+
+		// GPU timing of the most recently completed frame that ran compute passes
+		const std::vector<ComputePassTiming>& GetPassTimings() const
+		{
+			return m_PassTimings;
+		}
+		// Device timestamp of the start of those passes in nanoseconds, comparable with graphics timestamps
+		uint64_t GetPassTimingsOrigin() const
+		{
+			return m_PassTimingsOrigin;
+		}
+
+	private:
+		struct ComputePass
+		{
+			std::string Name;
+			VkPipelineStageFlags ConsumerStage;
+			RecordFunc Record;
+		};
+
+		struct FrameData
+		{
+			VkCommandBuffer CommandBuffer = nullptr;
+			VkQueryPool QueryPool = nullptr;
+			std::vector<std::string> PassNames;
+			// Compute timeline value of the last submission from this slot, 0 if there is none pending
+			uint64_t TimelineValue = 0;
+		};
+
+		void ReadTimings( FrameData& frame );
+
+	private:
+		VulkanLogicalDevice* m_Device;
+
+		std::vector<ComputePass> m_Passes;
+		std::vector<FrameData> m_Frames;
+
+		bool m_TimestampsSupported = false;
+		uint64_t m_TimestampMask = 0;
+		float m_TimestampPeriod = 1.0f;
+
+		std::vector<ComputePassTiming> m_PassTimings;
+		uint64_t m_PassTimingsOrigin = 0;
+	};
+}
@@ -0,0 +1,309 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanDescriptorAllocator.h"
+
+#include "Platform/Vulkan/VulkanDevice.h"
+
+#include "Renderer/Renderer.h"
+
+#include "Core/Hash.h"
+#include "Core/JobSystem.h"
+
+namespace VE
+{
+
+	static constexpr uint32_t s_SetsPerPool = 1024;
+
+	// Descriptors per set each pool reserves of every type
+	static constexpr std::pair<VkDescriptorType, float> s_PoolSizes[] =
+	{
+		{ VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f },
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f },
+		{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4.0f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.5f },
+	};
+
+	static size_t GetDescriptorInfoSize( VkDescriptorType type )
+	{
+		switch ( type )
+		{
+			case VK_DESCRIPTOR_TYPE_SAMPLER:
+			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+			case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:			return sizeof( VkDescriptorImageInfo );
+			case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+			case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:		return sizeof( VkBufferView );
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:	return sizeof( VkDescriptorBufferInfo );
+			default: break;
+		}
+		VE_ASSERT( false, "Unsupported descriptor type!" );
+		return 0;
+	}
+
+	VulkanDescriptorAllocator::VulkanDescriptorAllocator( VulkanLogicalDevice* device )
+		: m_Device( device )
+	{
+		m_Frames.resize( Renderer::GetConfig().FramesInFlight );
+		for ( auto& frame : m_Frames )
+		{
+			frame.resize( JobSystem::GetWorkerCount() + 1 );
+		}
+	}
+
+	VulkanDescriptorAllocator::~VulkanDescriptorAllocator()
+	{
+		VkDevice device = m_Device->GetVulkanLogicalDevice();
+
+		for ( auto& frame : m_Frames )
+		{
+			for ( auto& threadPools : frame )
+			{
+				for ( auto pool : threadPools.Pools )
+				{
+					vkDestroyDescriptorPool( device, pool, nullptr );
+				}
+			}
+		}
+		for ( auto pool : m_FreePools )
+		{
+			vkDestroyDescriptorPool( device, pool, nullptr );
+		}
+		for ( auto pool : m_StaticPools )
+		{
+			vkDestroyDescriptorPool( device, pool, nullptr );
+		}
+		for ( auto& [layout, descriptorTemplate] : m_Templates )
+		{
+			vkDestroyDescriptorUpdateTemplate( device, descriptorTemplate.Template, nullptr );
+		}
+	}
+
+	void VulkanDescriptorAllocator::BeginFrame( uint32_t frameIndex )
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		VkDevice device = m_Device->GetVulkanLogicalDevice();
+
+		for ( auto& threadPools : m_Frames[ frameIndex ] )
+		{
+			for ( auto pool : threadPools.Pools )
+			{
+				VK_CHECK_RESULT( vkResetDescriptorPool( device, pool, 0 ) );
+				m_FreePools.push_back( pool );
+			}
+			threadPools.Pools.clear();
+			threadPools.SetCount = 0;
+		}
+
+		m_FrameIndex = frameIndex;
+	}
+
+	const VulkanDescriptorTemplate& VulkanDescriptorAllocator::GetTemplate( VkDescriptorSetLayout layout, const std::vector<VkDescriptorSetLayoutBinding>& bindings )
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		auto it = m_Templates.find( layout );
+		if ( it != m_Templates.end() )
+			return it->second;
+
+		std::vector<VkDescriptorSetLayoutBinding> sortedBindings = bindings;
+		std::sort( sortedBindings.begin(), sortedBindings.end(), []( const auto& a, const auto& b ) { return a.binding < b.binding; } );
+
+		VulkanDescriptorTemplate descriptorTemplate;
+		std::vector<VkDescriptorUpdateTemplateEntry> entries;
+		for ( const auto& binding : sortedBindings )
+		{
+			if ( binding.descriptorCount == 0 )
+				continue;
+
+			size_t stride = GetDescriptorInfoSize( binding.descriptorType );
+
+			VkDescriptorUpdateTemplateEntry entry{};
+			entry.dstBinding = binding.binding;
+			entry.dstArrayElement = 0;
+			entry.descriptorCount = binding.descriptorCount;
+			entry.descriptorType = binding.descriptorType;
+			entry.offset = descriptorTemplate.DataSize;
+			entry.stride = stride;
+			entries.push_back( entry );
+
+			descriptorTemplate.DataSize += stride * binding.descriptorCount;
+		}
+
+		VkDescriptorUpdateTemplateCreateInfo templateInfo{};
+		templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+		templateInfo.descriptorUpdateEntryCount = ( uint32_t )entries.size();
+		templateInfo.pDescriptorUpdateEntries = entries.data();
+		templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+		templateInfo.descriptorSetLayout = layout;
+		VK_CHECK_RESULT( vkCreateDescriptorUpdateTemplate( m_Device->GetVulkanLogicalDevice(), &templateInfo, nullptr, &descriptorTemplate.Template ) );
+
+		return m_Templates.emplace( layout, descriptorTemplate ).first->second;
+	}
+
+	VkDescriptorSet VulkanDescriptorAllocator::AllocateFrameSet( VkDescriptorSetLayout layout )
+	{
+		uint32_t threadIndex = JobSystem::GetThreadIndex();
+		FramePools& threadPools = m_Frames[ m_FrameIndex ][ threadIndex ];
+
+		// The main thread, the render thread and any job they run while waiting all map to index 0
+		std::unique_lock<std::mutex> sharedLock( m_SharedFrameMutex, std::defer_lock );
+		if ( threadIndex == 0 )
+			sharedLock.lock();
+
+		threadPools.SetCount++;
+
+		VkDescriptorSet set;
+		VkResult result = threadPools.Pools.empty() ? VK_ERROR_OUT_OF_POOL_MEMORY : AllocateFromPool( threadPools.Pools.back(), layout, &set );
+		if ( result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL )
+		{
+			// Only the shared free list needs the lock
+			{
+				std::lock_guard<std::mutex> lock( m_Mutex );
+				threadPools.Pools.push_back( AcquirePool() );
+			}
+			result = AllocateFromPool( threadPools.Pools.back(), layout, &set );
+		}
+		VK_CHECK_RESULT( result );
+
+		return set;
+	}
+
+	VkDescriptorSet VulkanDescriptorAllocator::AllocateFrameSet( VkDescriptorSetLayout layout, const VulkanDescriptorTemplate& descriptorTemplate, const void* data )
+	{
+		VkDescriptorSet set = AllocateFrameSet( layout );
+		vkUpdateDescriptorSetWithTemplate( m_Device->GetVulkanLogicalDevice(), set, descriptorTemplate.Template, data );
+		return set;
+	}
+
+	VkDescriptorSet VulkanDescriptorAllocator::GetStaticSet( VkDescriptorSetLayout layout, const VulkanDescriptorTemplate& descriptorTemplate, const void* data )
+	{
+		uint64_t hash = Hash::FNVValue( layout );
+		hash = Hash::FNV( data, descriptorTemplate.DataSize, hash );
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		auto [begin, end] = m_StaticSets.equal_range( hash );
+		for ( auto it = begin; it != end; ++it )
+		{
+			const StaticSet& staticSet = it->second;
+			if ( staticSet.Layout == layout && memcmp( staticSet.Data.data(), data, descriptorTemplate.DataSize ) == 0 )
+			{
+				m_StaticSetHits++;
+				return staticSet.Set;
+			}
+		}
+
+		m_StaticSetMisses++;
+
+		VkDescriptorSet set = Allocate( m_StaticPools, layout );
+		vkUpdateDescriptorSetWithTemplate( m_Device->GetVulkanLogicalDevice(), set, descriptorTemplate.Template, data );
+
+		const uint8_t* bytes = ( const uint8_t* )data;
+		m_StaticSets.emplace( hash, StaticSet{ layout, std::vector<uint8_t>( bytes, bytes + descriptorTemplate.DataSize ), set } );
+		return set;
+	}
+
+	void VulkanDescriptorAllocator::ClearStaticSets()
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		m_StaticSets.clear();
+		for ( auto pool : m_StaticPools )
+		{
+			Renderer::SubmitResourceFree( [this, pool]()
+				{
+					VK_CHECK_RESULT( vkResetDescriptorPool( m_Device->GetVulkanLogicalDevice(), pool, 0 ) );
+
+					std::lock_guard<std::mutex> lock( m_Mutex );
+					m_FreePools.push_back( pool );
+				} );
+		}
+		m_StaticPools.clear();
+	}
+
+	DescriptorAllocatorStatistics VulkanDescriptorAllocator::GetStatistics()
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		DescriptorAllocatorStatistics statistics;
+		for ( auto& threadPools : m_Frames[ m_FrameIndex ] )
+		{
+			statistics.FrameSetCount += threadPools.SetCount;
+			statistics.FramePoolCount += ( uint32_t )threadPools.Pools.size();
+		}
+		statistics.StaticSetCount = ( uint32_t )m_StaticSets.size();
+		statistics.StaticSetHits = m_StaticSetHits;
+		statistics.StaticSetMisses = m_StaticSetMisses;
+		return statistics;
+	}
+
+	VkDescriptorPool VulkanDescriptorAllocator::CreatePool()
+	{
+		std::vector<VkDescriptorPoolSize> poolSizes;
+		for ( auto& [type, ratio] : s_PoolSizes )
+		{
+			poolSizes.push_back( { type, ( uint32_t )( ratio * s_SetsPerPool ) } );
+		}
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.maxSets = s_SetsPerPool;
+		poolInfo.poolSizeCount = ( uint32_t )poolSizes.size();
+		poolInfo.pPoolSizes = poolSizes.data();
+
+		VkDescriptorPool pool;
+		VK_CHECK_RESULT( vkCreateDescriptorPool( m_Device->GetVulkanLogicalDevice(), &poolInfo, nullptr, &pool ) );
+		return pool;
+	}
+
+	VkDescriptorPool VulkanDescriptorAllocator::AcquirePool()
+	{
+		if ( m_FreePools.empty() )
+			return CreatePool();
+
+		VkDescriptorPool pool = m_FreePools.back();
+		m_FreePools.pop_back();
+		return pool;
+	}
+
+	VkDescriptorSet VulkanDescriptorAllocator::Allocate( std::vector<VkDescriptorPool>& pools, VkDescriptorSetLayout layout )
+	{
+		if ( pools.empty() )
+			pools.push_back( AcquirePool() );
+
+		VkDescriptorSet set;
+		VkResult result = AllocateFromPool( pools.back(), layout, &set );
+		if ( result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL )
+		{
+			// The pool is full, continue in a fresh one
+			pools.push_back( AcquirePool() );
+			result = AllocateFromPool( pools.back(), layout, &set );
+		}
+		VK_CHECK_RESULT( result );
+
+		return set;
+	}
+
+	VkResult VulkanDescriptorAllocator::AllocateFromPool( VkDescriptorPool pool, VkDescriptorSetLayout layout, VkDescriptorSet* set )
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &layout;
+		allocInfo.descriptorPool = pool;
+
+		return vkAllocateDescriptorSets( m_Device->GetVulkanLogicalDevice(), &allocInfo, set );
+	}
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+
+#include <mutex>
+
+namespace VE
+{
+	class VulkanLogicalDevice;
+
+	// Update template for every binding of a set layout. The data passed to it holds the bindings in binding
+	// order, each as descriptorCount tightly packed VkDescriptorBufferInfo, VkDescriptorImageInfo or
+	// VkBufferView structures depending on the descriptor type.
+	struct VulkanDescriptorTemplate
+	{
+		VkDescriptorUpdateTemplate Template = nullptr;
+		size_t DataSize = 0;
+	};
+
+	struct DescriptorAllocatorStatistics
+	{
+		uint32_t FrameSetCount = 0;
+		uint32_t FramePoolCount = 0;
+		uint32_t StaticSetCount = 0;
+		uint32_t StaticSetHits = 0;
+		uint32_t StaticSetMisses = 0;
+	};
+
+	// Descriptor sets come in two lifetimes. Frame sets are allocated linearly from pools owned by the frame
+	// in flight and the job system thread, more pools are added whenever one runs out, and all of them are reset
+	// at once when the frame slot comes round again, so there is no per-set freeing. Static sets are cached by their layout and
+	// contents, so requesting the same set again costs a hash lookup instead of an allocation and a write.
+	class VulkanDescriptorAllocator
+	{
+	public:
+		VulkanDescriptorAllocator( VulkanLogicalDevice* device );
+		~VulkanDescriptorAllocator();
+
+		// Render thread: the previous work of the frame slot has completed, its sets can be recycled
+		void BeginFrame( uint32_t frameIndex );
+
+		const VulkanDescriptorTemplate& GetTemplate( VkDescriptorSetLayout layout, const std::vector<VkDescriptorSetLayoutBinding>& bindings );
+
+		// Valid until the current frame slot is reused. Workers allocate from their own pools without locking,
+		// every non-worker thread shares JobSystem thread index 0 and with it one locked set of pools.
+		VkDescriptorSet AllocateFrameSet( VkDescriptorSetLayout layout );
+		VkDescriptorSet AllocateFrameSet( VkDescriptorSetLayout layout, const VulkanDescriptorTemplate& descriptorTemplate, const void* data );
+
+		// Valid until ClearStaticSets. The resources referenced by data must outlive the set.
+		VkDescriptorSet GetStaticSet( VkDescriptorSetLayout layout, const VulkanDescriptorTemplate& descriptorTemplate, const void* data );
+		// Drops every static set once the frames that may still use them have completed
+		void ClearStaticSets();
+
+		DescriptorAllocatorStatistics GetStatistics();
+
+	private:
+		struct FramePools
+		{
+			std::vector<VkDescriptorPool> Pools;
+			uint32_t SetCount = 0;
+		};
+
+		struct StaticSet
+		{
+			VkDescriptorSetLayout Layout;
+			std::vector<uint8_t> Data;
+			VkDescriptorSet Set;
+		};
+
+		VkDescriptorPool CreatePool();
+		VkDescriptorPool AcquirePool();
+		VkDescriptorSet Allocate( std::vector<VkDescriptorPool>& pools, VkDescriptorSetLayout layout );
+		VkResult AllocateFromPool( VkDescriptorPool pool, VkDescriptorSetLayout layout, VkDescriptorSet* set );
+
+	private:
+		VulkanLogicalDevice* m_Device;
+
+		// Frame in flight, then JobSystem thread index
+		std::vector<std::vector<FramePools>> m_Frames;
+		// Guards the pools of thread index 0
+		std::mutex m_SharedFrameMutex;
+		uint32_t m_FrameIndex = 0;
+		std::vector<VkDescriptorPool> m_FreePools;
+
+		std::vector<VkDescriptorPool> m_StaticPools;
+		std::unordered_multimap<uint64_t, StaticSet> m_StaticSets;
+		uint32_t m_StaticSetHits = 0;
+		uint32_t m_StaticSetMisses = 0;
+
+		std::unordered_map<VkDescriptorSetLayout, VulkanDescriptorTemplate> m_Templates;
+
+		std::mutex m_Mutex;
+	};
+}
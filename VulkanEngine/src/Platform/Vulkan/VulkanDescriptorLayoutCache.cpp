@@ -0,0 +1,131 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanDescriptorLayoutCache.h"
+
+#include "Platform/Vulkan/VulkanShaderReflection.h"
+
+#include "Core/Hash.h"
+
+namespace VE
+{
+
+	static bool IsEqual( const std::vector<VkDescriptorSetLayoutBinding>& a, const std::vector<VkDescriptorSetLayoutBinding>& b )
+	{
+		return std::equal( a.begin(), a.end(), b.begin(), b.end(), []( const auto& x, const auto& y )
+			{
+				return x.binding == y.binding && x.descriptorType == y.descriptorType && x.descriptorCount == y.descriptorCount && x.stageFlags == y.stageFlags;
+			} );
+	}
+
+	static bool IsEqual( const std::vector<VkPushConstantRange>& a, const std::vector<VkPushConstantRange>& b )
+	{
+		return std::equal( a.begin(), a.end(), b.begin(), b.end(), []( const auto& x, const auto& y )
+			{
+				return x.stageFlags == y.stageFlags && x.offset == y.offset && x.size == y.size;
+			} );
+	}
+
+	VulkanDescriptorLayoutCache::VulkanDescriptorLayoutCache( VkDevice device )
+		: m_Device( device )
+	{
+	}
+
+	VulkanDescriptorLayoutCache::~VulkanDescriptorLayoutCache()
+	{
+		if ( m_Requests > 0 )
+			VE_TRACE( "layout cache: {0} requests served by {1} set layouts and {2} pipeline layouts", m_Requests, m_SetLayouts.size(), m_PipelineLayouts.size() );
+
+		for ( auto& [hash, entry] : m_PipelineLayouts )
+		{
+			vkDestroyPipelineLayout( m_Device, entry.Layout, nullptr );
+		}
+		for ( auto& [hash, entry] : m_SetLayouts )
+		{
+			vkDestroyDescriptorSetLayout( m_Device, entry.Layout, nullptr );
+		}
+	}
+
+	VkDescriptorSetLayout VulkanDescriptorLayoutCache::GetDescriptorSetLayout( std::vector<VkDescriptorSetLayoutBinding> bindings )
+	{
+		std::sort( bindings.begin(), bindings.end(), []( const auto& a, const auto& b ) { return a.binding < b.binding; } );
+
+		uint64_t hash = Hash::FNVOffsetBasis;
+		for ( const auto& binding : bindings )
+		{
+			VE_ASSERT( !binding.pImmutableSamplers, "Immutable samplers are not supported by the layout cache!" );
+			hash = Hash::FNVValue( binding.binding, hash );
+			hash = Hash::FNVValue( binding.descriptorType, hash );
+			hash = Hash::FNVValue( binding.descriptorCount, hash );
+			hash = Hash::FNVValue( binding.stageFlags, hash );
+		}
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_Requests++;
+
+		auto [begin, end] = m_SetLayouts.equal_range( hash );
+		for ( auto it = begin; it != end; ++it )
+		{
+			if ( IsEqual( it->second.Bindings, bindings ) )
+				return it->second.Layout;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = ( uint32_t )bindings.size();
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		VK_CHECK_RESULT( vkCreateDescriptorSetLayout( m_Device, &layoutInfo, nullptr, &layout ) );
+
+		m_SetLayouts.emplace( hash, SetLayoutEntry{ std::move( bindings ), layout } );
+		return layout;
+	}
+
+	VkPipelineLayout VulkanDescriptorLayoutCache::GetPipelineLayout( const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges )
+	{
+		// Set layouts are unique per content, so their handles identify them
+		uint64_t hash = Hash::FNV( setLayouts.data(), setLayouts.size() * sizeof( VkDescriptorSetLayout ) );
+		for ( const auto& range : pushConstantRanges )
+		{
+			hash = Hash::FNVValue( range.stageFlags, hash );
+			hash = Hash::FNVValue( range.offset, hash );
+			hash = Hash::FNVValue( range.size, hash );
+		}
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		auto [begin, end] = m_PipelineLayouts.equal_range( hash );
+		for ( auto it = begin; it != end; ++it )
+		{
+			if ( it->second.SetLayouts == setLayouts && IsEqual( it->second.PushConstantRanges, pushConstantRanges ) )
+				return it->second.Layout;
+		}
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = ( uint32_t )setLayouts.size();
+		layoutInfo.pSetLayouts = setLayouts.data();
+		layoutInfo.pushConstantRangeCount = ( uint32_t )pushConstantRanges.size();
+		layoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+		VkPipelineLayout layout;
+		VK_CHECK_RESULT( vkCreatePipelineLayout( m_Device, &layoutInfo, nullptr, &layout ) );
+
+		m_PipelineLayouts.emplace( hash, PipelineLayoutEntry{ setLayouts, pushConstantRanges, layout } );
+		return layout;
+	}
+
+	VulkanPipelineLayoutInfo VulkanDescriptorLayoutCache::GetLayouts( const VulkanShaderReflection& reflection )
+	{
+		VulkanPipelineLayoutInfo info;
+
+		uint32_t setCount = reflection.GetSetCount();
+		for ( uint32_t set = 0; set < setCount; set++ )
+		{
+			info.SetLayouts.push_back( GetDescriptorSetLayout( reflection.GetSetLayoutBindings( set ) ) );
+		}
+
+		info.PipelineLayout = GetPipelineLayout( info.SetLayouts, reflection.PushConstantRanges );
+		return info;
+	}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+
+#include <mutex>
+
+namespace VE
+{
+	struct VulkanShaderReflection;
+
+	struct VulkanPipelineLayoutInfo
+	{
+		// Indexed by set number. Sets a shader does not use get an empty layout.
+		std::vector<VkDescriptorSetLayout> SetLayouts;
+		VkPipelineLayout PipelineLayout = nullptr;
+	};
+
+	// Deduplicates descriptor set layouts and pipeline layouts by content, so every shader with the same
+	// resource interface shares one layout object and descriptor sets stay compatible between pipelines.
+	// Layouts live until the device is destroyed.
+	class VulkanDescriptorLayoutCache
+	{
+	public:
+		VulkanDescriptorLayoutCache( VkDevice device );
+		~VulkanDescriptorLayoutCache();
+
+		VkDescriptorSetLayout GetDescriptorSetLayout( std::vector<VkDescriptorSetLayoutBinding> bindings );
+		VkPipelineLayout GetPipelineLayout( const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges );
+
+		VulkanPipelineLayoutInfo GetLayouts( const VulkanShaderReflection& reflection );
+
+	private:
+		struct SetLayoutEntry
+		{
+			std::vector<VkDescriptorSetLayoutBinding> Bindings;
+			VkDescriptorSetLayout Layout;
+		};
+
+		struct PipelineLayoutEntry
+		{
+			std::vector<VkDescriptorSetLayout> SetLayouts;
+			std::vector<VkPushConstantRange> PushConstantRanges;
+			VkPipelineLayout Layout;
+		};
+
+	private:
+		VkDevice m_Device;
+
+		std::unordered_multimap<uint64_t, SetLayoutEntry> m_SetLayouts;
+		std::unordered_multimap<uint64_t, PipelineLayoutEntry> m_PipelineLayouts;
+		uint32_t m_Requests = 0;
+
+		std::mutex m_Mutex;
+	};
+}
@@ -3,6 +3,8 @@
 
 #include "Platform/Vulkan/VulkanInstance.h"
 
+#include "Renderer/Renderer.h"
+
 #include <set>
 
 namespace VE
@@ -36,6 +38,13 @@ namespace VE
 
 		vkGetPhysicalDeviceFeatures( m_PhysicalDevice, &m_Features );
 
+		m_Features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &m_Features12;
+		vkGetPhysicalDeviceFeatures2( m_PhysicalDevice, &features2 );
+		m_Features12.pNext = nullptr;
+
 		uint32_t queueFamilyCount;
 		vkGetPhysicalDeviceQueueFamilyProperties( m_PhysicalDevice, &queueFamilyCount, nullptr );
 		VE_ASSERT( queueFamilyCount > 0 );
@@ -49,11 +58,25 @@ namespace VE
 			std::vector<VkExtensionProperties> extensions( extCount );
 			if ( vkEnumerateDeviceExtensionProperties( m_PhysicalDevice, nullptr, &extCount, &extensions.front() ) == VK_SUCCESS )
 			{
-				VE_TRACE( "Selected physical device has {0} extensions", extensions.size() );
 				for ( const auto& ext : extensions )
-				{
 					m_SupportedExtensions.emplace( ext.extensionName );
-					VE_TRACE( "  {0}", ext.extensionName );
+
+				// One message for the whole list instead of one per extension, and only built if it is written
+				if ( Log::ShouldLog( spdlog::level::trace ) )
+				{
+					std::string names;
+					for ( const auto& ext : extensions )
+					{
+						if ( !names.empty() )
+							names += ", ";
+						names += ext.extensionName;
+					}
+					VE_TRACE( "Selected physical device has {0} extensions: {1}", extensions.size(), names );
+					Log::CountSkipped( ( uint32_t )extensions.size() );
+				}
+				else
+				{
+					Log::CountSkipped( ( uint32_t )extensions.size() + 1 );
 				}
 			}
 		}
@@ -210,16 +233,25 @@ namespace VE
 			}
 		}
 
+		if ( ( flags & VK_QUEUE_COMPUTE_BIT ) && indices.Compute == -1 )
+			indices.Compute = indices.Graphics;
+
+		if ( ( flags & VK_QUEUE_TRANSFER_BIT ) && indices.Transfer == -1 )
+			indices.Transfer = indices.Compute;
+
 		return indices;
 	}
 
-	VulkanLogicalDevice::VulkanLogicalDevice( const Ref<VulkanPhysicalDevice>& physicalDevice, VkPhysicalDeviceFeatures physicalDeviceFeatures )
+	VulkanLogicalDevice::VulkanLogicalDevice( const Ref<VulkanPhysicalDevice>& physicalDevice, VkPhysicalDeviceFeatures physicalDeviceFeatures, VkPhysicalDeviceVulkan12Features features12, bool presentation )
 		: m_PhysicalDevice( physicalDevice ), m_PhysicalDeviceFeatures( physicalDeviceFeatures )
 	{
 		std::vector<const char*> deviceExtensions;
 		// If the device will be used for presenting to a display via a swapchain we need to request the swapchain extension
-		VE_ASSERT( m_PhysicalDevice->IsExtensionSupported( VK_KHR_SWAPCHAIN_EXTENSION_NAME ) );
-		deviceExtensions.push_back( VK_KHR_SWAPCHAIN_EXTENSION_NAME );
+		if ( presentation )
+		{
+			VE_ASSERT( m_PhysicalDevice->IsExtensionSupported( VK_KHR_SWAPCHAIN_EXTENSION_NAME ) );
+			deviceExtensions.push_back( VK_KHR_SWAPCHAIN_EXTENSION_NAME );
+		}
 
 		if ( m_PhysicalDevice->IsExtensionSupported( VK_NV_DEVICE_DIAGNOSTIC_CHECKPOINTS_EXTENSION_NAME ) )
 			deviceExtensions.push_back( VK_NV_DEVICE_DIAGNOSTIC_CHECKPOINTS_EXTENSION_NAME );
@@ -227,9 +259,17 @@ namespace VE
 			deviceExtensions.push_back( VK_NV_DEVICE_DIAGNOSTICS_CONFIG_EXTENSION_NAME );
 		if ( m_PhysicalDevice->IsExtensionSupported( VK_EXT_DEBUG_MARKER_EXTENSION_NAME ) )
 			deviceExtensions.push_back( VK_EXT_DEBUG_MARKER_EXTENSION_NAME );
+		if ( m_PhysicalDevice->IsExtensionSupported( VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME ) )
+			deviceExtensions.push_back( VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME );
+
+		// Frame pacing and cross-queue synchronization are built on timeline semaphores
+		VE_ASSERT( m_PhysicalDevice->m_Features12.timelineSemaphore, "Timeline semaphores are not supported!" );
+		VE_ASSERT( features12.timelineSemaphore );
+		features12.pNext = nullptr;
 
 		VkDeviceCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		createInfo.pNext = &features12;
 		createInfo.queueCreateInfoCount = static_cast< uint32_t >( physicalDevice->m_QueueCreateInfos.size() );
 		createInfo.pQueueCreateInfos = physicalDevice->m_QueueCreateInfos.data();
 		createInfo.pEnabledFeatures = &physicalDeviceFeatures;
@@ -243,8 +283,24 @@ namespace VE
 
 		vkGetDeviceQueue( m_LogicalDevice, m_PhysicalDevice->m_QueueFamilyIndices.Graphics, 0, &m_GraphicsQueue );
 		vkGetDeviceQueue( m_LogicalDevice, m_PhysicalDevice->m_QueueFamilyIndices.Compute, 0, &m_ComputeQueue );
+		vkGetDeviceQueue( m_LogicalDevice, m_PhysicalDevice->m_QueueFamilyIndices.Transfer, 0, &m_TransferQueue );
 
 		CreateCommandPool();
+
+		m_GraphicsTimeline = CreateScope<VulkanTimelineSemaphore>( m_LogicalDevice );
+		m_ComputeTimeline = CreateScope<VulkanTimelineSemaphore>( m_LogicalDevice );
+		m_TransferTimeline = CreateScope<VulkanTimelineSemaphore>( m_LogicalDevice );
+
+		m_Allocator = CreateScope<VulkanAllocator>( this );
+		m_UploadManager = CreateScope<VulkanUploadManager>( this );
+		m_ComputeScheduler = CreateScope<VulkanComputeScheduler>( this );
+		m_GPUProfiler = CreateScope<VulkanGPUProfiler>( this, Renderer::GetConfig().FramesInFlight );
+		m_PipelineCache = CreateScope<VulkanPipelineCache>( this );
+		m_DescriptorLayoutCache = CreateScope<VulkanDescriptorLayoutCache>( m_LogicalDevice );
+		m_DescriptorAllocator = CreateScope<VulkanDescriptorAllocator>( this );
+
+		if ( features12.descriptorIndexing )
+			m_BindlessTable = CreateScope<VulkanBindlessTable>( this );
 	}
 
 	void VulkanLogicalDevice::CreateCommandPool()
@@ -261,10 +317,26 @@ namespace VE
 
 	void VulkanLogicalDevice::Destroy()
 	{
+		vkDeviceWaitIdle( m_LogicalDevice );
+
+		m_BindlessTable.reset();
+		m_DescriptorAllocator.reset();
+		m_DescriptorLayoutCache.reset();
+		m_PipelineCache.reset();
+		m_GPUProfiler.reset();
+		m_ComputeScheduler.reset();
+		m_UploadManager.reset();
+
+		m_Allocator->DumpStatistics();
+		m_Allocator.reset();
+
+		m_GraphicsTimeline.reset();
+		m_ComputeTimeline.reset();
+		m_TransferTimeline.reset();
+
 		vkDestroyCommandPool( m_LogicalDevice, m_CommandPool, nullptr );
 		vkDestroyCommandPool( m_LogicalDevice, m_ComputeCommandPool, nullptr );
 
-		vkDeviceWaitIdle( m_LogicalDevice );
 		vkDestroyDevice( m_LogicalDevice, nullptr );
 	}
 
@@ -1,6 +1,15 @@
 #pragma once
 
 #include "Platform/Vulkan/Vulkan.h"
+#include "Platform/Vulkan/VulkanAllocator.h"
+#include "Platform/Vulkan/VulkanUploadManager.h"
+#include "Platform/Vulkan/VulkanComputeScheduler.h"
+#include "Platform/Vulkan/VulkanGPUProfiler.h"
+#include "Platform/Vulkan/VulkanTimelineSemaphore.h"
+#include "Platform/Vulkan/VulkanPipelineCache.h"
+#include "Platform/Vulkan/VulkanDescriptorLayoutCache.h"
+#include "Platform/Vulkan/VulkanDescriptorAllocator.h"
+#include "Platform/Vulkan/VulkanBindlessTable.h"
 
 #include <unordered_set>
 
@@ -32,6 +41,18 @@ namespace VE
 		{
 			return m_QueueFamilyIndices;
 		}
+		const VkPhysicalDeviceProperties& GetProperties() const
+		{
+			return m_Properties;
+		}
+		const std::vector<VkQueueFamilyProperties>& GetQueueFamilyProperties() const
+		{
+			return m_QueueFamilyProperties;
+		}
+		const VkPhysicalDeviceVulkan12Features& GetVulkan12Features() const
+		{
+			return m_Features12;
+		}
 
 		static Ref<VulkanPhysicalDevice> Pick();
 
@@ -46,6 +67,7 @@ namespace VE
 		VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
 		VkPhysicalDeviceProperties m_Properties;
 		VkPhysicalDeviceFeatures m_Features;
+		VkPhysicalDeviceVulkan12Features m_Features12{};
 
 		QueueFamilyIndices m_QueueFamilyIndices;
 		std::vector<VkQueueFamilyProperties> m_QueueFamilyProperties;
@@ -61,7 +83,7 @@ namespace VE
 	class VulkanLogicalDevice
 	{
 	public:
-		VulkanLogicalDevice( const Ref<VulkanPhysicalDevice>& physicalDevice, VkPhysicalDeviceFeatures physicalDeviceFeatures );
+		VulkanLogicalDevice( const Ref<VulkanPhysicalDevice>& physicalDevice, VkPhysicalDeviceFeatures physicalDeviceFeatures, VkPhysicalDeviceVulkan12Features features12, bool presentation = true );
 
 		void CreateCommandPool();
 		void Destroy();
@@ -74,6 +96,28 @@ namespace VE
 		{
 			return m_ComputeQueue;
 		}
+		VkQueue GetTransferQueue()
+		{
+			return m_TransferQueue;
+		}
+		VkCommandPool GetComputeCommandPool()
+		{
+			return m_ComputeCommandPool;
+		}
+
+		// One timeline per queue, signalled by every submission to that queue
+		VulkanTimelineSemaphore& GetGraphicsTimeline()
+		{
+			return *m_GraphicsTimeline;
+		}
+		VulkanTimelineSemaphore& GetComputeTimeline()
+		{
+			return *m_ComputeTimeline;
+		}
+		VulkanTimelineSemaphore& GetTransferTimeline()
+		{
+			return *m_TransferTimeline;
+		}
 
 		VkDevice GetVulkanLogicalDevice() const
 		{
@@ -84,12 +128,61 @@ namespace VE
 			return m_PhysicalDevice;
 		}
 
+		VulkanAllocator& GetAllocator()
+		{
+			return *m_Allocator;
+		}
+		VulkanUploadManager& GetUploadManager()
+		{
+			return *m_UploadManager;
+		}
+		VulkanComputeScheduler& GetComputeScheduler()
+		{
+			return *m_ComputeScheduler;
+		}
+		VulkanGPUProfiler& GetGPUProfiler()
+		{
+			return *m_GPUProfiler;
+		}
+		VulkanPipelineCache& GetPipelineCache()
+		{
+			return *m_PipelineCache;
+		}
+		VulkanDescriptorLayoutCache& GetDescriptorLayoutCache()
+		{
+			return *m_DescriptorLayoutCache;
+		}
+		VulkanDescriptorAllocator& GetDescriptorAllocator()
+		{
+			return *m_DescriptorAllocator;
+		}
+		// Only available in bindless mode
+		VulkanBindlessTable& GetBindlessTable()
+		{
+			VE_ASSERT( m_BindlessTable, "Bindless mode is not enabled!" );
+			return *m_BindlessTable;
+		}
+		bool IsBindlessEnabled() const
+		{
+			return m_BindlessTable != nullptr;
+		}
+
 	private:
 		VkDevice m_LogicalDevice = nullptr;
 		Ref<VulkanPhysicalDevice> m_PhysicalDevice;
 		VkPhysicalDeviceFeatures m_PhysicalDeviceFeatures;
 		VkCommandPool m_CommandPool, m_ComputeCommandPool;
 
-		VkQueue m_GraphicsQueue, m_ComputeQueue;
+		VkQueue m_GraphicsQueue, m_ComputeQueue, m_TransferQueue;
+		Scope<VulkanTimelineSemaphore> m_GraphicsTimeline, m_ComputeTimeline, m_TransferTimeline;
+
+		Scope<VulkanAllocator> m_Allocator;
+		Scope<VulkanUploadManager> m_UploadManager;
+		Scope<VulkanComputeScheduler> m_ComputeScheduler;
+		Scope<VulkanGPUProfiler> m_GPUProfiler;
+		Scope<VulkanPipelineCache> m_PipelineCache;
+		Scope<VulkanDescriptorLayoutCache> m_DescriptorLayoutCache;
+		Scope<VulkanDescriptorAllocator> m_DescriptorAllocator;
+		Scope<VulkanBindlessTable> m_BindlessTable;
 	};
 }
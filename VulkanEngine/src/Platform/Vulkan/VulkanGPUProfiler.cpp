@@ -0,0 +1,211 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanGPUProfiler.h"
+
+#include "Platform/Vulkan/VulkanDevice.h"
+
+#include <cfloat>
+
+namespace VE
+{
+
+	// Per frame, regions beyond this are not timed
+	static constexpr uint32_t s_MaxQueries = 512;
+
+	VulkanGPUProfiler::VulkanGPUProfiler( VulkanLogicalDevice* device, uint32_t framesInFlight )
+		: m_Device( device )
+	{
+		const auto& physicalDevice = m_Device->GetPhysicalDevice();
+
+		uint32_t graphicsFamily = physicalDevice->GetQueueFamilyIndices().Graphics;
+		uint32_t validBits = physicalDevice->GetQueueFamilyProperties()[ graphicsFamily ].timestampValidBits;
+		m_Supported = validBits > 0 && physicalDevice->GetProperties().limits.timestampPeriod > 0.0f;
+		m_TimestampMask = validBits >= 64 ? ~0ull : ( ( 1ull << validBits ) - 1 );
+		m_TimestampPeriod = physicalDevice->GetProperties().limits.timestampPeriod;
+
+		m_Frame.Timing.Name = "Frame";
+		m_Frames.resize( framesInFlight );
+		m_Results.resize( s_MaxQueries );
+
+		if ( !m_Supported )
+		{
+			VE_WARN( "graphics queue does not support timestamps, GPU regions will not be timed" );
+			return;
+		}
+
+		VkQueryPoolCreateInfo queryPoolInfo{};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolInfo.queryCount = s_MaxQueries;
+
+		for ( auto& frame : m_Frames )
+		{
+			VK_CHECK_RESULT( vkCreateQueryPool( m_Device->GetVulkanLogicalDevice(), &queryPoolInfo, nullptr, &frame.QueryPool ) );
+		}
+	}
+
+	VulkanGPUProfiler::~VulkanGPUProfiler()
+	{
+		for ( auto& frame : m_Frames )
+		{
+			if ( frame.QueryPool )
+				vkDestroyQueryPool( m_Device->GetVulkanLogicalDevice(), frame.QueryPool, nullptr );
+		}
+	}
+
+	void VulkanGPUProfiler::BeginFrame( uint32_t frameIndex, VkCommandBuffer commandBuffer )
+	{
+		FrameData& frame = m_Frames[ frameIndex ];
+		m_CurrentFrame = &frame;
+
+		if ( !m_Supported )
+			return;
+
+		ReadResults( frame );
+
+		frame.Regions.clear();
+		frame.QueryCount = 0;
+		frame.FrameEndQuery = UINT32_MAX;
+
+		vkCmdResetQueryPool( commandBuffer, frame.QueryPool, 0, s_MaxQueries );
+		frame.FrameBeginQuery = WriteTimestamp( commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT );
+	}
+
+	void VulkanGPUProfiler::EndFrame( VkCommandBuffer commandBuffer )
+	{
+		VE_ASSERT( m_CurrentFrame, "EndFrame without BeginFrame!" );
+
+		if ( m_Supported )
+			m_CurrentFrame->FrameEndQuery = WriteTimestamp( commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT );
+
+		m_CurrentFrame = nullptr;
+	}
+
+	uint32_t VulkanGPUProfiler::BeginRegion( VkCommandBuffer commandBuffer, const std::string& name )
+	{
+		VE_ASSERT( m_CurrentFrame, "GPU regions can only be recorded between BeginFrame and EndFrame!" );
+
+		if ( !m_Supported || m_CurrentFrame->QueryCount + 2 > s_MaxQueries )
+			return UINT32_MAX;
+
+		auto it = m_HistoryIndices.find( name );
+		if ( it == m_HistoryIndices.end() )
+		{
+			it = m_HistoryIndices.emplace( name, ( uint32_t )m_Histories.size() ).first;
+			m_Histories.emplace_back().Timing.Name = name;
+		}
+
+		Region region;
+		region.History = it->second;
+		region.BeginQuery = WriteTimestamp( commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT );
+		region.EndQuery = UINT32_MAX;
+		m_CurrentFrame->Regions.push_back( region );
+		return ( uint32_t )m_CurrentFrame->Regions.size() - 1;
+	}
+
+	void VulkanGPUProfiler::EndRegion( VkCommandBuffer commandBuffer, uint32_t region )
+	{
+		if ( region == UINT32_MAX )
+			return;
+
+		m_CurrentFrame->Regions[ region ].EndQuery = WriteTimestamp( commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT );
+	}
+
+	GPURegionTiming VulkanGPUProfiler::GetFrameTiming() const
+	{
+		std::lock_guard<std::mutex> lock( m_PublishMutex );
+		return m_PublishedFrame;
+	}
+
+	std::vector<GPURegionTiming> VulkanGPUProfiler::GetRegionTimings() const
+	{
+		std::lock_guard<std::mutex> lock( m_PublishMutex );
+		return m_PublishedRegions;
+	}
+
+	std::optional<GPURegionTiming> VulkanGPUProfiler::GetRegionTiming( const std::string& name ) const
+	{
+		std::lock_guard<std::mutex> lock( m_PublishMutex );
+		for ( const auto& timing : m_PublishedRegions )
+		{
+			if ( timing.Name == name )
+				return timing;
+		}
+		return std::nullopt;
+	}
+
+	uint32_t VulkanGPUProfiler::WriteTimestamp( VkCommandBuffer commandBuffer, VkPipelineStageFlagBits stage )
+	{
+		FrameData& frame = *m_CurrentFrame;
+		if ( frame.QueryCount >= s_MaxQueries )
+			return UINT32_MAX;
+
+		vkCmdWriteTimestamp( commandBuffer, stage, frame.QueryPool, frame.QueryCount );
+		return frame.QueryCount++;
+	}
+
+	void VulkanGPUProfiler::ReadResults( FrameData& frame )
+	{
+		if ( frame.QueryCount == 0 )
+			return;
+
+		// Without VK_QUERY_RESULT_WAIT_BIT, the frame has completed so everything it wrote is available
+		VkResult result = vkGetQueryPoolResults( m_Device->GetVulkanLogicalDevice(), frame.QueryPool, 0, frame.QueryCount,
+			frame.QueryCount * sizeof( uint64_t ), m_Results.data(), sizeof( uint64_t ), VK_QUERY_RESULT_64_BIT );
+		if ( result != VK_SUCCESS )
+			return;
+
+		auto toMillis = [this]( uint32_t begin, uint32_t end )
+		{
+			uint64_t ticks = ( m_Results[ end ] - m_Results[ begin ] ) & m_TimestampMask;
+			return ( float )( ( double )ticks * m_TimestampPeriod / 1000000.0 );
+		};
+
+		if ( frame.FrameBeginQuery != UINT32_MAX && frame.FrameEndQuery != UINT32_MAX )
+			AddSample( m_Frame, toMillis( frame.FrameBeginQuery, frame.FrameEndQuery ) );
+
+		for ( const auto& region : frame.Regions )
+		{
+			if ( region.EndQuery != UINT32_MAX )
+				AddSample( m_Histories[ region.History ], toMillis( region.BeginQuery, region.EndQuery ) );
+		}
+
+		Publish();
+	}
+
+	void VulkanGPUProfiler::AddSample( RegionHistory& history, float milliseconds )
+	{
+		GPURegionTiming& timing = history.Timing;
+
+		history.Samples[ history.Next ] = milliseconds;
+		history.Next = ( history.Next + 1 ) % RollingWindow;
+		timing.SampleCount = std::min( timing.SampleCount + 1, RollingWindow );
+		timing.Last = milliseconds;
+
+		// The window is small, recomputing it beats keeping a running sum that drifts
+		float sum = 0.0f;
+		timing.Min = FLT_MAX;
+		timing.Max = 0.0f;
+		for ( uint32_t i = 0; i < timing.SampleCount; i++ )
+		{
+			float sample = history.Samples[ i ];
+			sum += sample;
+			timing.Min = std::min( timing.Min, sample );
+			timing.Max = std::max( timing.Max, sample );
+		}
+		timing.Average = sum / timing.SampleCount;
+	}
+
+	void VulkanGPUProfiler::Publish()
+	{
+		std::lock_guard<std::mutex> lock( m_PublishMutex );
+
+		m_PublishedFrame = m_Frame.Timing;
+		m_PublishedRegions.clear();
+		for ( const auto& history : m_Histories )
+		{
+			if ( history.Timing.SampleCount > 0 )
+				m_PublishedRegions.push_back( history.Timing );
+		}
+	}
+
+}
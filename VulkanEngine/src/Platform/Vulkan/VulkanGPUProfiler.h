@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace VE
+{
+	class VulkanLogicalDevice;
+
+	struct GPURegionTiming
+	{
+		std::string Name;
+		// Milliseconds, over the last frames the region ran in
+		float Average = 0.0f;
+		float Min = 0.0f;
+		float Max = 0.0f;
+		float Last = 0.0f;
+		uint32_t SampleCount = 0;
+	};
+
+	// Times named regions of the graphics command buffer with timestamp queries. Every frame in flight has its
+	// own query pool, which is read back when the frame slot comes round again. By then the frame's timeline
+	// value has been waited on, so reading the results never stalls. The timings are published once per read
+	// back and can be queried from any thread.
+	class VulkanGPUProfiler
+	{
+	public:
+		static constexpr uint32_t RollingWindow = 64;
+
+		VulkanGPUProfiler( VulkanLogicalDevice* device, uint32_t framesInFlight );
+		~VulkanGPUProfiler();
+
+		// Render thread, outside of a render pass. Collects the results of the previous frame in the slot,
+		// which must have completed.
+		void BeginFrame( uint32_t frameIndex, VkCommandBuffer commandBuffer );
+		void EndFrame( VkCommandBuffer commandBuffer );
+
+		// Render thread. Regions may nest. Inside a render pass they are only allowed in subpasses recorded
+		// inline, not in subpasses whose contents are secondary command buffers.
+		uint32_t BeginRegion( VkCommandBuffer commandBuffer, const std::string& name );
+		void EndRegion( VkCommandBuffer commandBuffer, uint32_t region );
+
+		// Whole frame from BeginFrame to EndFrame
+		GPURegionTiming GetFrameTiming() const;
+		// Every region that has completed so far, in the order they were first recorded
+		std::vector<GPURegionTiming> GetRegionTimings() const;
+		// Empty if no region with that name has completed yet
+		std::optional<GPURegionTiming> GetRegionTiming( const std::string& name ) const;
+
+		bool IsSupported() const
+		{
+			return m_Supported;
+		}
+
+	private:
+		struct RegionHistory
+		{
+			GPURegionTiming Timing;
+			std::array<float, RollingWindow> Samples{};
+			uint32_t Next = 0;
+		};
+
+		struct Region
+		{
+			uint32_t History;
+			uint32_t BeginQuery;
+			uint32_t EndQuery;
+		};
+
+		struct FrameData
+		{
+			VkQueryPool QueryPool = nullptr;
+			std::vector<Region> Regions;
+			uint32_t QueryCount = 0;
+			uint32_t FrameBeginQuery = UINT32_MAX;
+			uint32_t FrameEndQuery = UINT32_MAX;
+		};
+
+		uint32_t WriteTimestamp( VkCommandBuffer commandBuffer, VkPipelineStageFlagBits stage );
+		void ReadResults( FrameData& frame );
+		void AddSample( RegionHistory& history, float milliseconds );
+		void Publish();
+
+	private:
+		VulkanLogicalDevice* m_Device;
+
+		bool m_Supported = false;
+		uint64_t m_TimestampMask = 0;
+		float m_TimestampPeriod = 1.0f;
+
+		std::vector<FrameData> m_Frames;
+		FrameData* m_CurrentFrame = nullptr;
+
+		RegionHistory m_Frame;
+		std::vector<RegionHistory> m_Histories;
+		std::unordered_map<std::string, uint32_t> m_HistoryIndices;
+		std::vector<uint64_t> m_Results;
+
+		// Copies of the render thread's histories for the getters
+		GPURegionTiming m_PublishedFrame;
+		std::vector<GPURegionTiming> m_PublishedRegions;
+		mutable std::mutex m_PublishMutex;
+	};
+
+	// Render thread: times the rest of the enclosing scope on the GPU
+	class VulkanGPUProfileScope
+	{
+	public:
+		VulkanGPUProfileScope( VulkanGPUProfiler& profiler, VkCommandBuffer commandBuffer, const std::string& name )
+			: m_Profiler( profiler ), m_CommandBuffer( commandBuffer ), m_Region( profiler.BeginRegion( commandBuffer, name ) )
+		{
+		}
+
+		~VulkanGPUProfileScope()
+		{
+			m_Profiler.EndRegion( m_CommandBuffer, m_Region );
+		}
+
+	private:
+		VulkanGPUProfiler& m_Profiler;
+		VkCommandBuffer m_CommandBuffer;
+		uint32_t m_Region;
+	};
+}
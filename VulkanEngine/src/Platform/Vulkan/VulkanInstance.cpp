@@ -1,7 +1,13 @@
 #include "vepch.h"
 #include "Platform/Vulkan/VulkanInstance.h"
 
-#include <GLFW/glfw3.h>
+#include "Platform/Vulkan/VulkanBindlessTable.h"
+
+#include "Renderer/Renderer.h"
+
+#ifdef VE_PLATFORM_WINDOWS
+	#include <GLFW/glfw3.h>
+#endif
 
 namespace VE
 {
@@ -10,13 +16,30 @@ namespace VE
 
 	static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback( VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData )
 	{
-		VE_TRACE( "Validation layer: {0}", pCallbackData->pMessage );
+		spdlog::level::level_enum level = spdlog::level::trace;
+		if ( messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT )
+			level = spdlog::level::err;
+		else if ( messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT )
+			level = spdlog::level::warn;
+		else if ( messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT )
+			level = spdlog::level::info;
+
+		// Called on whichever thread made the Vulkan call, skip the formatting for messages nobody reads
+		if ( !Log::ShouldLog( level ) )
+		{
+			Log::CountSkipped();
+			return VK_FALSE;
+		}
+
+		Log::GetLogger( level )->log( level, "Validation layer: {0}", pCallbackData->pMessage );
 
 		return VK_FALSE;
 	}
 
-	VulkanInstance::VulkanInstance()
+	VulkanInstance::VulkanInstance( bool headless )
+		: m_Headless( headless )
 	{
+		s_Context = this;
 	}
 
 	VulkanInstance::~VulkanInstance()
@@ -30,10 +53,13 @@ namespace VE
 
 		vkDestroyInstance( s_Instance, nullptr );
 		s_Instance = nullptr;
+		s_Context = nullptr;
 	}
 
 	void VulkanInstance::Init()
 	{
+		VE_PROFILE_FUNCTION();
+
 		CreateInstance();
 		SetupDebugMessenger();
 
@@ -43,7 +69,19 @@ namespace VE
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
 		deviceFeatures.wideLines = VK_TRUE;
 		deviceFeatures.fillModeNonSolid = VK_TRUE;
-		m_LogicalDevice = CreateRef<VulkanLogicalDevice>( m_PhysicalDevice, deviceFeatures );
+
+		VkPhysicalDeviceVulkan12Features features12{};
+		features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		features12.timelineSemaphore = VK_TRUE;
+
+		auto& config = Renderer::GetConfig();
+		if ( config.Bindless && !VulkanBindlessTable::EnableFeatures( m_PhysicalDevice->GetVulkan12Features(), features12 ) )
+		{
+			VE_WARN( "descriptor indexing is not supported, bindless mode is disabled" );
+			config.Bindless = false;
+		}
+
+		m_LogicalDevice = CreateRef<VulkanLogicalDevice>( m_PhysicalDevice, deviceFeatures, features12, !m_Headless );
 	}
 
 	void VulkanInstance::CreateInstance()
@@ -87,11 +125,20 @@ namespace VE
 
 	std::vector<const char*> VulkanInstance::GetRequiredExtensions()
 	{
-		uint32_t glfwExtensionCount = 0;
-		const char** glfwExtensions;
-		glfwExtensions = glfwGetRequiredInstanceExtensions( &glfwExtensionCount );
+		std::vector<const char*> extensions;
 
-		std::vector<const char*> extensions( glfwExtensions, glfwExtensions + glfwExtensionCount );
+		if ( !m_Headless )
+		{
+#ifdef VE_PLATFORM_WINDOWS
+			uint32_t glfwExtensionCount = 0;
+			const char** glfwExtensions;
+			glfwExtensions = glfwGetRequiredInstanceExtensions( &glfwExtensionCount );
+
+			extensions.assign( glfwExtensions, glfwExtensions + glfwExtensionCount );
+#else
+			VE_ASSERT( false, "Only headless instances are supported on this platform!" );
+#endif
+		}
 
 		if ( s_EnableValidationLayers )
 		{
@@ -106,7 +153,10 @@ namespace VE
 	{
 		createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-		createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+		createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+		// The layer does not even build verbose messages unless they would be logged
+		if ( Log::ShouldLog( spdlog::level::trace ) )
+			createInfo.messageSeverity |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
 		createInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
 		createInfo.pfnUserCallback = DebugCallback;
 	}
@@ -8,7 +8,8 @@ namespace VE
 	class VulkanInstance
 	{
 	public:
-		VulkanInstance();
+		// A headless instance enables no surface extensions and the device it creates cannot present
+		VulkanInstance( bool headless = false );
 		~VulkanInstance();
 
 		void Init();
@@ -28,6 +29,11 @@ namespace VE
 			return s_Instance;
 		}
 
+		static Ref<VulkanLogicalDevice> GetCurrentDevice()
+		{
+			return s_Context->m_LogicalDevice;
+		}
+
 	private:
 		void CreateInstance();
 
@@ -42,6 +48,8 @@ namespace VE
 		Ref<VulkanLogicalDevice> m_LogicalDevice;
 
 		inline static VkInstance s_Instance;
+		inline static VulkanInstance* s_Context = nullptr;
 		VkDebugUtilsMessengerEXT m_DebugMessenger;
+		bool m_Headless = false;
 	};
 }
@@ -0,0 +1,102 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanMemoryBlockMetadata.h"
+
+namespace VE
+{
+
+	static bool IsPowerOfTwo( uint64_t value )
+	{
+		return value != 0 && ( value & ( value - 1 ) ) == 0;
+	}
+
+	static uint64_t NextPowerOfTwo( uint64_t value )
+	{
+		uint64_t result = 1;
+		while ( result < value )
+			result <<= 1;
+		return result;
+	}
+
+	VulkanMemoryBlockMetadata::VulkanMemoryBlockMetadata( uint64_t size, uint64_t minAllocationSize )
+		: m_Size( size ), m_MinAllocationSize( minAllocationSize )
+	{
+		VE_ASSERT( IsPowerOfTwo( size ) && IsPowerOfTwo( minAllocationSize ) && minAllocationSize <= size );
+
+		uint32_t levelCount = 1;
+		while ( GetLevelSize( levelCount - 1 ) > m_MinAllocationSize )
+			levelCount++;
+
+		m_FreeLists.resize( levelCount );
+		m_FreeLists[ 0 ].insert( 0 );
+	}
+
+	bool VulkanMemoryBlockMetadata::Allocate( uint64_t size, uint64_t alignment, uint64_t& outOffset )
+	{
+		const uint64_t rangeSize = std::max( NextPowerOfTwo( std::max( size, alignment ) ), m_MinAllocationSize );
+		if ( rangeSize > m_Size )
+			return false;
+
+		uint32_t targetLevel = 0;
+		while ( GetLevelSize( targetLevel ) > rangeSize )
+			targetLevel++;
+
+		// Smallest free range that fits, split down to the requested size
+		int32_t level = ( int32_t )targetLevel;
+		while ( level >= 0 && m_FreeLists[ level ].empty() )
+			level--;
+
+		if ( level < 0 )
+			return false;
+
+		uint64_t offset = *m_FreeLists[ level ].begin();
+		m_FreeLists[ level ].erase( m_FreeLists[ level ].begin() );
+
+		while ( ( uint32_t )level < targetLevel )
+		{
+			level++;
+			m_FreeLists[ level ].insert( offset + GetLevelSize( level ) );
+		}
+
+		m_Allocations[ offset ] = targetLevel;
+		m_UsedSize += rangeSize;
+
+		outOffset = offset;
+		return true;
+	}
+
+	void VulkanMemoryBlockMetadata::Free( uint64_t offset )
+	{
+		auto it = m_Allocations.find( offset );
+		VE_ASSERT( it != m_Allocations.end(), "Freeing an offset that was not allocated!" );
+
+		uint32_t level = it->second;
+		m_Allocations.erase( it );
+		m_UsedSize -= GetLevelSize( level );
+
+		// Merge with the buddy for as long as it is free as well
+		while ( level > 0 )
+		{
+			uint64_t buddy = offset ^ GetLevelSize( level );
+			auto buddyIt = m_FreeLists[ level ].find( buddy );
+			if ( buddyIt == m_FreeLists[ level ].end() )
+				break;
+
+			m_FreeLists[ level ].erase( buddyIt );
+			offset = std::min( offset, buddy );
+			level--;
+		}
+
+		m_FreeLists[ level ].insert( offset );
+	}
+
+	uint64_t VulkanMemoryBlockMetadata::GetLargestFreeRange() const
+	{
+		for ( uint32_t level = 0; level < m_FreeLists.size(); level++ )
+		{
+			if ( !m_FreeLists[ level ].empty() )
+				return GetLevelSize( level );
+		}
+		return 0;
+	}
+
+}
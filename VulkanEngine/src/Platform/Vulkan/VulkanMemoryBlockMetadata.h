@@ -0,0 +1,57 @@
+#pragma once
+
+#include <set>
+
+namespace VE
+{
+	// Buddy allocator bookkeeping for one device memory block. It only deals with offsets and never touches
+	// the device, so it can be driven without a GPU. Every range is a power of two aligned to its own size,
+	// which also satisfies any power of two alignment up to the range size.
+	class VulkanMemoryBlockMetadata
+	{
+	public:
+		VulkanMemoryBlockMetadata( uint64_t size, uint64_t minAllocationSize );
+
+		bool Allocate( uint64_t size, uint64_t alignment, uint64_t& outOffset );
+		void Free( uint64_t offset );
+
+		uint64_t GetSize() const
+		{
+			return m_Size;
+		}
+		// Bytes covered by allocated ranges, including the padding up to the next power of two
+		uint64_t GetUsedSize() const
+		{
+			return m_UsedSize;
+		}
+		uint64_t GetFreeSize() const
+		{
+			return m_Size - m_UsedSize;
+		}
+		uint32_t GetAllocationCount() const
+		{
+			return ( uint32_t )m_Allocations.size();
+		}
+		bool IsEmpty() const
+		{
+			return m_Allocations.empty();
+		}
+
+		uint64_t GetLargestFreeRange() const;
+
+	private:
+		uint64_t GetLevelSize( uint32_t level ) const
+		{
+			return m_Size >> level;
+		}
+
+	private:
+		uint64_t m_Size = 0;
+		uint64_t m_MinAllocationSize = 0;
+		uint64_t m_UsedSize = 0;
+
+		// Level 0 is the whole block, every level below halves the range size
+		std::vector<std::set<uint64_t>> m_FreeLists;
+		std::unordered_map<uint64_t, uint32_t> m_Allocations;
+	};
+}
@@ -0,0 +1,263 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanPipelineCache.h"
+
+#include "Platform/Vulkan/VulkanDevice.h"
+
+#include "Core/Timer.h"
+
+#include <sstream>
+#include <iomanip>
+
+namespace VE
+{
+
+	VulkanPipelineCache::VulkanPipelineCache( VulkanLogicalDevice* device, const std::filesystem::path& directory )
+		: m_Device( device )
+	{
+		const auto& physicalDevice = m_Device->GetPhysicalDevice();
+		const auto& properties = physicalDevice->GetProperties();
+		m_FeedbackSupported = physicalDevice->IsExtensionSupported( VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME );
+
+		std::stringstream fileName;
+		fileName << "pipelines_" << std::hex << std::setfill( '0' ) << std::setw( 4 ) << properties.vendorID << "_" << std::setw( 4 ) << properties.deviceID << "_"
+			<< std::setw( 8 ) << properties.driverVersion << ".bin";
+		m_Path = directory / fileName.str();
+
+		std::vector<uint8_t> data;
+		m_Warm = Load( data );
+
+		VkPipelineCacheCreateInfo cacheInfo{};
+		cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		cacheInfo.initialDataSize = m_Warm ? data.size() : 0;
+		cacheInfo.pInitialData = m_Warm ? data.data() : nullptr;
+		VK_CHECK_RESULT( vkCreatePipelineCache( m_Device->GetVulkanLogicalDevice(), &cacheInfo, nullptr, &m_Cache ) );
+	}
+
+	VulkanPipelineCache::~VulkanPipelineCache()
+	{
+		LogStatistics( "shutdown" );
+		Save();
+
+		VE_ASSERT( m_OutstandingCacheCount == 0, "Worker pipeline caches were not returned!" );
+
+		vkDestroyPipelineCache( m_Device->GetVulkanLogicalDevice(), m_Cache, nullptr );
+	}
+
+	VkPipelineCache VulkanPipelineCache::CreateWorkerCache()
+	{
+		VkPipelineCacheCreateInfo cacheInfo{};
+		cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+		VkPipelineCache cache;
+		VK_CHECK_RESULT( vkCreatePipelineCache( m_Device->GetVulkanLogicalDevice(), &cacheInfo, nullptr, &cache ) );
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_OutstandingCacheCount++;
+		return cache;
+	}
+
+	void VulkanPipelineCache::ReturnWorkerCache( VkPipelineCache cache )
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		VE_ASSERT( m_OutstandingCacheCount > 0, "Returned a pipeline cache that was not handed out!" );
+		m_OutstandingCacheCount--;
+		m_ReturnedCaches.push_back( cache );
+	}
+
+	void VulkanPipelineCache::MergeWorkerCaches()
+	{
+		std::vector<VkPipelineCache> caches;
+		{
+			std::lock_guard<std::mutex> lock( m_Mutex );
+			caches.swap( m_ReturnedCaches );
+		}
+		if ( caches.empty() )
+			return;
+
+		VkDevice device = m_Device->GetVulkanLogicalDevice();
+		{
+			std::unique_lock<std::shared_mutex> lock( m_CacheMutex );
+			VK_CHECK_RESULT( vkMergePipelineCaches( device, m_Cache, ( uint32_t )caches.size(), caches.data() ) );
+		}
+
+		for ( auto cache : caches )
+		{
+			vkDestroyPipelineCache( device, cache, nullptr );
+		}
+	}
+
+	VkPipeline VulkanPipelineCache::CreateGraphicsPipeline( const VkGraphicsPipelineCreateInfo& createInfo, VkPipelineCache cache )
+	{
+		VkPipelineCreationFeedbackEXT feedback{};
+		std::vector<VkPipelineCreationFeedbackEXT> stageFeedbacks( createInfo.stageCount );
+
+		VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{};
+		feedbackInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+		feedbackInfo.pPipelineCreationFeedback = &feedback;
+		feedbackInfo.pipelineStageCreationFeedbackCount = createInfo.stageCount;
+		feedbackInfo.pPipelineStageCreationFeedbacks = stageFeedbacks.data();
+
+		VkGraphicsPipelineCreateInfo info = createInfo;
+		if ( m_FeedbackSupported )
+		{
+			feedbackInfo.pNext = info.pNext;
+			info.pNext = &feedbackInfo;
+		}
+
+		// Worker caches belong to the calling thread, only the shared one can be merged into meanwhile
+		std::shared_lock<std::shared_mutex> lock( m_CacheMutex, std::defer_lock );
+		if ( !cache )
+			lock.lock();
+
+		Timer timer;
+		VkPipeline pipeline;
+		VK_CHECK_RESULT( vkCreateGraphicsPipelines( m_Device->GetVulkanLogicalDevice(), cache ? cache : m_Cache, 1, &info, nullptr, &pipeline ) );
+		RecordCreation( timer.ElapsedMillis(), feedback );
+
+		return pipeline;
+	}
+
+	VkPipeline VulkanPipelineCache::CreateComputePipeline( const VkComputePipelineCreateInfo& createInfo, VkPipelineCache cache )
+	{
+		VkPipelineCreationFeedbackEXT feedback{};
+		VkPipelineCreationFeedbackEXT stageFeedback{};
+
+		VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{};
+		feedbackInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+		feedbackInfo.pPipelineCreationFeedback = &feedback;
+		feedbackInfo.pipelineStageCreationFeedbackCount = 1;
+		feedbackInfo.pPipelineStageCreationFeedbacks = &stageFeedback;
+
+		VkComputePipelineCreateInfo info = createInfo;
+		if ( m_FeedbackSupported )
+		{
+			feedbackInfo.pNext = info.pNext;
+			info.pNext = &feedbackInfo;
+		}
+
+		std::shared_lock<std::shared_mutex> lock( m_CacheMutex, std::defer_lock );
+		if ( !cache )
+			lock.lock();
+
+		Timer timer;
+		VkPipeline pipeline;
+		VK_CHECK_RESULT( vkCreateComputePipelines( m_Device->GetVulkanLogicalDevice(), cache ? cache : m_Cache, 1, &info, nullptr, &pipeline ) );
+		RecordCreation( timer.ElapsedMillis(), feedback );
+
+		return pipeline;
+	}
+
+	void VulkanPipelineCache::Save()
+	{
+		MergeWorkerCaches();
+
+		VkDevice device = m_Device->GetVulkanLogicalDevice();
+
+		size_t size = 0;
+		VK_CHECK_RESULT( vkGetPipelineCacheData( device, m_Cache, &size, nullptr ) );
+		if ( size == 0 )
+			return;
+
+		std::vector<uint8_t> data( size );
+		VK_CHECK_RESULT( vkGetPipelineCacheData( device, m_Cache, &size, data.data() ) );
+
+		std::error_code error;
+		std::filesystem::create_directories( m_Path.parent_path(), error );
+
+		// Written next to the real file and then renamed over it, so an interrupted write never leaves a
+		// truncated cache behind
+		std::filesystem::path temporaryPath = m_Path;
+		temporaryPath += ".tmp";
+		{
+			std::ofstream stream( temporaryPath, std::ios::binary | std::ios::trunc );
+			if ( !stream )
+			{
+				VE_WARN( "pipeline cache: could not write {0}", temporaryPath.string() );
+				return;
+			}
+			stream.write( ( const char* )data.data(), size );
+		}
+
+		std::filesystem::rename( temporaryPath, m_Path, error );
+		if ( error )
+		{
+			VE_WARN( "pipeline cache: could not replace {0}: {1}", m_Path.string(), error.message() );
+			return;
+		}
+
+		VE_TRACE( "pipeline cache: saved {0} bytes to {1}", size, m_Path.string() );
+	}
+
+	void VulkanPipelineCache::LogStatistics( const char* when ) const
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		const auto& statistics = m_Statistics;
+		uint32_t count = statistics.HitCount + statistics.MissCount;
+		if ( count == 0 )
+			return;
+
+		VE_INFO( "pipeline cache ({0}): {1} pipelines created in {2:.2f}ms ({3} start)", when, count, statistics.HitTime + statistics.MissTime, m_Warm ? "warm" : "cold" );
+		VE_INFO( "  cached:   {0} in {1:.2f}ms", statistics.HitCount, statistics.HitTime );
+		VE_INFO( "  compiled: {0} in {1:.2f}ms", statistics.MissCount, statistics.MissTime );
+	}
+
+	bool VulkanPipelineCache::Load( std::vector<uint8_t>& outData )
+	{
+		std::ifstream stream( m_Path, std::ios::binary | std::ios::ate );
+		if ( !stream )
+		{
+			VE_INFO( "pipeline cache: no cache at {0}, starting cold", m_Path.string() );
+			return false;
+		}
+
+		outData.resize( ( size_t )stream.tellg() );
+		stream.seekg( 0 );
+		stream.read( ( char* )outData.data(), outData.size() );
+
+		if ( !IsHeaderValid( outData ) )
+		{
+			VE_WARN( "pipeline cache: {0} does not match this device, starting cold", m_Path.string() );
+			return false;
+		}
+
+		VE_INFO( "pipeline cache: loaded {0} bytes from {1}", outData.size(), m_Path.string() );
+		return true;
+	}
+
+	bool VulkanPipelineCache::IsHeaderValid( const std::vector<uint8_t>& data ) const
+	{
+		VkPipelineCacheHeaderVersionOne header;
+		if ( data.size() < sizeof( header ) )
+			return false;
+
+		memcpy( &header, data.data(), sizeof( header ) );
+
+		const auto& properties = m_Device->GetPhysicalDevice()->GetProperties();
+		return header.headerSize >= sizeof( header ) && header.headerSize <= data.size()
+			&& header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+			&& header.vendorID == properties.vendorID
+			&& header.deviceID == properties.deviceID
+			&& memcmp( header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE ) == 0;
+	}
+
+	void VulkanPipelineCache::RecordCreation( float milliseconds, const VkPipelineCreationFeedbackEXT& feedback )
+	{
+		bool hit = m_Warm;
+		if ( feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT )
+			hit = feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT;
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		if ( hit )
+		{
+			m_Statistics.HitCount++;
+			m_Statistics.HitTime += milliseconds;
+		}
+		else
+		{
+			m_Statistics.MissCount++;
+			m_Statistics.MissTime += milliseconds;
+		}
+	}
+
+}
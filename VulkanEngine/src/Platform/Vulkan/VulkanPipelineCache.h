@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+
+namespace VE
+{
+	class VulkanLogicalDevice;
+
+	// Persists the driver's compiled pipelines between runs. The cache file is keyed by vendor, device and
+	// driver version, and its header is validated against the device before the data is handed to the
+	// driver, so a driver update or a different GPU simply starts from an empty cache.
+	class VulkanPipelineCache
+	{
+	public:
+		VulkanPipelineCache( VulkanLogicalDevice* device, const std::filesystem::path& directory = "cache" );
+		~VulkanPipelineCache();
+
+		VkPipelineCache GetCache() const
+		{
+			return m_Cache;
+		}
+
+		// Threads that build many pipelines can record into a cache of their own, avoiding contention on the
+		// shared one. The owner hands it back with ReturnWorkerCache once it is done creating pipelines with it,
+		// and MergeWorkerCaches folds every returned cache into the shared one and destroys it.
+		VkPipelineCache CreateWorkerCache();
+		void ReturnWorkerCache( VkPipelineCache cache );
+		void MergeWorkerCaches();
+
+		// Creation goes through these so hits and misses can be timed. cache defaults to the shared cache.
+		VkPipeline CreateGraphicsPipeline( const VkGraphicsPipelineCreateInfo& createInfo, VkPipelineCache cache = VK_NULL_HANDLE );
+		VkPipeline CreateComputePipeline( const VkComputePipelineCreateInfo& createInfo, VkPipelineCache cache = VK_NULL_HANDLE );
+
+		void Save();
+		// Cached against compiled creation count and time so far, when says at which point they were taken
+		void LogStatistics( const char* when ) const;
+
+	private:
+		bool Load( std::vector<uint8_t>& outData );
+		bool IsHeaderValid( const std::vector<uint8_t>& data ) const;
+		void RecordCreation( float milliseconds, const VkPipelineCreationFeedbackEXT& feedback );
+
+	private:
+		VulkanLogicalDevice* m_Device;
+		VkPipelineCache m_Cache = nullptr;
+		std::filesystem::path m_Path;
+
+		// Without creation feedback every pipeline is counted as a hit when the cache was loaded from disk
+		bool m_Warm = false;
+		bool m_FeedbackSupported = false;
+
+		std::vector<VkPipelineCache> m_ReturnedCaches;
+		uint32_t m_OutstandingCacheCount = 0;
+
+		// Merging writes m_Cache, which the driver requires to be externally synchronized against creation
+		std::shared_mutex m_CacheMutex;
+
+		struct Statistics
+		{
+			uint32_t HitCount = 0;
+			uint32_t MissCount = 0;
+			float HitTime = 0.0f;
+			float MissTime = 0.0f;
+		} m_Statistics;
+
+		mutable std::mutex m_Mutex;
+	};
+}
@@ -0,0 +1,1216 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanRenderGraph.h"
+
+#include "Platform/Vulkan/VulkanDevice.h"
+#include "Platform/Vulkan/VulkanResourceRelease.h"
+
+#include "Core/Hash.h"
+
+#include <sstream>
+
+namespace VE
+{
+	static constexpr VkAccessFlags s_WriteAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+	struct RenderGraphAccessInfo
+	{
+		VkImageLayout Layout;
+		VkPipelineStageFlags Stages;
+		VkAccessFlags Access;
+		VkImageUsageFlags Usage;
+		bool Write;
+		bool Attachment;
+	};
+
+	static RenderGraphAccessInfo GetAccessInfo( RenderGraphAccess access, bool graphics )
+	{
+		VkPipelineStageFlags shaderStage = graphics ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		VkPipelineStageFlags depthStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+		switch ( access )
+		{
+			case RenderGraphAccess::ColorAttachment:
+				return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+					VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true, true };
+			case RenderGraphAccess::DepthStencilAttachment:
+				return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, depthStages,
+					VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, true, true };
+			case RenderGraphAccess::DepthStencilReadOnly:
+				return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, depthStages,
+					VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, false, true };
+			case RenderGraphAccess::Sampled:
+				return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, shaderStage, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_USAGE_SAMPLED_BIT, false, false };
+			case RenderGraphAccess::StorageRead:
+				return { VK_IMAGE_LAYOUT_GENERAL, shaderStage, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_USAGE_STORAGE_BIT, false, false };
+			case RenderGraphAccess::StorageWrite:
+				return { VK_IMAGE_LAYOUT_GENERAL, shaderStage, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_USAGE_STORAGE_BIT, true, false };
+		}
+
+		VE_ASSERT( false );
+		return {};
+	}
+
+	static bool IsDepthFormat( VkFormat format )
+	{
+		switch ( format )
+		{
+			case VK_FORMAT_D16_UNORM:
+			case VK_FORMAT_X8_D24_UNORM_PACK32:
+			case VK_FORMAT_D32_SFLOAT:
+			case VK_FORMAT_D16_UNORM_S8_UINT:
+			case VK_FORMAT_D24_UNORM_S8_UINT:
+			case VK_FORMAT_D32_SFLOAT_S8_UINT:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	static bool HasStencil( VkFormat format )
+	{
+		return format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+	}
+
+	static VkImageAspectFlags GetAspectMask( VkFormat format )
+	{
+		if ( !IsDepthFormat( format ) )
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+
+		return HasStencil( format ) ? VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
+	}
+
+	static const char* LayoutToString( VkImageLayout layout )
+	{
+		switch ( layout )
+		{
+			case VK_IMAGE_LAYOUT_UNDEFINED:
+				return "UNDEFINED";
+			case VK_IMAGE_LAYOUT_GENERAL:
+				return "GENERAL";
+			case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+				return "COLOR_ATTACHMENT";
+			case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+				return "DEPTH_STENCIL_ATTACHMENT";
+			case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+				return "DEPTH_STENCIL_READ_ONLY";
+			case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+				return "SHADER_READ_ONLY";
+			case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+				return "TRANSFER_SRC";
+			case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+				return "TRANSFER_DST";
+			case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+				return "PRESENT_SRC";
+			default:
+				return "OTHER";
+		}
+	}
+
+	static const char* LoadOpToString( VkAttachmentLoadOp loadOp )
+	{
+		switch ( loadOp )
+		{
+			case VK_ATTACHMENT_LOAD_OP_LOAD:
+				return "load";
+			case VK_ATTACHMENT_LOAD_OP_CLEAR:
+				return "clear";
+			default:
+				return "dont care";
+		}
+	}
+
+	void VulkanRenderGraphPass::WriteColor( RenderGraphResource resource, RenderGraphLoadOp loadOp, const VkClearColorValue& clearValue )
+	{
+		VE_ASSERT( m_Graphics, "Attachments can only be written by graphics passes!" );
+
+		VkClearValue value{};
+		value.color = clearValue;
+		AddUse( resource, RenderGraphAccess::ColorAttachment, loadOp, value );
+	}
+
+	void VulkanRenderGraphPass::WriteDepthStencil( RenderGraphResource resource, RenderGraphLoadOp loadOp, const VkClearDepthStencilValue& clearValue )
+	{
+		VE_ASSERT( m_Graphics, "Attachments can only be written by graphics passes!" );
+
+		VkClearValue value{};
+		value.depthStencil = clearValue;
+		AddUse( resource, RenderGraphAccess::DepthStencilAttachment, loadOp, value );
+	}
+
+	void VulkanRenderGraphPass::ReadDepthStencil( RenderGraphResource resource )
+	{
+		VE_ASSERT( m_Graphics, "Attachments can only be read by graphics passes!" );
+		AddUse( resource, RenderGraphAccess::DepthStencilReadOnly, RenderGraphLoadOp::Load, {} );
+	}
+
+	void VulkanRenderGraphPass::ReadTexture( RenderGraphResource resource )
+	{
+		AddUse( resource, RenderGraphAccess::Sampled, RenderGraphLoadOp::Load, {} );
+	}
+
+	void VulkanRenderGraphPass::ReadStorage( RenderGraphResource resource )
+	{
+		AddUse( resource, RenderGraphAccess::StorageRead, RenderGraphLoadOp::Load, {} );
+	}
+
+	void VulkanRenderGraphPass::WriteStorage( RenderGraphResource resource )
+	{
+		// Storage writes may be partial, so the previous contents always count as read
+		AddUse( resource, RenderGraphAccess::StorageWrite, RenderGraphLoadOp::Load, {} );
+	}
+
+	void VulkanRenderGraphPass::AddUse( RenderGraphResource resource, RenderGraphAccess access, RenderGraphLoadOp loadOp, const VkClearValue& clearValue )
+	{
+		for ( const auto& use : m_Uses )
+		{
+			VE_ASSERT( use.Resource != resource, "A pass can only use a render graph resource once!" );
+		}
+
+		m_Uses.push_back( { resource, access, loadOp, clearValue } );
+	}
+
+	VulkanRenderGraph::VulkanRenderGraph( VulkanLogicalDevice* device )
+		: m_Device( device )
+	{
+	}
+
+	VulkanRenderGraph::~VulkanRenderGraph()
+	{
+		// Owners destroy the graph once the device is idle
+		ReleaseCompiled( true );
+
+		if ( !m_Device )
+			return;
+
+		for ( auto& [key, renderPass] : m_RenderPasses )
+		{
+			vkDestroyRenderPass( m_Device->GetVulkanLogicalDevice(), renderPass.RenderPass, nullptr );
+		}
+	}
+
+	RenderGraphResource VulkanRenderGraph::CreateTexture( const std::string& name, const RenderGraphTextureDesc& desc )
+	{
+		VE_ASSERT( desc.Width > 0 && desc.Height > 0 && desc.Format != VK_FORMAT_UNDEFINED );
+
+		Resource& resource = m_Resources.emplace_back();
+		resource.Name = name;
+		resource.Desc = desc;
+		return ( RenderGraphResource )m_Resources.size() - 1;
+	}
+
+	RenderGraphResource VulkanRenderGraph::ImportTexture( const std::string& name, const RenderGraphTextureDesc& desc, VkImageLayout initialLayout, VkImageLayout finalLayout )
+	{
+		RenderGraphResource handle = CreateTexture( name, desc );
+
+		Resource& resource = m_Resources[ handle ];
+		resource.Imported = true;
+		resource.InitialLayout = initialLayout;
+		resource.FinalLayout = finalLayout;
+		return handle;
+	}
+
+	void VulkanRenderGraph::SetImportedTexture( RenderGraphResource resource, VkImage image, VkImageView imageView )
+	{
+		VE_ASSERT( resource < m_Resources.size() && m_Resources[ resource ].Imported );
+
+		m_Resources[ resource ].Image = image;
+		m_Resources[ resource ].ImageView = imageView;
+	}
+
+	void VulkanRenderGraph::MarkOutput( RenderGraphResource resource )
+	{
+		VE_ASSERT( resource < m_Resources.size() );
+		m_Resources[ resource ].Output = true;
+	}
+
+	VulkanRenderGraphPass& VulkanRenderGraph::AddGraphicsPass( const std::string& name )
+	{
+		return AddPass( name, true );
+	}
+
+	VulkanRenderGraphPass& VulkanRenderGraph::AddComputePass( const std::string& name )
+	{
+		return AddPass( name, false );
+	}
+
+	VulkanRenderGraphPass& VulkanRenderGraph::AddPass( const std::string& name, bool graphics )
+	{
+		VE_ASSERT( !m_Compiled, "Passes cannot be added to a compiled render graph!" );
+
+		m_Passes.push_back( Scope<VulkanRenderGraphPass>( new VulkanRenderGraphPass( name, graphics ) ) );
+		return *m_Passes.back();
+	}
+
+	void VulkanRenderGraph::Compile()
+	{
+		// Recompiling, e.g. after a resize, replaces every object of the previous compilation
+		ReleaseCompiled( false );
+
+		m_Statistics = {};
+		m_Statistics.PassCount = ( uint32_t )m_Passes.size();
+
+		for ( auto& [key, renderPass] : m_RenderPasses )
+		{
+			renderPass.Used = false;
+		}
+
+		CullPasses();
+		BuildGroups();
+		CreateResources();
+		AliasResources();
+		BuildBarriers();
+		ReleaseUnusedRenderPasses();
+
+		m_Compiled = true;
+
+		VE_TRACE( "render graph: {0} passes ({1} culled) in {2} render passes ({3} reused), {4} barriers, transient memory {5}KB aliased into {6}KB",
+			m_Statistics.PassCount, m_Statistics.CulledPassCount, m_Statistics.RenderPassCount, m_Statistics.ReusedRenderPassCount,
+			m_Statistics.ImageBarrierCount, m_Statistics.TransientBytes / 1024, m_Statistics.AllocatedBytes / 1024 );
+	}
+
+	void VulkanRenderGraph::CullPasses()
+	{
+		// Walks the passes backwards from the imported and output textures. Writing a texture that is later
+		// overwritten without being read keeps nothing alive.
+		std::vector<bool> needed( m_Resources.size() );
+		for ( size_t i = 0; i < m_Resources.size(); i++ )
+		{
+			needed[ i ] = m_Resources[ i ].Imported || m_Resources[ i ].Output;
+		}
+
+		for ( auto it = m_Passes.rbegin(); it != m_Passes.rend(); ++it )
+		{
+			VulkanRenderGraphPass& pass = **it;
+			pass.m_Group = UINT32_MAX;
+
+			bool alive = pass.m_SideEffects;
+			for ( const auto& use : pass.m_Uses )
+			{
+				VE_ASSERT( use.Resource < m_Resources.size() );
+				if ( GetAccessInfo( use.Access, pass.m_Graphics ).Write && needed[ use.Resource ] )
+					alive = true;
+			}
+
+			pass.m_Culled = !alive;
+			if ( !alive )
+			{
+				m_Statistics.CulledPassCount++;
+				continue;
+			}
+
+			for ( const auto& use : pass.m_Uses )
+			{
+				bool write = GetAccessInfo( use.Access, pass.m_Graphics ).Write;
+				needed[ use.Resource ] = !write || use.LoadOp == RenderGraphLoadOp::Load;
+			}
+		}
+	}
+
+	void VulkanRenderGraph::BuildGroups()
+	{
+		// Two uses of a texture within one render pass are only allowed when both are attachments, so subpass
+		// dependencies cover them, or both read the texture in the same layout
+		auto canShare = []( const RenderGraphAccessInfo& a, const RenderGraphAccessInfo& b )
+		{
+			if ( a.Attachment && b.Attachment )
+				return true;
+
+			return !a.Write && !b.Write && a.Layout == b.Layout;
+		};
+
+		std::vector<bool> written( m_Resources.size() );
+
+		for ( uint32_t passIndex = 0; passIndex < m_Passes.size(); passIndex++ )
+		{
+			VulkanRenderGraphPass& pass = *m_Passes[ passIndex ];
+			if ( pass.m_Culled )
+				continue;
+
+			uint32_t width = 0, height = 0;
+			for ( const auto& use : pass.m_Uses )
+			{
+				const Resource& resource = m_Resources[ use.Resource ];
+				RenderGraphAccessInfo info = GetAccessInfo( use.Access, pass.m_Graphics );
+
+				bool reads = !info.Write || use.LoadOp == RenderGraphLoadOp::Load;
+				VE_ASSERT( !reads || written[ use.Resource ] || resource.Imported || use.Access == RenderGraphAccess::StorageWrite,
+					"Render graph pass reads a texture that no earlier pass wrote!" );
+
+				if ( info.Attachment )
+				{
+					VE_ASSERT( width == 0 || ( width == resource.Desc.Width && height == resource.Desc.Height ), "Attachments of a pass must have the same size!" );
+					width = resource.Desc.Width;
+					height = resource.Desc.Height;
+				}
+			}
+			VE_ASSERT( !pass.m_Graphics || width > 0, "Graphics passes need at least one attachment!" );
+
+			bool merge = false;
+			if ( pass.m_Graphics && !m_Groups.empty() && m_Groups.back().Graphics && m_Groups.back().Width == width && m_Groups.back().Height == height )
+			{
+				merge = true;
+				for ( uint32_t groupPass : m_Groups.back().Passes )
+				{
+					const VulkanRenderGraphPass& other = *m_Passes[ groupPass ];
+					for ( const auto& otherUse : other.m_Uses )
+					{
+						for ( const auto& use : pass.m_Uses )
+						{
+							if ( use.Resource == otherUse.Resource && !canShare( GetAccessInfo( use.Access, true ), GetAccessInfo( otherUse.Access, true ) ) )
+								merge = false;
+						}
+					}
+				}
+			}
+
+			if ( !merge )
+			{
+				Group& group = m_Groups.emplace_back();
+				group.Graphics = pass.m_Graphics;
+				group.Width = width;
+				group.Height = height;
+			}
+			else
+			{
+				m_Statistics.MergedPassCount++;
+			}
+
+			uint32_t groupIndex = ( uint32_t )m_Groups.size() - 1;
+			m_Groups.back().Passes.push_back( passIndex );
+			m_Groups.back().Name += ( merge ? " + " : "" ) + pass.m_Name;
+			pass.m_Group = groupIndex;
+
+			for ( const auto& use : pass.m_Uses )
+			{
+				Resource& resource = m_Resources[ use.Resource ];
+				resource.FirstGroup = std::min( resource.FirstGroup, groupIndex );
+				resource.LastGroup = groupIndex;
+				resource.Usage |= GetAccessInfo( use.Access, pass.m_Graphics ).Usage;
+
+				if ( GetAccessInfo( use.Access, pass.m_Graphics ).Write )
+					written[ use.Resource ] = true;
+			}
+		}
+
+		for ( const auto& group : m_Groups )
+		{
+			if ( group.Graphics )
+				m_Statistics.RenderPassCount++;
+		}
+	}
+
+	void VulkanRenderGraph::CreateResources()
+	{
+		for ( auto& resource : m_Resources )
+		{
+			// Imported textures are owned elsewhere and textures only used by culled passes are never created
+			if ( resource.Imported || resource.FirstGroup == UINT32_MAX )
+				continue;
+
+			m_Statistics.TransientCount++;
+
+			if ( !m_Device )
+			{
+				resource.Requirements = EstimateRequirements( resource.Desc );
+				m_Statistics.TransientBytes += resource.Requirements.size;
+				continue;
+			}
+
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.format = resource.Desc.Format;
+			imageInfo.extent = { resource.Desc.Width, resource.Desc.Height, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.samples = resource.Desc.Samples;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.usage = resource.Usage;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			VkDevice device = m_Device->GetVulkanLogicalDevice();
+			VK_CHECK_RESULT( vkCreateImage( device, &imageInfo, nullptr, &resource.Image ) );
+			vkGetImageMemoryRequirements( device, resource.Image, &resource.Requirements );
+
+			m_Statistics.TransientBytes += resource.Requirements.size;
+		}
+	}
+
+	VkMemoryRequirements VulkanRenderGraph::EstimateRequirements( const RenderGraphTextureDesc& desc ) const
+	{
+		// Roughly what drivers report for optimal tiling render targets: tightly packed texels in 64KB pages
+		static constexpr VkDeviceSize pageSize = 64 * 1024;
+
+		VkDeviceSize texelSize = 4;
+		switch ( desc.Format )
+		{
+			case VK_FORMAT_R8_UNORM:
+				texelSize = 1;
+				break;
+			case VK_FORMAT_D16_UNORM:
+			case VK_FORMAT_R16_SFLOAT:
+				texelSize = 2;
+				break;
+			case VK_FORMAT_R16G16B16A16_SFLOAT:
+			case VK_FORMAT_R16G16B16A16_UNORM:
+			case VK_FORMAT_R32G32_SFLOAT:
+			case VK_FORMAT_D32_SFLOAT_S8_UINT:
+				texelSize = 8;
+				break;
+			case VK_FORMAT_R32G32B32A32_SFLOAT:
+				texelSize = 16;
+				break;
+			default:
+				break;
+		}
+
+		VkMemoryRequirements requirements{};
+		requirements.size = ( ( VkDeviceSize )desc.Width * desc.Height * desc.Samples * texelSize + pageSize - 1 ) / pageSize * pageSize;
+		requirements.alignment = pageSize;
+		requirements.memoryTypeBits = ~0u;
+		return requirements;
+	}
+
+	void VulkanRenderGraph::AliasResources()
+	{
+		std::vector<RenderGraphResource> transients;
+		for ( RenderGraphResource i = 0; i < m_Resources.size(); i++ )
+		{
+			if ( !m_Resources[ i ].Imported && m_Resources[ i ].FirstGroup != UINT32_MAX )
+				transients.push_back( i );
+		}
+
+		// Largest first, so each bucket is sized by its first texture and smaller ones fill in around it
+		std::sort( transients.begin(), transients.end(), [this]( RenderGraphResource a, RenderGraphResource b )
+			{
+				return m_Resources[ a ].Requirements.size > m_Resources[ b ].Requirements.size;
+			} );
+
+		for ( RenderGraphResource handle : transients )
+		{
+			Resource& resource = m_Resources[ handle ];
+			const VkMemoryRequirements& requirements = resource.Requirements;
+
+			int32_t bucketIndex = -1;
+			for ( int32_t i = 0; i < ( int32_t )m_Buckets.size() && bucketIndex < 0; i++ )
+			{
+				MemoryBucket& bucket = m_Buckets[ i ];
+				if ( requirements.size > bucket.Size || !( requirements.memoryTypeBits & bucket.MemoryTypeBits ) )
+					continue;
+
+				bool overlaps = false;
+				for ( RenderGraphResource other : bucket.Resources )
+				{
+					const Resource& otherResource = m_Resources[ other ];
+					if ( resource.FirstGroup <= otherResource.LastGroup && otherResource.FirstGroup <= resource.LastGroup )
+						overlaps = true;
+				}
+
+				if ( !overlaps )
+					bucketIndex = i;
+			}
+
+			if ( bucketIndex < 0 )
+			{
+				bucketIndex = ( int32_t )m_Buckets.size();
+				MemoryBucket& bucket = m_Buckets.emplace_back();
+				bucket.Size = requirements.size;
+				bucket.Alignment = requirements.alignment;
+				bucket.MemoryTypeBits = requirements.memoryTypeBits;
+			}
+
+			MemoryBucket& bucket = m_Buckets[ bucketIndex ];
+			bucket.Alignment = std::max( bucket.Alignment, requirements.alignment );
+			bucket.MemoryTypeBits &= requirements.memoryTypeBits;
+			bucket.Resources.push_back( handle );
+			resource.Bucket = bucketIndex;
+		}
+
+		for ( auto& bucket : m_Buckets )
+		{
+			std::sort( bucket.Resources.begin(), bucket.Resources.end(), [this]( RenderGraphResource a, RenderGraphResource b )
+				{
+					return m_Resources[ a ].FirstGroup < m_Resources[ b ].FirstGroup;
+				} );
+
+			m_Statistics.AllocationCount++;
+			m_Statistics.AllocatedBytes += bucket.Size;
+
+			if ( !m_Device )
+				continue;
+
+			VkMemoryRequirements requirements{};
+			requirements.size = bucket.Size;
+			requirements.alignment = bucket.Alignment;
+			requirements.memoryTypeBits = bucket.MemoryTypeBits;
+			bucket.Allocation = m_Device->GetAllocator().AllocateMemory( requirements, VulkanMemoryUsage::GPUOnly, false );
+
+			VkDevice device = m_Device->GetVulkanLogicalDevice();
+
+			for ( RenderGraphResource handle : bucket.Resources )
+			{
+				Resource& resource = m_Resources[ handle ];
+				VK_CHECK_RESULT( vkBindImageMemory( device, resource.Image, bucket.Allocation->Memory, bucket.Allocation->Offset ) );
+
+				VkImageViewCreateInfo viewInfo{};
+				viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+				viewInfo.image = resource.Image;
+				viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+				viewInfo.format = resource.Desc.Format;
+				viewInfo.subresourceRange.aspectMask = GetAspectMask( resource.Desc.Format );
+				viewInfo.subresourceRange.levelCount = 1;
+				viewInfo.subresourceRange.layerCount = 1;
+
+				VK_CHECK_RESULT( vkCreateImageView( device, &viewInfo, nullptr, &resource.ImageView ) );
+			}
+		}
+	}
+
+	void VulkanRenderGraph::BuildBarriers()
+	{
+		// Stages and accesses of the last group that used each texture
+		std::vector<ResourceState> lastUse( m_Resources.size() );
+		std::vector<uint32_t> lastUseGroup( m_Resources.size(), UINT32_MAX );
+		for ( const auto& pass : m_Passes )
+		{
+			if ( pass->m_Culled )
+				continue;
+
+			for ( const auto& use : pass->m_Uses )
+			{
+				RenderGraphAccessInfo info = GetAccessInfo( use.Access, pass->m_Graphics );
+				ResourceState& state = lastUse[ use.Resource ];
+				if ( lastUseGroup[ use.Resource ] != pass->m_Group )
+					state = {};
+
+				state.Stages |= info.Stages;
+				state.Access |= info.Access;
+				lastUseGroup[ use.Resource ] = pass->m_Group;
+			}
+		}
+
+		std::vector<ResourceState> states( m_Resources.size() );
+		for ( RenderGraphResource i = 0; i < m_Resources.size(); i++ )
+		{
+			const Resource& resource = m_Resources[ i ];
+			if ( resource.Imported )
+			{
+				// Whatever touched the texture before the graph is not known, so its first use waits on everything
+				states[ i ] = { resource.InitialLayout, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_WRITE_BIT };
+			}
+		}
+		for ( const auto& bucket : m_Buckets )
+		{
+			// A transient texture starts where the previous texture in its memory ended. The first one follows the
+			// last one of the previous frame, which was submitted to the same queue.
+			for ( size_t i = 0; i < bucket.Resources.size(); i++ )
+			{
+				RenderGraphResource previous = bucket.Resources[ i > 0 ? i - 1 : bucket.Resources.size() - 1 ];
+				states[ bucket.Resources[ i ] ] = { VK_IMAGE_LAYOUT_UNDEFINED, lastUse[ previous ].Stages, lastUse[ previous ].Access & s_WriteAccess };
+			}
+		}
+
+		for ( uint32_t groupIndex = 0; groupIndex < m_Groups.size(); groupIndex++ )
+		{
+			Group& group = m_Groups[ groupIndex ];
+
+			// Textures used outside attachments are transitioned before the render pass begins. Reads of the same
+			// texture in several subpasses are combined, merging never puts conflicting uses into one group.
+			std::vector<RenderGraphResource> order;
+			std::unordered_map<RenderGraphResource, RenderGraphAccessInfo> uses;
+			for ( uint32_t passIndex : group.Passes )
+			{
+				const VulkanRenderGraphPass& pass = *m_Passes[ passIndex ];
+				for ( const auto& use : pass.m_Uses )
+				{
+					RenderGraphAccessInfo info = GetAccessInfo( use.Access, pass.m_Graphics );
+					if ( info.Attachment )
+						continue;
+
+					m_Statistics.UntrackedBarrierCount++;
+
+					auto it = uses.find( use.Resource );
+					if ( it == uses.end() )
+					{
+						uses[ use.Resource ] = info;
+						order.push_back( use.Resource );
+					}
+					else
+					{
+						it->second.Stages |= info.Stages;
+						it->second.Access |= info.Access;
+					}
+				}
+			}
+
+			for ( RenderGraphResource resource : order )
+			{
+				const RenderGraphAccessInfo& info = uses[ resource ];
+				ResourceState& state = states[ resource ];
+
+				bool hazard = ( state.Access & s_WriteAccess ) || ( info.Write && state.Stages );
+				if ( state.Layout == info.Layout && !hazard )
+				{
+					// Read after read: later writers have to wait for these readers as well
+					state.Stages |= info.Stages;
+					state.Access |= info.Access;
+					continue;
+				}
+
+				group.Barriers.SrcStages |= state.Stages ? state.Stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+				group.Barriers.DstStages |= info.Stages;
+				group.Barriers.Barriers.push_back( { resource, state.Layout, info.Layout, state.Access & s_WriteAccess, info.Access } );
+
+				state = { info.Layout, info.Stages, info.Access };
+			}
+
+			if ( !group.Barriers.Barriers.empty() )
+			{
+				m_Statistics.PipelineBarrierCount++;
+				m_Statistics.ImageBarrierCount += ( uint32_t )group.Barriers.Barriers.size();
+			}
+
+			if ( group.Graphics )
+				CreateRenderPass( group, states );
+		}
+
+		for ( RenderGraphResource i = 0; i < m_Resources.size(); i++ )
+		{
+			const Resource& resource = m_Resources[ i ];
+			const ResourceState& state = states[ i ];
+			if ( !resource.Imported || resource.FinalLayout == VK_IMAGE_LAYOUT_UNDEFINED || resource.FinalLayout == state.Layout )
+				continue;
+
+			// Whoever uses the texture after the graph synchronizes with the end of the command buffer
+			m_FinalBarriers.SrcStages |= state.Stages ? state.Stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			m_FinalBarriers.DstStages |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			m_FinalBarriers.Barriers.push_back( { i, state.Layout, resource.FinalLayout, state.Access & s_WriteAccess, 0 } );
+		}
+
+		if ( !m_FinalBarriers.Barriers.empty() )
+		{
+			m_Statistics.PipelineBarrierCount++;
+			m_Statistics.ImageBarrierCount += ( uint32_t )m_FinalBarriers.Barriers.size();
+		}
+	}
+
+	void VulkanRenderGraph::CreateRenderPass( Group& group, std::vector<ResourceState>& states )
+	{
+		uint32_t groupIndex = m_Passes[ group.Passes[ 0 ] ]->m_Group;
+		uint32_t subpassCount = ( uint32_t )group.Passes.size();
+
+		struct AttachmentUse
+		{
+			uint32_t Subpass;
+			RenderGraphAccessInfo Info;
+			const VulkanRenderGraphPass::Use* Use;
+		};
+
+		// Every use of each attachment, in subpass order
+		std::vector<std::vector<AttachmentUse>> attachmentUses;
+		for ( uint32_t subpass = 0; subpass < subpassCount; subpass++ )
+		{
+			const VulkanRenderGraphPass& pass = *m_Passes[ group.Passes[ subpass ] ];
+			for ( const auto& use : pass.m_Uses )
+			{
+				RenderGraphAccessInfo info = GetAccessInfo( use.Access, true );
+				if ( !info.Attachment )
+					continue;
+
+				auto it = std::find( group.Attachments.begin(), group.Attachments.end(), use.Resource );
+				size_t index = it - group.Attachments.begin();
+				if ( it == group.Attachments.end() )
+				{
+					group.Attachments.push_back( use.Resource );
+					attachmentUses.emplace_back();
+				}
+				attachmentUses[ index ].push_back( { subpass, info, &use } );
+				m_Statistics.UntrackedBarrierCount++;
+			}
+		}
+
+		std::vector<VkSubpassDependency> dependencies;
+		auto addDependency = [&dependencies]( uint32_t src, uint32_t dst, VkPipelineStageFlags srcStages, VkAccessFlags srcAccess, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess )
+		{
+			for ( auto& dependency : dependencies )
+			{
+				if ( dependency.srcSubpass == src && dependency.dstSubpass == dst )
+				{
+					dependency.srcStageMask |= srcStages;
+					dependency.srcAccessMask |= srcAccess;
+					dependency.dstStageMask |= dstStages;
+					dependency.dstAccessMask |= dstAccess;
+					return;
+				}
+			}
+
+			VkSubpassDependency dependency{};
+			dependency.srcSubpass = src;
+			dependency.dstSubpass = dst;
+			dependency.srcStageMask = srcStages;
+			dependency.srcAccessMask = srcAccess;
+			dependency.dstStageMask = dstStages;
+			dependency.dstAccessMask = dstAccess;
+			dependency.dependencyFlags = src == VK_SUBPASS_EXTERNAL ? 0 : VK_DEPENDENCY_BY_REGION_BIT;
+			dependencies.push_back( dependency );
+		};
+
+		std::vector<std::vector<VkAttachmentReference>> colorReferences( subpassCount );
+		std::vector<VkAttachmentReference> depthReferences( subpassCount, { VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED } );
+		std::vector<std::vector<uint32_t>> preserveReferences( subpassCount );
+
+		for ( uint32_t attachment = 0; attachment < group.Attachments.size(); attachment++ )
+		{
+			RenderGraphResource handle = group.Attachments[ attachment ];
+			const Resource& resource = m_Resources[ handle ];
+			ResourceState& state = states[ handle ];
+			const auto& uses = attachmentUses[ attachment ];
+			const AttachmentUse& first = uses.front();
+			const AttachmentUse& last = uses.back();
+
+			VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			if ( first.Use->LoadOp == RenderGraphLoadOp::Clear )
+				loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			else if ( ( first.Use->LoadOp == RenderGraphLoadOp::Load || !first.Info.Write ) && state.Layout != VK_IMAGE_LAYOUT_UNDEFINED )
+				loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+
+			bool usedLater = resource.Imported || resource.Output || resource.LastGroup > groupIndex;
+			VkAttachmentStoreOp storeOp = usedLater ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+			// The final layout only differs from the last subpass layout when the graph is done with an imported
+			// texture. Everything else is transitioned by whoever uses the texture next, which knows its stages.
+			VkImageLayout finalLayout = last.Info.Layout;
+			if ( resource.Imported && resource.LastGroup == groupIndex && resource.FinalLayout != VK_IMAGE_LAYOUT_UNDEFINED )
+				finalLayout = resource.FinalLayout;
+
+			VkAttachmentDescription description{};
+			description.format = resource.Desc.Format;
+			description.samples = resource.Desc.Samples;
+			description.loadOp = loadOp;
+			description.storeOp = storeOp;
+			description.stencilLoadOp = HasStencil( resource.Desc.Format ) ? loadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			description.stencilStoreOp = HasStencil( resource.Desc.Format ) ? storeOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			description.initialLayout = loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? state.Layout : VK_IMAGE_LAYOUT_UNDEFINED;
+			description.finalLayout = finalLayout;
+			group.AttachmentDescriptions.push_back( description );
+			group.ClearValues.push_back( first.Use->ClearValue );
+
+			// The transition into the first subpass layout replaces a barrier in front of the render pass
+			if ( state.Stages || description.initialLayout != first.Info.Layout )
+				m_Statistics.RenderPassTransitionCount++;
+
+			addDependency( VK_SUBPASS_EXTERNAL, first.Subpass, state.Stages ? state.Stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+				state.Access & s_WriteAccess, first.Info.Stages, first.Info.Access );
+
+			for ( size_t i = 1; i < uses.size(); i++ )
+			{
+				const AttachmentUse& previous = uses[ i - 1 ];
+				const AttachmentUse& use = uses[ i ];
+				addDependency( previous.Subpass, use.Subpass, previous.Info.Stages, previous.Info.Access & s_WriteAccess, use.Info.Stages, use.Info.Access );
+
+				for ( uint32_t subpass = previous.Subpass + 1; subpass < use.Subpass; subpass++ )
+				{
+					preserveReferences[ subpass ].push_back( attachment );
+				}
+			}
+
+			state.Layout = finalLayout;
+			state.Stages = 0;
+			state.Access = 0;
+			for ( const auto& use : uses )
+			{
+				if ( use.Subpass == last.Subpass )
+				{
+					state.Stages |= use.Info.Stages;
+					state.Access |= use.Info.Access;
+				}
+			}
+		}
+
+		std::vector<VkSubpassDescription> subpasses( subpassCount );
+		for ( uint32_t subpass = 0; subpass < subpassCount; subpass++ )
+		{
+			// Color attachments keep the order the pass declared them in, which is their fragment output location
+			const VulkanRenderGraphPass& pass = *m_Passes[ group.Passes[ subpass ] ];
+			for ( const auto& use : pass.m_Uses )
+			{
+				RenderGraphAccessInfo info = GetAccessInfo( use.Access, true );
+				if ( !info.Attachment )
+					continue;
+
+				uint32_t attachment = ( uint32_t )( std::find( group.Attachments.begin(), group.Attachments.end(), use.Resource ) - group.Attachments.begin() );
+				VkAttachmentReference reference = { attachment, info.Layout };
+				if ( use.Access == RenderGraphAccess::ColorAttachment )
+				{
+					colorReferences[ subpass ].push_back( reference );
+				}
+				else
+				{
+					VE_ASSERT( depthReferences[ subpass ].attachment == VK_ATTACHMENT_UNUSED, "A pass can only use one depth attachment!" );
+					depthReferences[ subpass ] = reference;
+				}
+			}
+
+			VkSubpassDescription& description = subpasses[ subpass ];
+			description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+			description.colorAttachmentCount = ( uint32_t )colorReferences[ subpass ].size();
+			description.pColorAttachments = colorReferences[ subpass ].data();
+			description.pDepthStencilAttachment = depthReferences[ subpass ].attachment != VK_ATTACHMENT_UNUSED ? &depthReferences[ subpass ] : nullptr;
+			description.preserveAttachmentCount = ( uint32_t )preserveReferences[ subpass ].size();
+			description.pPreserveAttachments = preserveReferences[ subpass ].data();
+		}
+
+		group.DependencyCount = ( uint32_t )dependencies.size();
+
+		RenderPassKey key;
+		key.Attachments = group.AttachmentDescriptions;
+		key.ColorReferences = colorReferences;
+		key.DepthReferences = depthReferences;
+		key.PreserveReferences = preserveReferences;
+		key.Dependencies = dependencies;
+
+		// Identical groups within one graph share their render pass as well
+		auto it = m_RenderPasses.find( key );
+		if ( it != m_RenderPasses.end() )
+		{
+			it->second.Used = true;
+			group.RenderPass = it->second.RenderPass;
+			m_Statistics.ReusedRenderPassCount++;
+			return;
+		}
+
+		VkRenderPassCreateInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = ( uint32_t )group.AttachmentDescriptions.size();
+		renderPassInfo.pAttachments = group.AttachmentDescriptions.data();
+		renderPassInfo.subpassCount = subpassCount;
+		renderPassInfo.pSubpasses = subpasses.data();
+		renderPassInfo.dependencyCount = ( uint32_t )dependencies.size();
+		renderPassInfo.pDependencies = dependencies.data();
+
+		if ( m_Device )
+			VK_CHECK_RESULT( vkCreateRenderPass( m_Device->GetVulkanLogicalDevice(), &renderPassInfo, nullptr, &group.RenderPass ) );
+		m_RenderPasses.emplace( std::move( key ), CachedRenderPass{ group.RenderPass, true } );
+	}
+
+	// The Vulkan structs in the key have no padding, their bytes are their contents
+	template<typename T>
+	static bool BytesEqual( const std::vector<T>& a, const std::vector<T>& b )
+	{
+		return a.size() == b.size() && ( a.empty() || memcmp( a.data(), b.data(), a.size() * sizeof( T ) ) == 0 );
+	}
+
+	template<typename T>
+	static uint64_t HashBytes( const std::vector<T>& values, uint64_t hash )
+	{
+		hash = Hash::FNVValue( ( uint32_t )values.size(), hash );
+		return Hash::FNV( values.data(), values.size() * sizeof( T ), hash );
+	}
+
+	bool VulkanRenderGraph::RenderPassKey::operator==( const RenderPassKey& other ) const
+	{
+		if ( !BytesEqual( Attachments, other.Attachments ) || !BytesEqual( DepthReferences, other.DepthReferences ) ||
+			!BytesEqual( Dependencies, other.Dependencies ) || ColorReferences.size() != other.ColorReferences.size() ||
+			PreserveReferences.size() != other.PreserveReferences.size() )
+			return false;
+
+		for ( size_t subpass = 0; subpass < ColorReferences.size(); subpass++ )
+		{
+			if ( !BytesEqual( ColorReferences[ subpass ], other.ColorReferences[ subpass ] ) ||
+				!BytesEqual( PreserveReferences[ subpass ], other.PreserveReferences[ subpass ] ) )
+				return false;
+		}
+		return true;
+	}
+
+	size_t VulkanRenderGraph::RenderPassKeyHash::operator()( const RenderPassKey& key ) const
+	{
+		uint64_t hash = HashBytes( key.Attachments, Hash::FNVOffsetBasis );
+		hash = HashBytes( key.DepthReferences, hash );
+		for ( size_t subpass = 0; subpass < key.ColorReferences.size(); subpass++ )
+		{
+			hash = HashBytes( key.ColorReferences[ subpass ], hash );
+			hash = HashBytes( key.PreserveReferences[ subpass ], hash );
+		}
+		hash = HashBytes( key.Dependencies, hash );
+		return ( size_t )hash;
+	}
+
+	void VulkanRenderGraph::ReleaseUnusedRenderPasses()
+	{
+		// Render passes no group of this compilation matched, e.g. because the surface format changed
+		for ( auto it = m_RenderPasses.begin(); it != m_RenderPasses.end(); )
+		{
+			if ( it->second.Used )
+			{
+				++it;
+				continue;
+			}
+
+			if ( m_Device )
+				VulkanResourceRelease::RenderPass( it->second.RenderPass );
+			it = m_RenderPasses.erase( it );
+		}
+	}
+
+	void VulkanRenderGraph::Execute( VkCommandBuffer commandBuffer )
+	{
+		VE_ASSERT( m_Compiled, "Render graph has to be compiled before it is executed!" );
+		VE_ASSERT( m_Device, "A render graph without a device can only be compiled!" );
+
+		auto& gpuProfiler = m_Device->GetGPUProfiler();
+
+		for ( auto& group : m_Groups )
+		{
+			// Timed per render pass, timestamps cannot be written in subpasses that execute secondary buffers
+			VulkanGPUProfileScope gpuScope( gpuProfiler, commandBuffer, group.Name );
+
+			RecordBarriers( commandBuffer, group.Barriers );
+
+			VkCommandBufferInheritanceInfo inheritance{};
+			inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
+			if ( !group.Graphics )
+			{
+				auto& pass = *m_Passes[ group.Passes[ 0 ] ];
+				if ( pass.m_Execute )
+					pass.m_Execute( commandBuffer, inheritance );
+				continue;
+			}
+
+			inheritance.renderPass = group.RenderPass;
+			inheritance.framebuffer = GetFramebuffer( group );
+
+			VkRenderPassBeginInfo renderPassInfo{};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassInfo.renderPass = group.RenderPass;
+			renderPassInfo.framebuffer = inheritance.framebuffer;
+			renderPassInfo.renderArea.offset = { 0, 0 };
+			renderPassInfo.renderArea.extent = { group.Width, group.Height };
+			renderPassInfo.clearValueCount = ( uint32_t )group.ClearValues.size();
+			renderPassInfo.pClearValues = group.ClearValues.data();
+
+			for ( uint32_t subpass = 0; subpass < group.Passes.size(); subpass++ )
+			{
+				auto& pass = *m_Passes[ group.Passes[ subpass ] ];
+				if ( subpass == 0 )
+					vkCmdBeginRenderPass( commandBuffer, &renderPassInfo, pass.m_Contents );
+				else
+					vkCmdNextSubpass( commandBuffer, pass.m_Contents );
+
+				inheritance.subpass = subpass;
+				if ( pass.m_Execute )
+					pass.m_Execute( commandBuffer, inheritance );
+			}
+
+			vkCmdEndRenderPass( commandBuffer );
+		}
+
+		RecordBarriers( commandBuffer, m_FinalBarriers );
+	}
+
+	VkFramebuffer VulkanRenderGraph::GetFramebuffer( Group& group )
+	{
+		std::vector<VkImageView> attachments( group.Attachments.size() );
+		uint64_t key = Hash::FNVOffsetBasis;
+		for ( size_t i = 0; i < group.Attachments.size(); i++ )
+		{
+			attachments[ i ] = m_Resources[ group.Attachments[ i ] ].ImageView;
+			VE_ASSERT( attachments[ i ], "Imported render graph texture has no image view!" );
+			key = Hash::FNVValue( attachments[ i ], key );
+		}
+
+		auto it = group.Framebuffers.find( key );
+		if ( it != group.Framebuffers.end() )
+			return it->second;
+
+		VkFramebufferCreateInfo framebufferInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = group.RenderPass;
+		framebufferInfo.attachmentCount = ( uint32_t )attachments.size();
+		framebufferInfo.pAttachments = attachments.data();
+		framebufferInfo.width = group.Width;
+		framebufferInfo.height = group.Height;
+		framebufferInfo.layers = 1;
+
+		VkFramebuffer framebuffer;
+		VK_CHECK_RESULT( vkCreateFramebuffer( m_Device->GetVulkanLogicalDevice(), &framebufferInfo, nullptr, &framebuffer ) );
+		group.Framebuffers[ key ] = framebuffer;
+		return framebuffer;
+	}
+
+	void VulkanRenderGraph::RecordBarriers( VkCommandBuffer commandBuffer, const BarrierBatch& batch )
+	{
+		if ( batch.Barriers.empty() )
+			return;
+
+		m_BarrierScratch.clear();
+		for ( const auto& barrier : batch.Barriers )
+		{
+			const Resource& resource = m_Resources[ barrier.Resource ];
+			VE_ASSERT( resource.Image, "Imported render graph texture has no image!" );
+
+			VkImageMemoryBarrier& imageBarrier = m_BarrierScratch.emplace_back();
+			imageBarrier = {};
+			imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageBarrier.srcAccessMask = barrier.SrcAccess;
+			imageBarrier.dstAccessMask = barrier.DstAccess;
+			imageBarrier.oldLayout = barrier.OldLayout;
+			imageBarrier.newLayout = barrier.NewLayout;
+			imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.image = resource.Image;
+			imageBarrier.subresourceRange.aspectMask = GetAspectMask( resource.Desc.Format );
+			imageBarrier.subresourceRange.levelCount = 1;
+			imageBarrier.subresourceRange.layerCount = 1;
+		}
+
+		vkCmdPipelineBarrier( commandBuffer, batch.SrcStages, batch.DstStages, 0, 0, nullptr, 0, nullptr,
+			( uint32_t )m_BarrierScratch.size(), m_BarrierScratch.data() );
+	}
+
+	VkImage VulkanRenderGraph::GetImage( RenderGraphResource resource ) const
+	{
+		VE_ASSERT( resource < m_Resources.size() );
+		return m_Resources[ resource ].Image;
+	}
+
+	VkImageView VulkanRenderGraph::GetImageView( RenderGraphResource resource ) const
+	{
+		VE_ASSERT( resource < m_Resources.size() );
+		return m_Resources[ resource ].ImageView;
+	}
+
+	void VulkanRenderGraph::Clear()
+	{
+		ReleaseCompiled( false );
+		m_Resources.clear();
+		m_Passes.clear();
+	}
+
+	void VulkanRenderGraph::ReleaseCompiled( bool immediate )
+	{
+		// Without a device nothing was created
+		VkDevice device = m_Device ? m_Device->GetVulkanLogicalDevice() : nullptr;
+
+		for ( auto& group : m_Groups )
+		{
+			for ( auto& [key, framebuffer] : group.Framebuffers )
+			{
+				if ( immediate )
+					vkDestroyFramebuffer( device, framebuffer, nullptr );
+				else
+					VulkanResourceRelease::Framebuffer( framebuffer );
+			}
+		}
+
+		for ( auto& resource : m_Resources )
+		{
+			resource.Usage = 0;
+			resource.FirstGroup = UINT32_MAX;
+			resource.LastGroup = 0;
+			resource.Bucket = -1;
+
+			if ( resource.Imported || !resource.Image )
+				continue;
+
+			if ( immediate )
+			{
+				vkDestroyImageView( device, resource.ImageView, nullptr );
+				vkDestroyImage( device, resource.Image, nullptr );
+			}
+			else
+			{
+				VulkanResourceRelease::ImageView( resource.ImageView );
+				VulkanResourceRelease::Image( resource.Image, nullptr );
+			}
+			resource.Image = nullptr;
+			resource.ImageView = nullptr;
+		}
+
+		for ( auto& bucket : m_Buckets )
+		{
+			if ( !bucket.Allocation )
+				continue;
+
+			if ( immediate )
+				m_Device->GetAllocator().Free( bucket.Allocation );
+			else
+				VulkanResourceRelease::Memory( bucket.Allocation );
+		}
+
+		m_Groups.clear();
+		m_Buckets.clear();
+		m_FinalBarriers = {};
+		m_Compiled = false;
+	}
+
+	std::string VulkanRenderGraph::Dump() const
+	{
+		std::stringstream ss;
+		const auto& statistics = m_Statistics;
+
+		ss << "render graph: " << statistics.PassCount << " passes, " << statistics.CulledPassCount << " culled, "
+			<< statistics.RenderPassCount << " render passes (" << statistics.ReusedRenderPassCount << " reused), " << statistics.MergedPassCount << " merged\n";
+
+		auto dumpBarriers = [&]( const BarrierBatch& batch )
+		{
+			for ( const auto& barrier : batch.Barriers )
+			{
+				ss << "    barrier " << m_Resources[ barrier.Resource ].Name << ": " << LayoutToString( barrier.OldLayout )
+					<< " -> " << LayoutToString( barrier.NewLayout ) << "\n";
+			}
+		};
+
+		for ( size_t groupIndex = 0; groupIndex < m_Groups.size(); groupIndex++ )
+		{
+			const Group& group = m_Groups[ groupIndex ];
+			dumpBarriers( group.Barriers );
+
+			if ( group.Graphics )
+				ss << "  [" << groupIndex << "] render pass " << group.Width << "x" << group.Height << ", " << group.DependencyCount << " dependencies\n";
+			else
+				ss << "  [" << groupIndex << "] compute\n";
+
+			for ( size_t subpass = 0; subpass < group.Passes.size(); subpass++ )
+			{
+				ss << "    " << ( group.Graphics ? "subpass " : "pass " ) << subpass << ": " << m_Passes[ group.Passes[ subpass ] ]->m_Name << "\n";
+			}
+
+			for ( size_t attachment = 0; attachment < group.Attachments.size(); attachment++ )
+			{
+				const VkAttachmentDescription& description = group.AttachmentDescriptions[ attachment ];
+				ss << "    attachment " << m_Resources[ group.Attachments[ attachment ] ].Name << ": " << LoadOpToString( description.loadOp )
+					<< ( description.storeOp == VK_ATTACHMENT_STORE_OP_STORE ? "/store, " : "/dont care, " )
+					<< LayoutToString( description.initialLayout ) << " -> " << LayoutToString( description.finalLayout ) << "\n";
+			}
+		}
+		dumpBarriers( m_FinalBarriers );
+
+		for ( const auto& pass : m_Passes )
+		{
+			if ( pass->m_Culled )
+				ss << "  culled: " << pass->m_Name << "\n";
+		}
+
+		ss << "  barriers: " << statistics.ImageBarrierCount << " image barriers in " << statistics.PipelineBarrierCount << " pipeline barriers, "
+			<< statistics.RenderPassTransitionCount << " folded into render passes, " << statistics.UntrackedBarrierCount << " without state tracking\n";
+		ss << "  transient memory: " << statistics.TransientCount << " textures, " << statistics.TransientBytes / 1024 << "KB aliased into "
+			<< statistics.AllocatedBytes / 1024 << "KB in " << statistics.AllocationCount << " allocations\n";
+
+		for ( size_t i = 0; i < m_Buckets.size(); i++ )
+		{
+			ss << "    allocation " << i << " (" << m_Buckets[ i ].Size / 1024 << "KB):";
+			for ( RenderGraphResource resource : m_Buckets[ i ].Resources )
+			{
+				const Resource& r = m_Resources[ resource ];
+				ss << " " << r.Name << " [" << r.FirstGroup << "-" << r.LastGroup << "]";
+			}
+			ss << "\n";
+		}
+
+		return ss.str();
+	}
+}
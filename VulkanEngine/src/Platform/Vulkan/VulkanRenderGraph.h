@@ -0,0 +1,316 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace VE
+{
+	class VulkanLogicalDevice;
+	struct VulkanAllocation;
+
+	using RenderGraphResource = uint32_t;
+
+	struct RenderGraphTextureDesc
+	{
+		uint32_t Width = 0, Height = 0;
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+		VkSampleCountFlagBits Samples = VK_SAMPLE_COUNT_1_BIT;
+	};
+
+	enum class RenderGraphAccess
+	{
+		ColorAttachment,
+		DepthStencilAttachment,
+		DepthStencilReadOnly,
+		// Sampled in the fragment shader of a graphics pass or by a compute pass
+		Sampled,
+		StorageRead,
+		StorageWrite
+	};
+
+	enum class RenderGraphLoadOp
+	{
+		Load,
+		Clear,
+		DontCare
+	};
+
+	struct RenderGraphStatistics
+	{
+		uint32_t PassCount = 0;
+		uint32_t CulledPassCount = 0;
+		uint32_t RenderPassCount = 0;
+		// Render passes that were not created because an identical one already existed, from the previous
+		// compilation or an earlier group
+		uint32_t ReusedRenderPassCount = 0;
+		// Passes executed as a later subpass of the render pass before them
+		uint32_t MergedPassCount = 0;
+
+		uint32_t PipelineBarrierCount = 0;
+		uint32_t ImageBarrierCount = 0;
+		// Layout transitions and dependencies folded into render pass attachments and subpass dependencies
+		uint32_t RenderPassTransitionCount = 0;
+		// One barrier per resource use, what the graph would record without tracking resource state
+		uint32_t UntrackedBarrierCount = 0;
+
+		uint32_t TransientCount = 0;
+		uint32_t AllocationCount = 0;
+		// Memory the transient resources would take without aliasing, and the memory actually allocated
+		VkDeviceSize TransientBytes = 0;
+		VkDeviceSize AllocatedBytes = 0;
+	};
+
+	class VulkanRenderGraphPass
+	{
+	public:
+		// inheritance names the render pass, subpass and framebuffer the pass executes in, for recording
+		// secondary command buffers. Compute passes get an inheritance without a render pass.
+		using ExecuteFunc = std::function<void( VkCommandBuffer commandBuffer, const VkCommandBufferInheritanceInfo& inheritance )>;
+
+		void WriteColor( RenderGraphResource resource, RenderGraphLoadOp loadOp = RenderGraphLoadOp::Load, const VkClearColorValue& clearValue = {} );
+		void WriteDepthStencil( RenderGraphResource resource, RenderGraphLoadOp loadOp = RenderGraphLoadOp::Load, const VkClearDepthStencilValue& clearValue = { 1.0f, 0 } );
+		void ReadDepthStencil( RenderGraphResource resource );
+		void ReadTexture( RenderGraphResource resource );
+		void ReadStorage( RenderGraphResource resource );
+		void WriteStorage( RenderGraphResource resource );
+
+		// Passes without side effects are culled when nothing reads what they write
+		void SetSideEffects()
+		{
+			m_SideEffects = true;
+		}
+		// May change every frame, passes that record into secondary command buffers need
+		// VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+		void SetSubpassContents( VkSubpassContents contents )
+		{
+			m_Contents = contents;
+		}
+		void SetExecute( ExecuteFunc&& execute )
+		{
+			m_Execute = std::move( execute );
+		}
+
+		const std::string& GetName() const
+		{
+			return m_Name;
+		}
+		bool IsCulled() const
+		{
+			return m_Culled;
+		}
+
+	private:
+		struct Use
+		{
+			RenderGraphResource Resource;
+			RenderGraphAccess Access;
+			RenderGraphLoadOp LoadOp;
+			VkClearValue ClearValue;
+		};
+
+		VulkanRenderGraphPass( const std::string& name, bool graphics )
+			: m_Name( name ), m_Graphics( graphics )
+		{
+		}
+
+		void AddUse( RenderGraphResource resource, RenderGraphAccess access, RenderGraphLoadOp loadOp, const VkClearValue& clearValue );
+
+	private:
+		std::string m_Name;
+		bool m_Graphics;
+		bool m_SideEffects = false;
+		VkSubpassContents m_Contents = VK_SUBPASS_CONTENTS_INLINE;
+		ExecuteFunc m_Execute;
+		std::vector<Use> m_Uses;
+
+		bool m_Culled = false;
+		uint32_t m_Group = UINT32_MAX;
+
+		friend class VulkanRenderGraph;
+	};
+
+	// Passes declare the textures they read and write, Compile then works out everything that was hand-built
+	// before: passes whose results are never used are culled, consecutive graphics passes that render to the
+	// same size are merged into the subpasses of one render pass, layout transitions are folded into the render
+	// passes where possible and the remaining barriers are batched per pass, and transient textures whose
+	// lifetimes do not overlap share memory.
+	//
+	// Passes must be added in execution order, a pass may only read what an earlier pass wrote. Imported
+	// textures are owned outside the graph and always count as used.
+	//
+	// Without a device the graph is only planned: Compile works out culling, render passes, barriers and
+	// aliasing but creates no Vulkan objects, and memory requirements are estimated from the texture
+	// descriptions. Such a graph cannot be executed, it exists so the compiled result can be tested.
+	class VulkanRenderGraph
+	{
+	public:
+		VulkanRenderGraph( VulkanLogicalDevice* device );
+		~VulkanRenderGraph();
+
+		RenderGraphResource CreateTexture( const std::string& name, const RenderGraphTextureDesc& desc );
+		// finalLayout is the layout the texture is left in at the end of the graph
+		RenderGraphResource ImportTexture( const std::string& name, const RenderGraphTextureDesc& desc, VkImageLayout initialLayout, VkImageLayout finalLayout );
+		// Imported images may change every frame, e.g. the acquired swapchain image
+		void SetImportedTexture( RenderGraphResource resource, VkImage image, VkImageView imageView );
+		// Keeps the passes producing a transient texture alive although no pass reads it
+		void MarkOutput( RenderGraphResource resource );
+
+		VulkanRenderGraphPass& AddGraphicsPass( const std::string& name );
+		VulkanRenderGraphPass& AddComputePass( const std::string& name );
+
+		void Compile();
+		void Execute( VkCommandBuffer commandBuffer );
+
+		// Drops every pass and resource. Vulkan objects are released once the frames using them have completed,
+		// render passes are kept for the next compilation to reuse.
+		void Clear();
+
+		VkImage GetImage( RenderGraphResource resource ) const;
+		VkImageView GetImageView( RenderGraphResource resource ) const;
+
+		const RenderGraphStatistics& GetStatistics() const
+		{
+			return m_Statistics;
+		}
+		// Human readable description of the compiled graph: render passes, barriers and memory aliasing
+		std::string Dump() const;
+
+	private:
+		struct Resource
+		{
+			std::string Name;
+			RenderGraphTextureDesc Desc;
+			bool Imported = false;
+			bool Output = false;
+			VkImageLayout InitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkImageLayout FinalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			VkImageUsageFlags Usage = 0;
+			uint32_t FirstGroup = UINT32_MAX;
+			uint32_t LastGroup = 0;
+			int32_t Bucket = -1;
+
+			VkImage Image = nullptr;
+			VkImageView ImageView = nullptr;
+			VkMemoryRequirements Requirements{};
+		};
+
+		// Memory shared by transient textures with disjoint lifetimes
+		struct MemoryBucket
+		{
+			VkDeviceSize Size = 0;
+			VkDeviceSize Alignment = 0;
+			uint32_t MemoryTypeBits = 0;
+			std::vector<RenderGraphResource> Resources;
+			VulkanAllocation* Allocation = nullptr;
+		};
+
+		struct Barrier
+		{
+			RenderGraphResource Resource;
+			VkImageLayout OldLayout;
+			VkImageLayout NewLayout;
+			VkAccessFlags SrcAccess;
+			VkAccessFlags DstAccess;
+		};
+
+		struct BarrierBatch
+		{
+			VkPipelineStageFlags SrcStages = 0;
+			VkPipelineStageFlags DstStages = 0;
+			std::vector<Barrier> Barriers;
+		};
+
+		// One render pass, or a single compute pass
+		struct Group
+		{
+			std::vector<uint32_t> Passes;
+			// Names of the passes, used for the GPU timing region around the group
+			std::string Name;
+			bool Graphics = false;
+			uint32_t Width = 0, Height = 0;
+
+			BarrierBatch Barriers;
+
+			// Owned by the render pass cache
+			VkRenderPass RenderPass = nullptr;
+			std::vector<RenderGraphResource> Attachments;
+			std::vector<VkAttachmentDescription> AttachmentDescriptions;
+			std::vector<VkClearValue> ClearValues;
+			uint32_t DependencyCount = 0;
+			// Framebuffers by the image views they were created with, imported views change between frames
+			std::unordered_map<uint64_t, VkFramebuffer> Framebuffers;
+		};
+
+		// Everything that goes into the render pass create info. The extent is not part of it, so a resize hits
+		// the cache.
+		struct RenderPassKey
+		{
+			std::vector<VkAttachmentDescription> Attachments;
+			std::vector<std::vector<VkAttachmentReference>> ColorReferences;
+			std::vector<VkAttachmentReference> DepthReferences;
+			std::vector<std::vector<uint32_t>> PreserveReferences;
+			std::vector<VkSubpassDependency> Dependencies;
+
+			bool operator==( const RenderPassKey& other ) const;
+		};
+
+		struct RenderPassKeyHash
+		{
+			size_t operator()( const RenderPassKey& key ) const;
+		};
+
+		struct CachedRenderPass
+		{
+			VkRenderPass RenderPass = nullptr;
+			// By the current compilation
+			bool Used = false;
+		};
+
+		struct ResourceState
+		{
+			VkImageLayout Layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkPipelineStageFlags Stages = 0;
+			VkAccessFlags Access = 0;
+		};
+
+		VulkanRenderGraphPass& AddPass( const std::string& name, bool graphics );
+
+		void CullPasses();
+		void BuildGroups();
+		void CreateResources();
+		VkMemoryRequirements EstimateRequirements( const RenderGraphTextureDesc& desc ) const;
+		void AliasResources();
+		void BuildBarriers();
+		void CreateRenderPass( Group& group, std::vector<ResourceState>& states );
+		void ReleaseUnusedRenderPasses();
+
+		VkFramebuffer GetFramebuffer( Group& group );
+		void RecordBarriers( VkCommandBuffer commandBuffer, const BarrierBatch& batch );
+
+		// Immediately when the device is idle, otherwise through the frame release queue
+		void ReleaseCompiled( bool immediate );
+
+	private:
+		VulkanLogicalDevice* m_Device;
+
+		std::vector<Resource> m_Resources;
+		std::vector<Scope<VulkanRenderGraphPass>> m_Passes;
+
+		bool m_Compiled = false;
+		std::vector<Group> m_Groups;
+		std::vector<MemoryBucket> m_Buckets;
+		// Render passes by their attachments, subpasses and dependencies. A recompile that only changes sizes,
+		// e.g. after a resize, gets the same render passes back and only recreates framebuffers and transient
+		// textures.
+		std::unordered_map<RenderPassKey, CachedRenderPass, RenderPassKeyHash> m_RenderPasses;
+		// Brings imported textures into their final layout after the last group
+		BarrierBatch m_FinalBarriers;
+
+		std::vector<VkImageMemoryBarrier> m_BarrierScratch;
+		RenderGraphStatistics m_Statistics;
+	};
+}
@@ -0,0 +1,104 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanResourceRelease.h"
+
+#include "Platform/Vulkan/VulkanInstance.h"
+
+#include "Renderer/Renderer.h"
+
+namespace VE
+{
+
+	static VkDevice GetDevice()
+	{
+		return VulkanInstance::GetCurrentDevice()->GetVulkanLogicalDevice();
+	}
+
+	void VulkanResourceRelease::Buffer( VkBuffer buffer, VulkanAllocation* allocation )
+	{
+		Renderer::SubmitResourceFree( [buffer, allocation]()
+			{
+				VulkanInstance::GetCurrentDevice()->GetAllocator().DestroyBuffer( buffer, allocation );
+			}, allocation ? allocation->Size : 0 );
+	}
+
+	void VulkanResourceRelease::Image( VkImage image, VulkanAllocation* allocation )
+	{
+		Renderer::SubmitResourceFree( [image, allocation]()
+			{
+				VulkanInstance::GetCurrentDevice()->GetAllocator().DestroyImage( image, allocation );
+			}, allocation ? allocation->Size : 0 );
+	}
+
+	void VulkanResourceRelease::Memory( VulkanAllocation* allocation )
+	{
+		Renderer::SubmitResourceFree( [allocation]()
+			{
+				VulkanInstance::GetCurrentDevice()->GetAllocator().Free( allocation );
+			}, allocation ? allocation->Size : 0 );
+	}
+
+	void VulkanResourceRelease::ImageView( VkImageView imageView )
+	{
+		Renderer::SubmitResourceFree( [imageView]()
+			{
+				vkDestroyImageView( GetDevice(), imageView, nullptr );
+			} );
+	}
+
+	void VulkanResourceRelease::Sampler( VkSampler sampler )
+	{
+		Renderer::SubmitResourceFree( [sampler]()
+			{
+				vkDestroySampler( GetDevice(), sampler, nullptr );
+			} );
+	}
+
+	void VulkanResourceRelease::Framebuffer( VkFramebuffer framebuffer )
+	{
+		Renderer::SubmitResourceFree( [framebuffer]()
+			{
+				vkDestroyFramebuffer( GetDevice(), framebuffer, nullptr );
+			} );
+	}
+
+	void VulkanResourceRelease::RenderPass( VkRenderPass renderPass )
+	{
+		Renderer::SubmitResourceFree( [renderPass]()
+			{
+				vkDestroyRenderPass( GetDevice(), renderPass, nullptr );
+			} );
+	}
+
+	void VulkanResourceRelease::Pipeline( VkPipeline pipeline )
+	{
+		Renderer::SubmitResourceFree( [pipeline]()
+			{
+				vkDestroyPipeline( GetDevice(), pipeline, nullptr );
+			} );
+	}
+
+	void VulkanResourceRelease::PipelineLayout( VkPipelineLayout pipelineLayout )
+	{
+		Renderer::SubmitResourceFree( [pipelineLayout]()
+			{
+				vkDestroyPipelineLayout( GetDevice(), pipelineLayout, nullptr );
+			} );
+	}
+
+	void VulkanResourceRelease::DescriptorPool( VkDescriptorPool descriptorPool )
+	{
+		Renderer::SubmitResourceFree( [descriptorPool]()
+			{
+				vkDestroyDescriptorPool( GetDevice(), descriptorPool, nullptr );
+			} );
+	}
+
+	void VulkanResourceRelease::SwapChain( VkSwapchainKHR swapChain )
+	{
+		Renderer::SubmitResourceFree( [swapChain]()
+			{
+				vkDestroySwapchainKHR( GetDevice(), swapChain, nullptr );
+			} );
+	}
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+#include "Platform/Vulkan/VulkanAllocator.h"
+
+namespace VE
+{
+	// Typed helpers around Renderer::SubmitResourceFree. Each call queues the destruction on the frame in
+	// flight that is being recorded, the object is destroyed after that frame's fence has signalled.
+	class VulkanResourceRelease
+	{
+	public:
+		static void Buffer( VkBuffer buffer, VulkanAllocation* allocation );
+		static void Image( VkImage image, VulkanAllocation* allocation );
+		// Memory that is not owned by a single buffer or image, e.g. shared by aliased images
+		static void Memory( VulkanAllocation* allocation );
+		static void ImageView( VkImageView imageView );
+		static void Sampler( VkSampler sampler );
+		static void Framebuffer( VkFramebuffer framebuffer );
+		static void RenderPass( VkRenderPass renderPass );
+		static void Pipeline( VkPipeline pipeline );
+		static void PipelineLayout( VkPipelineLayout pipelineLayout );
+		static void DescriptorPool( VkDescriptorPool descriptorPool );
+		static void SwapChain( VkSwapchainKHR swapChain );
+	};
+}
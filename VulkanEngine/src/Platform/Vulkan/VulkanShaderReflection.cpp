@@ -0,0 +1,427 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanShaderReflection.h"
+
+#include <spirv_cross/spirv_cross.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+namespace VE
+{
+
+	// Bump when the layout of the cached reflection changes
+	static constexpr uint32_t s_ReflectionCacheVersion = 1;
+
+	VkShaderStageFlagBits ShaderStageToVulkan( ShaderStage stage )
+	{
+		switch ( stage )
+		{
+			case ShaderStage::Vertex:	return VK_SHADER_STAGE_VERTEX_BIT;
+			case ShaderStage::Fragment:	return VK_SHADER_STAGE_FRAGMENT_BIT;
+			case ShaderStage::Compute:	return VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+		VE_ASSERT( false, "Unknown shader stage!" );
+		return VK_SHADER_STAGE_VERTEX_BIT;
+	}
+
+	static VkFormat GetVertexFormat( const spirv_cross::SPIRType& type )
+	{
+		static constexpr VkFormat s_FloatFormats[] = { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+		static constexpr VkFormat s_IntFormats[] = { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+		static constexpr VkFormat s_UIntFormats[] = { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+
+		uint32_t index = type.vecsize - 1;
+		switch ( type.basetype )
+		{
+			case spirv_cross::SPIRType::Float:	return s_FloatFormats[ index ];
+			case spirv_cross::SPIRType::Int:	return s_IntFormats[ index ];
+			case spirv_cross::SPIRType::UInt:	return s_UIntFormats[ index ];
+			default: break;
+		}
+		VE_ASSERT( false, "Unsupported vertex input type!" );
+		return VK_FORMAT_UNDEFINED;
+	}
+
+	static uint32_t GetVertexFormatSize( VkFormat format )
+	{
+		switch ( format )
+		{
+			case VK_FORMAT_R32_SFLOAT:
+			case VK_FORMAT_R32_SINT:
+			case VK_FORMAT_R32_UINT:				return 4;
+			case VK_FORMAT_R32G32_SFLOAT:
+			case VK_FORMAT_R32G32_SINT:
+			case VK_FORMAT_R32G32_UINT:				return 8;
+			case VK_FORMAT_R32G32B32_SFLOAT:
+			case VK_FORMAT_R32G32B32_SINT:
+			case VK_FORMAT_R32G32B32_UINT:			return 12;
+			case VK_FORMAT_R32G32B32A32_SFLOAT:
+			case VK_FORMAT_R32G32B32A32_SINT:
+			case VK_FORMAT_R32G32B32A32_UINT:		return 16;
+			default: break;
+		}
+		return 0;
+	}
+
+	static void AddBindings( spirv_cross::Compiler& compiler, const spirv_cross::SmallVector<spirv_cross::Resource>& resources, VkDescriptorType type,
+		VkShaderStageFlags stage, std::vector<ShaderDescriptorBinding>& outBindings )
+	{
+		for ( const auto& resource : resources )
+		{
+			const auto& resourceType = compiler.get_type( resource.type_id );
+
+			ShaderDescriptorBinding binding;
+			binding.Set = compiler.get_decoration( resource.id, spv::DecorationDescriptorSet );
+			binding.Binding = compiler.get_decoration( resource.id, spv::DecorationBinding );
+			binding.Type = type;
+			binding.Count = resourceType.array.empty() ? 1 : resourceType.array[ 0 ];
+			binding.Stages = stage;
+			binding.Name = resource.name;
+
+			// Texel buffers are reflected as images with a buffer dimension
+			if ( resourceType.basetype == spirv_cross::SPIRType::Image && resourceType.image.dim == spv::DimBuffer )
+			{
+				if ( type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE )
+					binding.Type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+				else if ( type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE )
+					binding.Type = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+			}
+
+			outBindings.push_back( binding );
+		}
+	}
+
+	VulkanShaderReflection VulkanShaderReflection::Reflect( const std::vector<uint32_t>& spirv, ShaderStage stage )
+	{
+		VulkanShaderReflection reflection;
+		VkShaderStageFlags stageFlags = ShaderStageToVulkan( stage );
+
+		spirv_cross::Compiler compiler( spirv );
+		spirv_cross::ShaderResources resources = compiler.get_shader_resources();
+
+		AddBindings( compiler, resources.uniform_buffers, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, stageFlags, reflection.Bindings );
+		AddBindings( compiler, resources.storage_buffers, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stageFlags, reflection.Bindings );
+		AddBindings( compiler, resources.sampled_images, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, stageFlags, reflection.Bindings );
+		AddBindings( compiler, resources.separate_images, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, stageFlags, reflection.Bindings );
+		AddBindings( compiler, resources.separate_samplers, VK_DESCRIPTOR_TYPE_SAMPLER, stageFlags, reflection.Bindings );
+		AddBindings( compiler, resources.storage_images, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, stageFlags, reflection.Bindings );
+		AddBindings( compiler, resources.subpass_inputs, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, stageFlags, reflection.Bindings );
+
+		for ( const auto& resource : resources.push_constant_buffers )
+		{
+			const auto& type = compiler.get_type( resource.base_type_id );
+			uint32_t size = ( uint32_t )compiler.get_declared_struct_size( type );
+
+			// Members before the first used offset may belong to another stage's range
+			uint32_t offset = size;
+			for ( const auto& range : compiler.get_active_buffer_ranges( resource.id ) )
+			{
+				offset = std::min( offset, ( uint32_t )range.offset );
+			}
+			if ( offset == size )
+				offset = 0;
+
+			VkPushConstantRange pushConstantRange{};
+			pushConstantRange.stageFlags = stageFlags;
+			pushConstantRange.offset = offset;
+			pushConstantRange.size = size - offset;
+			reflection.PushConstantRanges.push_back( pushConstantRange );
+		}
+
+		if ( stage == ShaderStage::Vertex )
+		{
+			for ( const auto& resource : resources.stage_inputs )
+			{
+				const auto& type = compiler.get_type( resource.base_type_id );
+				uint32_t location = compiler.get_decoration( resource.id, spv::DecorationLocation );
+
+				// Matrices take one location per column
+				for ( uint32_t column = 0; column < type.columns; column++ )
+				{
+					ShaderVertexAttribute attribute;
+					attribute.Location = location + column;
+					attribute.Format = GetVertexFormat( type );
+					attribute.Name = resource.name;
+					reflection.VertexAttributes.push_back( attribute );
+				}
+			}
+
+			std::sort( reflection.VertexAttributes.begin(), reflection.VertexAttributes.end(), []( const auto& a, const auto& b ) { return a.Location < b.Location; } );
+
+			for ( auto& attribute : reflection.VertexAttributes )
+			{
+				attribute.Offset = reflection.VertexStride;
+				reflection.VertexStride += GetVertexFormatSize( attribute.Format );
+			}
+		}
+
+		return reflection;
+	}
+
+	void VulkanShaderReflection::Merge( const VulkanShaderReflection& other )
+	{
+		for ( const auto& binding : other.Bindings )
+		{
+			auto it = std::find_if( Bindings.begin(), Bindings.end(), [&]( const auto& existing ) { return existing.Set == binding.Set && existing.Binding == binding.Binding; } );
+			if ( it == Bindings.end() )
+			{
+				Bindings.push_back( binding );
+				continue;
+			}
+
+			VE_ASSERT( it->Type == binding.Type && it->Count == binding.Count, "Shader stages declare a binding differently!" );
+			it->Stages |= binding.Stages;
+		}
+
+		for ( const auto& range : other.PushConstantRanges )
+		{
+			if ( PushConstantRanges.empty() )
+			{
+				PushConstantRanges.push_back( range );
+				continue;
+			}
+
+			auto& merged = PushConstantRanges[ 0 ];
+			uint32_t end = std::max( merged.offset + merged.size, range.offset + range.size );
+			merged.offset = std::min( merged.offset, range.offset );
+			merged.size = end - merged.offset;
+			merged.stageFlags |= range.stageFlags;
+		}
+
+		if ( !other.VertexAttributes.empty() )
+		{
+			VertexAttributes = other.VertexAttributes;
+			VertexStride = other.VertexStride;
+		}
+	}
+
+	std::vector<VkDescriptorSetLayoutBinding> VulkanShaderReflection::GetSetLayoutBindings( uint32_t set ) const
+	{
+		std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+		for ( const auto& binding : Bindings )
+		{
+			if ( binding.Set != set )
+				continue;
+
+			VkDescriptorSetLayoutBinding layoutBinding{};
+			layoutBinding.binding = binding.Binding;
+			layoutBinding.descriptorType = binding.Type;
+			layoutBinding.descriptorCount = binding.Count;
+			layoutBinding.stageFlags = binding.Stages;
+			layoutBindings.push_back( layoutBinding );
+		}
+
+		std::sort( layoutBindings.begin(), layoutBindings.end(), []( const auto& a, const auto& b ) { return a.binding < b.binding; } );
+		return layoutBindings;
+	}
+
+	uint32_t VulkanShaderReflection::GetSetCount() const
+	{
+		uint32_t count = 0;
+		for ( const auto& binding : Bindings )
+		{
+			count = std::max( count, binding.Set + 1 );
+		}
+		return count;
+	}
+
+	VkVertexInputBindingDescription VulkanShaderReflection::GetVertexBindingDescription() const
+	{
+		VkVertexInputBindingDescription bindingDescription{};
+		bindingDescription.binding = 0;
+		bindingDescription.stride = VertexStride;
+		bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		return bindingDescription;
+	}
+
+	std::vector<VkVertexInputAttributeDescription> VulkanShaderReflection::GetVertexAttributeDescriptions() const
+	{
+		std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+		for ( const auto& attribute : VertexAttributes )
+		{
+			VkVertexInputAttributeDescription description{};
+			description.location = attribute.Location;
+			description.binding = 0;
+			description.format = attribute.Format;
+			description.offset = attribute.Offset;
+			attributeDescriptions.push_back( description );
+		}
+		return attributeDescriptions;
+	}
+
+	namespace
+	{
+		class ReflectionWriter
+		{
+		public:
+			template<typename T>
+			void Write( const T& value )
+			{
+				m_Stream.write( ( const char* )&value, sizeof( T ) );
+			}
+			void Write( const std::string& string )
+			{
+				Write( ( uint32_t )string.size() );
+				m_Stream.write( string.data(), string.size() );
+			}
+
+			std::string GetData() const
+			{
+				return m_Stream.str();
+			}
+
+		private:
+			std::stringstream m_Stream;
+		};
+
+		class ReflectionReader
+		{
+		public:
+			ReflectionReader( std::istream& stream )
+				: m_Stream( stream )
+			{
+			}
+
+			template<typename T>
+			void Read( T& value )
+			{
+				m_Stream.read( ( char* )&value, sizeof( T ) );
+			}
+			void Read( std::string& string )
+			{
+				uint32_t size = 0;
+				Read( size );
+				if ( !m_Stream || size > s_MaxStringSize )
+				{
+					m_Stream.setstate( std::ios::failbit );
+					return;
+				}
+				string.resize( size );
+				m_Stream.read( string.data(), size );
+			}
+
+			bool IsValid() const
+			{
+				return ( bool )m_Stream;
+			}
+
+		private:
+			static constexpr uint32_t s_MaxStringSize = 1024;
+			std::istream& m_Stream;
+		};
+	}
+
+	static std::filesystem::path GetReflectionCachePath( uint64_t key )
+	{
+		std::stringstream fileName;
+		fileName << std::hex << std::setfill( '0' ) << std::setw( 16 ) << key << ".refl";
+		return ShaderCompiler::GetCacheDirectory() / fileName.str();
+	}
+
+	static void WriteReflectionCache( uint64_t key, const VulkanShaderReflection& reflection )
+	{
+		ReflectionWriter writer;
+		writer.Write( s_ReflectionCacheVersion );
+
+		writer.Write( ( uint32_t )reflection.Bindings.size() );
+		for ( const auto& binding : reflection.Bindings )
+		{
+			writer.Write( binding.Set );
+			writer.Write( binding.Binding );
+			writer.Write( binding.Type );
+			writer.Write( binding.Count );
+			writer.Write( binding.Stages );
+			writer.Write( binding.Name );
+		}
+
+		writer.Write( ( uint32_t )reflection.PushConstantRanges.size() );
+		for ( const auto& range : reflection.PushConstantRanges )
+		{
+			writer.Write( range );
+		}
+
+		writer.Write( ( uint32_t )reflection.VertexAttributes.size() );
+		for ( const auto& attribute : reflection.VertexAttributes )
+		{
+			writer.Write( attribute.Location );
+			writer.Write( attribute.Format );
+			writer.Write( attribute.Offset );
+			writer.Write( attribute.Name );
+		}
+		writer.Write( reflection.VertexStride );
+
+		std::string data = writer.GetData();
+		std::ofstream stream( GetReflectionCachePath( key ), std::ios::binary | std::ios::trunc );
+		stream.write( data.data(), data.size() );
+	}
+
+	static bool ReadReflectionCache( uint64_t key, VulkanShaderReflection& outReflection )
+	{
+		std::ifstream stream( GetReflectionCachePath( key ), std::ios::binary );
+		if ( !stream )
+			return false;
+
+		ReflectionReader reader( stream );
+
+		uint32_t version = 0;
+		reader.Read( version );
+		if ( version != s_ReflectionCacheVersion )
+			return false;
+
+		// Counts are bounded so that a corrupt file cannot trigger huge allocations
+		static constexpr uint32_t s_MaxCount = 4096;
+
+		uint32_t count = 0;
+		reader.Read( count );
+		if ( !reader.IsValid() || count > s_MaxCount )
+			return false;
+		outReflection.Bindings.resize( count );
+		for ( auto& binding : outReflection.Bindings )
+		{
+			reader.Read( binding.Set );
+			reader.Read( binding.Binding );
+			reader.Read( binding.Type );
+			reader.Read( binding.Count );
+			reader.Read( binding.Stages );
+			reader.Read( binding.Name );
+		}
+
+		reader.Read( count );
+		if ( !reader.IsValid() || count > s_MaxCount )
+			return false;
+		outReflection.PushConstantRanges.resize( count );
+		for ( auto& range : outReflection.PushConstantRanges )
+		{
+			reader.Read( range );
+		}
+
+		reader.Read( count );
+		if ( !reader.IsValid() || count > s_MaxCount )
+			return false;
+		outReflection.VertexAttributes.resize( count );
+		for ( auto& attribute : outReflection.VertexAttributes )
+		{
+			reader.Read( attribute.Location );
+			reader.Read( attribute.Format );
+			reader.Read( attribute.Offset );
+			reader.Read( attribute.Name );
+		}
+		reader.Read( outReflection.VertexStride );
+
+		return reader.IsValid();
+	}
+
+	VulkanShaderReflection VulkanShaderReflection::Get( const ShaderSource& source, const ShaderCompileResult& compileResult )
+	{
+		VE_ASSERT( compileResult.Success, "Cannot reflect a shader that failed to compile!" );
+
+		VulkanShaderReflection reflection;
+		if ( ReadReflectionCache( compileResult.CacheKey, reflection ) )
+			return reflection;
+
+		reflection = Reflect( compileResult.SPIRV, source.Stage );
+		WriteReflectionCache( compileResult.CacheKey, reflection );
+		return reflection;
+	}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+
+#include "Renderer/ShaderCompiler.h"
+
+namespace VE
+{
+	struct ShaderDescriptorBinding
+	{
+		uint32_t Set = 0;
+		uint32_t Binding = 0;
+		VkDescriptorType Type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		// 0 for runtime sized arrays
+		uint32_t Count = 1;
+		VkShaderStageFlags Stages = 0;
+		std::string Name;
+	};
+
+	struct ShaderVertexAttribute
+	{
+		uint32_t Location = 0;
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+		uint32_t Offset = 0;
+		std::string Name;
+	};
+
+	// Resource interface of one or more shader stages, as declared in their SPIR-V
+	struct VulkanShaderReflection
+	{
+		std::vector<ShaderDescriptorBinding> Bindings;
+		// At most one range, covering the push constant blocks of every stage
+		std::vector<VkPushConstantRange> PushConstantRanges;
+		// Vertex stage inputs, tightly packed into a single interleaved binding in location order
+		std::vector<ShaderVertexAttribute> VertexAttributes;
+		uint32_t VertexStride = 0;
+
+		// Combines the interface of another stage of the same pipeline
+		void Merge( const VulkanShaderReflection& other );
+
+		std::vector<VkDescriptorSetLayoutBinding> GetSetLayoutBindings( uint32_t set ) const;
+		uint32_t GetSetCount() const;
+		VkVertexInputBindingDescription GetVertexBindingDescription() const;
+		std::vector<VkVertexInputAttributeDescription> GetVertexAttributeDescriptions() const;
+
+		static VulkanShaderReflection Reflect( const std::vector<uint32_t>& spirv, ShaderStage stage );
+		// Reflects a compiled shader, or loads the result of an earlier run from next to its cached SPIR-V
+		static VulkanShaderReflection Get( const ShaderSource& source, const ShaderCompileResult& compileResult );
+	};
+
+	VkShaderStageFlagBits ShaderStageToVulkan( ShaderStage stage );
+}
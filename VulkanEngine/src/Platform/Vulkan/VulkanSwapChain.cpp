@@ -1,8 +1,14 @@
 #include "vepch.h"
 #include "Platform/Vulkan/VulkanSwapChain.h"
 
+#include "Platform/Vulkan/VulkanResourceRelease.h"
+
 #include "Renderer/Renderer.h"
 
+#ifdef VE_PLATFORM_WINDOWS
+	#include <GLFW/glfw3.h>
+#endif
+
 namespace VE
 {
 
@@ -15,126 +21,272 @@ namespace VE
 	void VulkanSwapChain::CreateSurface( GLFWwindow* window )
 	{
 		m_Window = window;
-		glfwCreateWindowSurface( m_Instance, window, nullptr, &m_Surface );
+#ifdef VE_PLATFORM_WINDOWS
+		VK_CHECK_RESULT( glfwCreateWindowSurface( m_Instance, window, nullptr, &m_Surface ) );
+#else
+		VE_ASSERT( false, "Window surfaces are not supported on this platform!" );
+#endif
 	}
 
 	void VulkanSwapChain::Create( uint32_t* width, uint32_t* height, bool vsync )
 	{
+		m_FramesInFlight = Renderer::GetConfig().FramesInFlight;
+
 		CreateSwapChain( width, height, vsync );
 		CreateImageViews();
-		CreateRenderPass();
-		CreateFramebuffers();
 		CreateCommandPool();
 		CreateCommandBuffers();
 		CreateSyncObjects();
+		BuildRenderGraph();
+	}
+
+	void VulkanSwapChain::CreateHeadless( uint32_t width, uint32_t height )
+	{
+		m_Headless = true;
+		m_FramesInFlight = Renderer::GetConfig().FramesInFlight;
+
+		CreateOffscreenImages( width, height );
+		CreateImageViews();
+		CreateCommandPool();
+		CreateCommandBuffers();
+		CreateSyncObjects();
+		BuildRenderGraph();
 	}
 
 	void VulkanSwapChain::DrawFrame()
 	{
-		//auto& queue = Renderer::GetRenderResourceReleaseQueue( m_CurrentBufferIndex );
-		//queue.Execute();
+		VE_PROFILE_FUNCTION();
 
 		auto logicalDevice = m_LogicalDevice->GetVulkanLogicalDevice();
 		auto graphicsQueue = m_LogicalDevice->GetGraphicsQueue();
+		auto& timeline = m_LogicalDevice->GetGraphicsTimeline();
 
-		vkWaitForFences( logicalDevice, 1, &m_WaitInFlightFences[ m_CurrentBufferIndex ], VK_TRUE, UINT64_MAX );
+		FrameStatistics& statistics = m_FrameStatistics[ m_CurrentBufferIndex ];
+		statistics.FrameNumber = m_FrameNumber;
+		statistics.CPUFrameTime = m_FrameTimer.ElapsedMillis();
+		m_FrameTimer.Reset();
 
-		VkResult result = vkAcquireNextImageKHR( logicalDevice, m_SwapChain, UINT64_MAX, m_WaitSemaphores[ m_CurrentBufferIndex ], ( VkFence )nullptr, &m_CurrentImageIndex );
-		if ( result == VK_ERROR_OUT_OF_DATE_KHR )
+		// This is the only place the CPU waits for the GPU: the timeline value guards the resources of the
+		// frame that last used this slot, which was submitted m_FramesInFlight frames ago
+		Timer waitTimer;
 		{
-			OnResize( m_Width, m_Height );
-			return;
+			VE_PROFILE_SCOPE( "Wait for frame slot" );
+			timeline.Wait( m_FrameTimelineValues[ m_CurrentBufferIndex ] );
+		}
+
+		// Everything released while this slot was last recorded is no longer referenced by the GPU
+		auto& releaseQueue = Renderer::GetRenderResourceReleaseQueue( m_CurrentBufferIndex );
+		releaseQueue.Execute();
+		m_LogicalDevice->GetDescriptorAllocator().BeginFrame( m_CurrentBufferIndex );
+		VK_CHECK_RESULT( vkResetCommandPool( logicalDevice, m_CommandPools[ m_CurrentBufferIndex ], 0 ) );
+		m_CommandRecorder->BeginFrame( m_CurrentBufferIndex );
+
+		if ( m_ResizePending )
+		{
+			Recreate();
+		}
+
+		if ( m_Headless )
+		{
+			// Every frame slot has its own image, the timeline wait above already made it available
+			m_CurrentImageIndex = m_CurrentBufferIndex;
 		}
-		else if ( result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR )
+		else
 		{
-			VE_ASSERT( false, "failed to acquire swap chain image!" );
+			VkResult result = vkAcquireNextImageKHR( logicalDevice, m_SwapChain, UINT64_MAX, m_WaitSemaphores[ m_CurrentBufferIndex ], ( VkFence )nullptr, &m_CurrentImageIndex );
+			if ( result == VK_ERROR_OUT_OF_DATE_KHR )
+			{
+				OnResize( m_Width, m_Height );
+				return;
+			}
+			else if ( result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR )
+			{
+				VE_ASSERT( false, "failed to acquire swap chain image!" );
+			}
 		}
 
-		if ( m_ImageInFlightFences[ m_CurrentImageIndex ] != VK_NULL_HANDLE )
+		statistics.CPUWaitTime = waitTimer.ElapsedMillis();
+
+		// Uploads requested since the last frame are submitted to the transfer queue ahead of this frame
+		m_LogicalDevice->GetUploadManager().Flush();
+
+		m_SubmitWaits.Clear();
+		if ( !m_Headless )
+			m_SubmitWaits.Add( m_WaitSemaphores[ m_CurrentBufferIndex ], VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT );
+
+		VkCommandBuffer commandBuffer = m_CommandBuffers[ m_CurrentBufferIndex ];
 		{
-			vkWaitForFences( logicalDevice, 1, &m_ImageInFlightFences[ m_CurrentImageIndex ], VK_TRUE, UINT64_MAX );
+			VE_PROFILE_SCOPE( "Record frame" );
+			RecordCommandBuffer( commandBuffer );
 		}
-		m_ImageInFlightFences[ m_CurrentImageIndex ] = m_WaitInFlightFences[ m_CurrentBufferIndex ];
 
-		//Renderer::WaitAndRender();
+		// Compute passes go to the compute queue first so the semaphore they signal is already pending
+		m_LogicalDevice->GetComputeScheduler().Submit( m_CurrentBufferIndex, m_SubmitWaits );
+
+		m_FrameTimelineValues[ m_CurrentBufferIndex ] = timeline.Next();
+
+		// The binary semaphore is only there for presentation, which cannot wait on a timeline
+		VkSemaphore signalSemaphores[] = { timeline.GetSemaphore(), m_SignalSemaphores[ m_CurrentBufferIndex ] };
+		uint64_t signalValues[] = { m_FrameTimelineValues[ m_CurrentBufferIndex ], 0 };
+		uint32_t signalCount = m_Headless ? 1 : 2;
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.waitSemaphoreValueCount = m_SubmitWaits.GetCount();
+		timelineInfo.pWaitSemaphoreValues = m_SubmitWaits.Values.data();
+		timelineInfo.signalSemaphoreValueCount = signalCount;
+		timelineInfo.pSignalSemaphoreValues = signalValues;
 
 		VkSubmitInfo submitInfo{};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineInfo;
 
-		VkSemaphore waitSemaphores[] = { m_WaitSemaphores[ m_CurrentBufferIndex ] };
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = waitSemaphores;
-
-		VkPipelineStageFlags waitStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		submitInfo.pWaitDstStageMask = &waitStages;
+		submitInfo.waitSemaphoreCount = m_SubmitWaits.GetCount();
+		submitInfo.pWaitSemaphores = m_SubmitWaits.Semaphores.data();
+		submitInfo.pWaitDstStageMask = m_SubmitWaits.Stages.data();
 
-		VkSemaphore signalSemaphores[] = { m_SignalSemaphores[ m_CurrentBufferIndex ] };
-		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.signalSemaphoreCount = signalCount;
 		submitInfo.pSignalSemaphores = signalSemaphores;
 
 		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &m_CommandBuffers[ m_CurrentImageIndex ];
+		submitInfo.pCommandBuffers = &commandBuffer;
 
-		VK_CHECK_RESULT( vkResetFences( logicalDevice, 1, &m_WaitInFlightFences[ m_CurrentBufferIndex ] ) );
-		VK_CHECK_RESULT( vkQueueSubmit( graphicsQueue, 1, &submitInfo, m_WaitInFlightFences[ m_CurrentBufferIndex ] ) );
-
-		VkPresentInfoKHR presentInfo = {};
-		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-		presentInfo.pNext = nullptr;
-		presentInfo.waitSemaphoreCount = 1;
-		presentInfo.pWaitSemaphores = signalSemaphores;
-		presentInfo.swapchainCount = 1;
-		presentInfo.pSwapchains = &m_SwapChain;
-		presentInfo.pImageIndices = &m_CurrentImageIndex;
-
-		result = vkQueuePresentKHR( graphicsQueue, &presentInfo );
+		{
+			VE_PROFILE_SCOPE( "Submit frame" );
+			VK_CHECK_RESULT( vkQueueSubmit( graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE ) );
+		}
 
-		if ( result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR )
+		uint64_t completedValue = timeline.GetCompletedValue();
+		statistics.GPUFramesInFlight = 0;
+		for ( uint32_t i = 0; i < m_FramesInFlight; i++ )
 		{
-			OnResize( m_Width, m_Height );
+			if ( i != m_CurrentBufferIndex && m_FrameTimelineValues[ i ] > completedValue )
+				statistics.GPUFramesInFlight++;
 		}
-		else if ( result != VK_SUCCESS )
+
+		if ( !m_Headless )
 		{
-			VK_CHECK_RESULT( result );
+			VkPresentInfoKHR presentInfo = {};
+			presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+			presentInfo.pNext = nullptr;
+			presentInfo.waitSemaphoreCount = 1;
+			presentInfo.pWaitSemaphores = &m_SignalSemaphores[ m_CurrentBufferIndex ];
+			presentInfo.swapchainCount = 1;
+			presentInfo.pSwapchains = &m_SwapChain;
+			presentInfo.pImageIndices = &m_CurrentImageIndex;
+
+			VkResult result;
+			{
+				VE_PROFILE_SCOPE( "Present" );
+				result = vkQueuePresentKHR( graphicsQueue, &presentInfo );
+			}
+
+			if ( result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR )
+			{
+				OnResize( m_Width, m_Height );
+			}
+			else if ( result != VK_SUCCESS )
+			{
+				VK_CHECK_RESULT( result );
+			}
 		}
 
-		m_CurrentBufferIndex = ( m_CurrentBufferIndex + 1 ) % MAX_FRAMES_IN_FLIGHT;
-		VK_CHECK_RESULT( vkWaitForFences( logicalDevice, 1, &m_WaitInFlightFences[ m_CurrentBufferIndex ], VK_TRUE, UINT64_MAX ) );
+		// Move on without waiting, the next slot is only waited on when it is about to be reused
+		m_LastBufferIndex = m_CurrentBufferIndex;
+		m_CurrentBufferIndex = ( m_CurrentBufferIndex + 1 ) % m_FramesInFlight;
+		m_FrameNumber++;
+	}
+
+	void VulkanSwapChain::SubmitParallel( uint32_t count, VulkanCommandRecorder::RecordFunc&& record )
+	{
+		m_ParallelWork.push_back( { count, std::move( record ) } );
 	}
 
 	void VulkanSwapChain::OnResize( uint32_t width, uint32_t height )
 	{
-		auto device = m_LogicalDevice->GetVulkanLogicalDevice();
+		VE_PROFILE_FUNCTION();
 
-		glfwWaitEvents();
-		vkDeviceWaitIdle( device );
+		// Resize events arrive at event rate while a window is dragged, only the last size of a frame is used
+		m_ResizePending = true;
+		m_PendingWidth = width;
+		m_PendingHeight = height;
+	}
 
-		CleanUpSwapChain();
+	void VulkanSwapChain::SetVSync( bool vsync )
+	{
+		if ( vsync == m_VSync || m_Headless )
+			return;
+
+		m_VSync = vsync;
+
+		// A pending resize recreates the swapchain anyway and has the newer size
+		if ( !m_ResizePending )
+			OnResize( m_Width, m_Height );
+	}
+
+	void VulkanSwapChain::Recreate()
+	{
+		VE_PROFILE_FUNCTION();
+
+		if ( m_PendingWidth == 0 || m_PendingHeight == 0 )
+			return;
 
-		CreateSwapChain( &width, &height, m_VSync );
+		m_ResizePending = false;
+
+		// Frames still in flight in the other slots may reference the old objects, so they are released through
+		// the current slot's queue. Those frames have all completed by the time this slot's fence is waited on again.
+		for ( auto& buffer : m_SwapChainBuffers )
+		{
+			VulkanResourceRelease::ImageView( buffer.ImageView );
+		}
+
+		uint32_t width = m_PendingWidth, height = m_PendingHeight;
+		if ( m_Headless )
+		{
+			for ( uint32_t i = 0; i < m_ImageCount; i++ )
+			{
+				VulkanResourceRelease::Image( m_SwapChainImages[ i ], m_OffscreenAllocations[ i ] );
+			}
+
+			CreateOffscreenImages( width, height );
+		}
+		else
+		{
+			VulkanResourceRelease::SwapChain( m_SwapChain );
+
+			// The old swapchain is handed to the new one through oldSwapchain, so presentation keeps running
+			// and nothing has to wait for the device to go idle
+			CreateSwapChain( &width, &height, m_VSync );
+		}
 		CreateImageViews();
-		CreateRenderPass();
-		CreateFramebuffers();
-		CreateCommandBuffers();
 
-		m_ImageInFlightFences.resize( m_SwapChainImages.size(), VK_NULL_HANDLE );
+		// The graph keeps its render pass when only the size changed, framebuffers and transient textures are
+		// released through the same queue
+		BuildRenderGraph();
 	}
 
 	void VulkanSwapChain::CleanUp()
 	{
 		auto device = m_LogicalDevice->GetVulkanLogicalDevice();
 
+		// Up to m_FramesInFlight frames may still be executing
+		vkDeviceWaitIdle( device );
+
 		CleanUpSwapChain();
 
-		for ( size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
+		for ( size_t i = 0; i < m_FramesInFlight; i++ )
 		{
 			vkDestroySemaphore( device, m_SignalSemaphores[ i ], nullptr );
 			vkDestroySemaphore( device, m_WaitSemaphores[ i ], nullptr );
-			vkDestroyFence( device, m_WaitInFlightFences[ i ], nullptr );
 		}
 
-		vkDestroyCommandPool( device, m_CommandPool, nullptr );
-		vkDestroySurfaceKHR( m_Instance, m_Surface, nullptr );
+		m_CommandRecorder.reset();
+		for ( auto commandPool : m_CommandPools )
+		{
+			vkDestroyCommandPool( device, commandPool, nullptr );
+		}
+		if ( m_Surface )
+			vkDestroySurfaceKHR( m_Instance, m_Surface, nullptr );
 	}
 
 	VulkanSwapChain::SwapChainSupportDetails VulkanSwapChain::QuerySwapChainSupport( VkPhysicalDevice device )
@@ -287,6 +439,7 @@ namespace VE
 		createInfo.compositeAlpha = compositeAlpha;
 		createInfo.presentMode = presentMode;
 		createInfo.clipped = VK_TRUE;
+		createInfo.oldSwapchain = m_SwapChain;
 
 		VK_CHECK_RESULT( vkCreateSwapchainKHR( logicalDevice, &createInfo, nullptr, &m_SwapChain ) );
 
@@ -295,6 +448,36 @@ namespace VE
 		VK_CHECK_RESULT( vkGetSwapchainImagesKHR( logicalDevice, m_SwapChain, &m_ImageCount, m_SwapChainImages.data() ) );
 	}
 
+	void VulkanSwapChain::CreateOffscreenImages( uint32_t width, uint32_t height )
+	{
+		m_Width = width;
+		m_Height = height;
+		m_SwapChainImageFormat = VK_FORMAT_B8G8R8A8_UNORM;
+		m_ImageCount = m_FramesInFlight;
+
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.format = m_SwapChainImageFormat;
+		imageInfo.extent = { width, height, 1 };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		auto& allocator = m_LogicalDevice->GetAllocator();
+
+		m_SwapChainImages.resize( m_ImageCount );
+		m_OffscreenAllocations.resize( m_ImageCount );
+		for ( uint32_t i = 0; i < m_ImageCount; i++ )
+		{
+			m_OffscreenAllocations[ i ] = allocator.AllocateImage( imageInfo, VulkanMemoryUsage::GPUOnly, m_SwapChainImages[ i ] );
+		}
+	}
+
 	void VulkanSwapChain::CreateImageViews()
 	{
 		m_SwapChainBuffers.resize( m_ImageCount );
@@ -324,70 +507,33 @@ namespace VE
 		}
 	}
 
-	void VulkanSwapChain::CreateRenderPass()
+	void VulkanSwapChain::BuildRenderGraph()
 	{
-		VkAttachmentDescription colorAttachment{};
-		colorAttachment.format = m_SwapChainImageFormat;
-		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-		VkAttachmentReference colorAttachmentRef{};
-		colorAttachmentRef.attachment = 0;
-		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-		VkSubpassDescription subpass{};
-		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-		subpass.colorAttachmentCount = 1;
-		subpass.pColorAttachments = &colorAttachmentRef;
-
-		VkSubpassDependency dependency{};
-		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-		dependency.dstSubpass = 0;
-		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		dependency.srcAccessMask = 0;
-		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-		VkRenderPassCreateInfo renderPassInfo{};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-		renderPassInfo.attachmentCount = 1;
-		renderPassInfo.pAttachments = &colorAttachment;
-		renderPassInfo.subpassCount = 1;
-		renderPassInfo.pSubpasses = &subpass;
-		renderPassInfo.dependencyCount = 1;
-		renderPassInfo.pDependencies = &dependency;
-
-		VK_CHECK_RESULT( vkCreateRenderPass( m_LogicalDevice->GetVulkanLogicalDevice(), &renderPassInfo, nullptr, &m_RenderPass ) );
-	}
-
-	void VulkanSwapChain::CreateFramebuffers()
-	{
-		auto logicalDevice = m_LogicalDevice->GetVulkanLogicalDevice();
-
-		m_SwapChainFramebuffers.resize( m_SwapChainBuffers.size() );
-
-		VkImageView attachments[ 1 ];
-
-		VkFramebufferCreateInfo framebufferInfo{};
-		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-		framebufferInfo.pNext = nullptr;
-		framebufferInfo.renderPass = m_RenderPass;
-		framebufferInfo.attachmentCount = 1;
-		framebufferInfo.pAttachments = attachments;
-		framebufferInfo.width = m_Width;
-		framebufferInfo.height = m_Height;
-		framebufferInfo.layers = 1;
+		if ( !m_RenderGraph )
+			m_RenderGraph = CreateScope<VulkanRenderGraph>( m_LogicalDevice.get() );
+
+		m_RenderGraph->Clear();
+
+		RenderGraphTextureDesc backBufferDesc;
+		backBufferDesc.Width = m_Width;
+		backBufferDesc.Height = m_Height;
+		backBufferDesc.Format = m_SwapChainImageFormat;
+		// Offscreen images are left ready to be copied out, e.g. for image comparisons
+		VkImageLayout finalLayout = m_Headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		m_BackBuffer = m_RenderGraph->ImportTexture( "BackBuffer", backBufferDesc, VK_IMAGE_LAYOUT_UNDEFINED, finalLayout );
+
+		m_SwapChainPass = &m_RenderGraph->AddGraphicsPass( "SwapChain" );
+		m_SwapChainPass->WriteColor( m_BackBuffer, RenderGraphLoadOp::Clear, { { 0.0f, 0.0f, 0.0f, 1.0f } } );
+		m_SwapChainPass->SetExecute( [this]( VkCommandBuffer commandBuffer, const VkCommandBufferInheritanceInfo& inheritance )
+			{
+				for ( auto& work : m_ParallelWork )
+				{
+					m_CommandRecorder->RecordParallel( commandBuffer, inheritance, work.Count, work.Record );
+				}
+				m_ParallelWork.clear();
+			} );
 
-		for ( size_t i = 0; i < m_SwapChainBuffers.size(); i++ )
-		{
-			attachments[ 0 ] = m_SwapChainBuffers[ i ].ImageView;
-			VK_CHECK_RESULT( vkCreateFramebuffer( logicalDevice, &framebufferInfo, nullptr, &m_SwapChainFramebuffers[ i ] ) );
-		}
+		m_RenderGraph->Compile();
 	}
 
 	void VulkanSwapChain::CreateCommandPool()
@@ -409,8 +555,10 @@ namespace VE
 			if ( queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT )
 				graphicsQueueFamilyIndex = i;
 
-			VkBool32 presentSupport = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR( physicalDevice, i, m_Surface, &presentSupport );
+			// Without a surface there is nothing to present to, the graphics queue is all that is needed
+			VkBool32 presentSupport = m_Headless;
+			if ( !m_Headless )
+				vkGetPhysicalDeviceSurfaceSupportKHR( physicalDevice, i, m_Surface, &presentSupport );
 			if ( presentSupport )
 				presentQueueFamilyIndex = i;
 
@@ -426,80 +574,69 @@ namespace VE
 		VkCommandPoolCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 		createInfo.queueFamilyIndex = graphicsQueueFamilyIndex;
-		createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
 
-		VK_CHECK_RESULT( vkCreateCommandPool( m_LogicalDevice->GetVulkanLogicalDevice(), &createInfo, nullptr, &m_CommandPool ) );
+		m_CommandPools.resize( m_FramesInFlight );
+		for ( auto& commandPool : m_CommandPools )
+		{
+			VK_CHECK_RESULT( vkCreateCommandPool( m_LogicalDevice->GetVulkanLogicalDevice(), &createInfo, nullptr, &commandPool ) );
+		}
+
+		m_CommandRecorder = CreateScope<VulkanCommandRecorder>( m_LogicalDevice.get(), m_FramesInFlight );
 	}
 
 	void VulkanSwapChain::CreateCommandBuffers()
 	{
-		m_CommandBuffers.resize( m_ImageCount );
-
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.commandPool = m_CommandPool;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandBufferCount = ( uint32_t )m_CommandBuffers.size();
+		m_CommandBuffers.resize( m_FramesInFlight );
 
-		VK_CHECK_RESULT( vkAllocateCommandBuffers( m_LogicalDevice->GetVulkanLogicalDevice(), &allocInfo, m_CommandBuffers.data() ) );
-
-		//for ( size_t i = 0; i < m_CommandBuffers.size(); i++ )
-		//{
-		//	VkCommandBufferBeginInfo beginInfo{};
-		//	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-
-		//	if ( vkBeginCommandBuffer( m_CommandBuffers[ i ], &beginInfo ) != VK_SUCCESS )
-		//	{
-		//		throw std::runtime_error( "failed to begin recording command buffer!" );
-		//	}
-
-		//	VkRenderPassBeginInfo renderPassInfo{};
-		//	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		//	renderPassInfo.renderPass = renderPass;
-		//	renderPassInfo.framebuffer = m_SwapChainFramebuffers[ i ];
-		//	renderPassInfo.renderArea.offset = { 0, 0 };
-		//	renderPassInfo.renderArea.extent = m_SwapChainExtent;
+		for ( uint32_t i = 0; i < m_FramesInFlight; i++ )
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = m_CommandPools[ i ];
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
 
-		//	VkClearValue clearColor = { {{0.0f, 0.0f, 0.0f, 1.0f}} };
-		//	renderPassInfo.clearValueCount = 1;
-		//	renderPassInfo.pClearValues = &clearColor;
+			VK_CHECK_RESULT( vkAllocateCommandBuffers( m_LogicalDevice->GetVulkanLogicalDevice(), &allocInfo, &m_CommandBuffers[ i ] ) );
+		}
+	}
 
-		//	vkCmdBeginRenderPass( m_CommandBuffers[ i ], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE );
+	void VulkanSwapChain::RecordCommandBuffer( VkCommandBuffer commandBuffer )
+	{
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VK_CHECK_RESULT( vkBeginCommandBuffer( commandBuffer, &beginInfo ) );
 
-		//	vkCmdBindPipeline( m_CommandBuffers[ i ], VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipeline );
+		auto& gpuProfiler = m_LogicalDevice->GetGPUProfiler();
+		gpuProfiler.BeginFrame( m_CurrentBufferIndex, commandBuffer );
 
-		//	vkCmdDraw( m_CommandBuffers[ i ], 3, 1, 0, 0 );
+		m_LogicalDevice->GetUploadManager().RecordOwnershipAcquire( commandBuffer, m_SubmitWaits );
 
-		//	vkCmdEndRenderPass( m_CommandBuffers[ i ] );
+		m_RenderGraph->SetImportedTexture( m_BackBuffer, m_SwapChainBuffers[ m_CurrentImageIndex ].Image, m_SwapChainBuffers[ m_CurrentImageIndex ].ImageView );
+		m_SwapChainPass->SetSubpassContents( m_ParallelWork.empty() ? VK_SUBPASS_CONTENTS_INLINE : VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS );
+		m_RenderGraph->Execute( commandBuffer );
 
-		//	if ( vkEndCommandBuffer( m_CommandBuffers[ i ] ) != VK_SUCCESS )
-		//	{
-		//		throw std::runtime_error( "failed to record command buffer!" );
-		//	}
-		//}
+		gpuProfiler.EndFrame( commandBuffer );
+		VK_CHECK_RESULT( vkEndCommandBuffer( commandBuffer ) );
 	}
 
 	void VulkanSwapChain::CreateSyncObjects()
 	{
-		m_WaitSemaphores.resize( MAX_FRAMES_IN_FLIGHT );
-		m_SignalSemaphores.resize( MAX_FRAMES_IN_FLIGHT );
-		m_WaitInFlightFences.resize( MAX_FRAMES_IN_FLIGHT );
-		m_ImageInFlightFences.resize( m_SwapChainImages.size(), VK_NULL_HANDLE );
+		m_WaitSemaphores.resize( m_FramesInFlight );
+		m_SignalSemaphores.resize( m_FramesInFlight );
+		m_FrameTimelineValues.resize( m_FramesInFlight, 0 );
+		m_FrameStatistics.resize( m_FramesInFlight );
 
 		VkSemaphoreCreateInfo semaphoreInfo{};
 		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-		VkFenceCreateInfo fenceInfo{};
-		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
 		auto logicalDevice = m_LogicalDevice->GetVulkanLogicalDevice();
 
-		for ( size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
+		for ( size_t i = 0; i < m_FramesInFlight; i++ )
 		{
 			VK_CHECK_RESULT( vkCreateSemaphore( logicalDevice, &semaphoreInfo, nullptr, &m_WaitSemaphores[ i ] ) );
 			VK_CHECK_RESULT( vkCreateSemaphore( logicalDevice, &semaphoreInfo, nullptr, &m_SignalSemaphores[ i ] ) );
-			VK_CHECK_RESULT( vkCreateFence( logicalDevice, &fenceInfo, nullptr, &m_WaitInFlightFences[ i ] ) );
 		}
 	}
 
@@ -507,21 +644,24 @@ namespace VE
 	{
 		auto device = m_LogicalDevice->GetVulkanLogicalDevice();
 
-		for ( auto framebuffer : m_SwapChainFramebuffers )
-		{
-			vkDestroyFramebuffer( device, framebuffer, nullptr );
-		}
-
-		vkFreeCommandBuffers( device, m_CommandPool, static_cast< uint32_t >( m_CommandBuffers.size() ), m_CommandBuffers.data() );
-
-		vkDestroyRenderPass( device, m_RenderPass, nullptr );
+		m_RenderGraph.reset();
 
 		for ( uint32_t i = 0; i < m_ImageCount; i++ )
 		{
 			vkDestroyImageView( device, m_SwapChainBuffers[ i ].ImageView, nullptr );
 		}
 
-		vkDestroySwapchainKHR( device, m_SwapChain, nullptr );
+		if ( m_Headless )
+		{
+			for ( uint32_t i = 0; i < m_ImageCount; i++ )
+			{
+				m_LogicalDevice->GetAllocator().DestroyImage( m_SwapChainImages[ i ], m_OffscreenAllocations[ i ] );
+			}
+		}
+		else
+		{
+			vkDestroySwapchainKHR( device, m_SwapChain, nullptr );
+		}
 	}
 
 }
@@ -2,26 +2,76 @@
 
 #include "Platform/Vulkan/Vulkan.h"
 #include "Platform/Vulkan/VulkanDevice.h"
+#include "Platform/Vulkan/VulkanCommandRecorder.h"
+#include "Platform/Vulkan/VulkanRenderGraph.h"
 
-#include <GLFW/glfw3.h>
+#include "Core/Timer.h"
+
+struct GLFWwindow;
 
 namespace VE
 {
 	class VulkanSwapChain
 	{
+	public:
+		struct FrameStatistics
+		{
+			uint64_t FrameNumber = 0;
+			// Time the CPU spent blocked on the GPU before it could start recording this frame
+			float CPUWaitTime = 0.0f;
+			// Time between the start of this frame and the start of the previous one
+			float CPUFrameTime = 0.0f;
+			// Number of earlier frames the GPU was still executing when this frame was submitted
+			uint32_t GPUFramesInFlight = 0;
+		};
+
 	public:
 		VulkanSwapChain() = default;
 
 		void Init( VkInstance instance, const Ref<VulkanLogicalDevice>& logicalDevice );
 		void CreateSurface( GLFWwindow* window );
 		void Create( uint32_t* width, uint32_t* height, bool vsync );
+		// Renders into one offscreen color image per frame in flight instead of presenting to a surface.
+		// The images are left in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL.
+		void CreateHeadless( uint32_t width, uint32_t height );
 
 		void DrawFrame();
 
 		void OnResize( uint32_t width, uint32_t height );
+		// Render thread: the present mode is fixed at creation, so this recreates the swapchain before the next frame
+		void SetVSync( bool vsync );
+
+		// Render thread: records count items into the swapchain render pass of the next frame, split across
+		// the job system workers into secondary command buffers
+		void SubmitParallel( uint32_t count, VulkanCommandRecorder::RecordFunc&& record );
 
 		void CleanUp();
 
+		uint32_t GetFramesInFlight() const
+		{
+			return m_FramesInFlight;
+		}
+		uint32_t GetCurrentBufferIndex() const
+		{
+			return m_CurrentBufferIndex;
+		}
+		const FrameStatistics& GetFrameStatistics() const
+		{
+			return m_FrameStatistics[ m_LastBufferIndex ];
+		}
+		VulkanCommandRecorder& GetCommandRecorder()
+		{
+			return *m_CommandRecorder;
+		}
+		VulkanRenderGraph& GetRenderGraph()
+		{
+			return *m_RenderGraph;
+		}
+		bool IsHeadless() const
+		{
+			return m_Headless;
+		}
+
 	private:
 		struct SwapChainSupportDetails
 		{
@@ -35,22 +85,27 @@ namespace VE
 		VkPresentModeKHR ChooseSwapPresentMode( const std::vector<VkPresentModeKHR>& presentModes );
 		VkExtent2D ChooseSwapExtent( const VkSurfaceCapabilitiesKHR& capabilities );
 
+		void Recreate();
+
 		void CreateSwapChain( uint32_t* width, uint32_t* height, bool vsync );
+		void CreateOffscreenImages( uint32_t width, uint32_t height );
 		void CreateImageViews();
-		void CreateRenderPass();
-		void CreateFramebuffers();
+		void BuildRenderGraph();
 		void CreateCommandPool();
 		void CreateCommandBuffers();
 		void CreateSyncObjects();
 		void CleanUpSwapChain();
 
+		void RecordCommandBuffer( VkCommandBuffer commandBuffer );
+
 	private:
 		VkInstance m_Instance;
 		Ref<VulkanLogicalDevice> m_LogicalDevice;
 
-		VkSurfaceKHR m_Surface;
-		GLFWwindow* m_Window;
+		VkSurfaceKHR m_Surface = nullptr;
+		GLFWwindow* m_Window = nullptr;
 		bool m_VSync = false;
+		bool m_Headless = false;
 
 		uint32_t m_Width = 0, m_Height = 0;
 
@@ -58,9 +113,13 @@ namespace VE
 		uint32_t m_ImageCount = 0;
 		std::vector<VkImage> m_SwapChainImages;
 		VkFormat m_SwapChainImageFormat;
+		// Headless only, the images are owned by the swapchain object instead of a VkSwapchainKHR
+		std::vector<VulkanAllocation*> m_OffscreenAllocations;
 
-		VkRenderPass m_RenderPass;
-		std::vector<VkFramebuffer> m_SwapChainFramebuffers;
+		// Owns the render pass and framebuffers, the swapchain image is imported into it every frame
+		Scope<VulkanRenderGraph> m_RenderGraph;
+		RenderGraphResource m_BackBuffer = 0;
+		VulkanRenderGraphPass* m_SwapChainPass = nullptr;
 
 		struct SwapChainBuffer
 		{
@@ -69,15 +128,35 @@ namespace VE
 		};
 		std::vector<SwapChainBuffer> m_SwapChainBuffers;
 
-		VkCommandPool m_CommandPool = nullptr;
+		bool m_ResizePending = false;
+		uint32_t m_PendingWidth = 0, m_PendingHeight = 0;
+
+		// One pool and primary buffer per frame in flight. The pool is reset whole once the frame has completed.
+		std::vector<VkCommandPool> m_CommandPools;
 		std::vector<VkCommandBuffer> m_CommandBuffers;
+		Scope<VulkanCommandRecorder> m_CommandRecorder;
+
+		struct ParallelWork
+		{
+			uint32_t Count;
+			VulkanCommandRecorder::RecordFunc Record;
+		};
+		std::vector<ParallelWork> m_ParallelWork;
 
 		std::vector<VkSemaphore> m_WaitSemaphores;
 		std::vector<VkSemaphore> m_SignalSemaphores;
-		std::vector<VkFence> m_WaitInFlightFences;
-		std::vector<VkFence> m_ImageInFlightFences;
+		// Graphics timeline value signalled by the last submission from each frame slot
+		std::vector<uint64_t> m_FrameTimelineValues;
+		// Image acquire plus any upload batches and compute passes the frame's command buffer consumes
+		VulkanSemaphoreWaitList m_SubmitWaits;
 
+		uint32_t m_FramesInFlight = 0;
 		uint32_t m_CurrentBufferIndex = 0;
+		uint32_t m_LastBufferIndex = 0;
 		uint32_t m_CurrentImageIndex = 0;
+
+		uint64_t m_FrameNumber = 0;
+		Timer m_FrameTimer;
+		std::vector<FrameStatistics> m_FrameStatistics;
 	};
 }
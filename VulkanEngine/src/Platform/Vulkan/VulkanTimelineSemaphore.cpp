@@ -0,0 +1,70 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanTimelineSemaphore.h"
+
+namespace VE
+{
+
+	VulkanTimelineSemaphore::VulkanTimelineSemaphore( VkDevice device )
+		: m_Device( device )
+	{
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+		VK_CHECK_RESULT( vkCreateSemaphore( m_Device, &semaphoreInfo, nullptr, &m_Semaphore ) );
+	}
+
+	VulkanTimelineSemaphore::~VulkanTimelineSemaphore()
+	{
+		vkDestroySemaphore( m_Device, m_Semaphore, nullptr );
+	}
+
+	uint64_t VulkanTimelineSemaphore::GetCompletedValue()
+	{
+		uint64_t value;
+		VK_CHECK_RESULT( vkGetSemaphoreCounterValue( m_Device, m_Semaphore, &value ) );
+		UpdateCompletedValue( value );
+		return value;
+	}
+
+	bool VulkanTimelineSemaphore::IsComplete( uint64_t value )
+	{
+		if ( value <= m_CompletedValue )
+			return true;
+
+		return value <= GetCompletedValue();
+	}
+
+	void VulkanTimelineSemaphore::Wait( uint64_t value, uint64_t timeout )
+	{
+		if ( value <= m_CompletedValue )
+			return;
+
+		VE_ASSERT( value <= m_Value, "Waiting for a timeline value that has not been submitted!" );
+
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &m_Semaphore;
+		waitInfo.pValues = &value;
+
+		VkResult result = vkWaitSemaphores( m_Device, &waitInfo, timeout );
+		if ( result == VK_TIMEOUT )
+			return;
+		VK_CHECK_RESULT( result );
+
+		UpdateCompletedValue( value );
+	}
+
+	void VulkanTimelineSemaphore::UpdateCompletedValue( uint64_t value )
+	{
+		uint64_t completed = m_CompletedValue;
+		while ( completed < value && !m_CompletedValue.compare_exchange_weak( completed, value ) )
+			;
+	}
+
+}
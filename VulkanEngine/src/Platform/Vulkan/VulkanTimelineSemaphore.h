@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+
+#include <atomic>
+
+namespace VE
+{
+	// A timeline semaphore whose value only ever increases. Every submission to the owning queue signals the
+	// next value, so a single semaphore replaces the fence and binary semaphore that were needed per
+	// submission: the CPU waits for or polls a value, other queues wait for it on the GPU.
+	class VulkanTimelineSemaphore
+	{
+	public:
+		VulkanTimelineSemaphore( VkDevice device );
+		~VulkanTimelineSemaphore();
+
+		VulkanTimelineSemaphore( const VulkanTimelineSemaphore& ) = delete;
+		VulkanTimelineSemaphore& operator=( const VulkanTimelineSemaphore& ) = delete;
+
+		VkSemaphore GetSemaphore() const
+		{
+			return m_Semaphore;
+		}
+
+		// Reserves the value the next submission will signal. Submissions to a queue must signal in order.
+		uint64_t Next()
+		{
+			return ++m_Value;
+		}
+		uint64_t GetSubmittedValue() const
+		{
+			return m_Value;
+		}
+		uint64_t GetCompletedValue();
+
+		bool IsComplete( uint64_t value );
+		void Wait( uint64_t value, uint64_t timeout = UINT64_MAX );
+
+	private:
+		void UpdateCompletedValue( uint64_t value );
+
+	private:
+		VkDevice m_Device;
+		VkSemaphore m_Semaphore = nullptr;
+
+		std::atomic<uint64_t> m_Value = 0;
+		// Cached so that polling values that are known to be complete does not call into the driver
+		std::atomic<uint64_t> m_CompletedValue = 0;
+	};
+
+	// The semaphores a queue submission waits on. Binary semaphores are added with a value of 0.
+	struct VulkanSemaphoreWaitList
+	{
+		std::vector<VkSemaphore> Semaphores;
+		std::vector<VkPipelineStageFlags> Stages;
+		std::vector<uint64_t> Values;
+
+		void Add( VkSemaphore semaphore, VkPipelineStageFlags stage, uint64_t value = 0 )
+		{
+			Semaphores.push_back( semaphore );
+			Stages.push_back( stage );
+			Values.push_back( value );
+		}
+
+		void Clear()
+		{
+			Semaphores.clear();
+			Stages.clear();
+			Values.clear();
+		}
+
+		uint32_t GetCount() const
+		{
+			return ( uint32_t )Semaphores.size();
+		}
+	};
+}
@@ -0,0 +1,398 @@
+#include "vepch.h"
+#include "Platform/Vulkan/VulkanUploadManager.h"
+
+#include "Platform/Vulkan/VulkanDevice.h"
+
+namespace VE
+{
+
+	static constexpr VkDeviceSize s_StagingAlignment = 16;
+
+	static VkDeviceSize AlignUp( VkDeviceSize value, VkDeviceSize alignment )
+	{
+		return ( value + alignment - 1 ) & ~( alignment - 1 );
+	}
+
+	VulkanUploadManager::VulkanUploadManager( VulkanLogicalDevice* device, VkDeviceSize stagingSize )
+		: m_Device( device ), m_RingSize( stagingSize )
+	{
+		const auto& queueFamilyIndices = m_Device->GetPhysicalDevice()->GetQueueFamilyIndices();
+		m_TransferFamily = queueFamilyIndices.Transfer;
+		m_GraphicsFamily = queueFamilyIndices.Graphics;
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.queueFamilyIndex = m_TransferFamily;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		VK_CHECK_RESULT( vkCreateCommandPool( m_Device->GetVulkanLogicalDevice(), &poolInfo, nullptr, &m_CommandPool ) );
+
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = m_RingSize;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		m_StagingAllocation = m_Device->GetAllocator().AllocateBuffer( bufferInfo, VulkanMemoryUsage::CPUToGPU, m_StagingBuffer );
+
+		m_RecordingBatch.Token = m_NextToken++;
+	}
+
+	VulkanUploadManager::~VulkanUploadManager()
+	{
+		VkDevice device = m_Device->GetVulkanLogicalDevice();
+		auto& allocator = m_Device->GetAllocator();
+
+		// The device is idle at this point
+		auto destroyBatch = [&]( UploadBatch& batch )
+		{
+			for ( auto& [buffer, allocation] : batch.TemporaryBuffers )
+			{
+				allocator.DestroyBuffer( buffer, allocation );
+			}
+		};
+
+		destroyBatch( m_RecordingBatch );
+		for ( auto& batch : m_InFlightBatches )
+		{
+			destroyBatch( batch );
+		}
+
+		vkDestroyCommandPool( device, m_CommandPool, nullptr );
+		allocator.DestroyBuffer( m_StagingBuffer, m_StagingAllocation );
+	}
+
+	UploadToken VulkanUploadManager::UploadBuffer( VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess )
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		VkDeviceSize stagingOffset;
+		void* stagingData;
+		VkBuffer source = AllocateStaging( size, stagingOffset, stagingData );
+		memcpy( stagingData, data, size );
+
+		BufferCopy copy{};
+		copy.Source = source;
+		copy.Destination = buffer;
+		copy.Region.srcOffset = stagingOffset;
+		copy.Region.dstOffset = offset;
+		copy.Region.size = size;
+		copy.DstStage = dstStage;
+		copy.DstAccess = dstAccess;
+		m_RecordingBatch.BufferCopies.push_back( copy );
+
+		return { m_RecordingBatch.Token };
+	}
+
+	UploadToken VulkanUploadManager::UploadImage( VkImage image, const void* data, VkDeviceSize size, const std::vector<VkBufferImageCopy>& regions, const VkImageSubresourceRange& range,
+		VkImageLayout finalLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess )
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		VkDeviceSize stagingOffset;
+		void* stagingData;
+		VkBuffer source = AllocateStaging( size, stagingOffset, stagingData );
+		memcpy( stagingData, data, size );
+
+		ImageCopy copy{};
+		copy.Source = source;
+		copy.Destination = image;
+		copy.Regions = regions;
+		for ( auto& region : copy.Regions )
+		{
+			region.bufferOffset += stagingOffset;
+		}
+		copy.Range = range;
+		copy.FinalLayout = finalLayout;
+		copy.DstStage = dstStage;
+		copy.DstAccess = dstAccess;
+		m_RecordingBatch.ImageCopies.push_back( std::move( copy ) );
+
+		return { m_RecordingBatch.Token };
+	}
+
+	void VulkanUploadManager::Flush()
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		ReclaimCompletedBatches();
+
+		UploadBatch& batch = m_RecordingBatch;
+		if ( batch.BufferCopies.empty() && batch.ImageCopies.empty() )
+			return;
+
+		if ( !m_FreeCommandBuffers.empty() )
+		{
+			batch.CommandBuffer = m_FreeCommandBuffers.back();
+			m_FreeCommandBuffers.pop_back();
+		}
+		else
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = m_CommandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+			VK_CHECK_RESULT( vkAllocateCommandBuffers( m_Device->GetVulkanLogicalDevice(), &allocInfo, &batch.CommandBuffer ) );
+		}
+
+		const bool ownershipTransfer = m_TransferFamily != m_GraphicsFamily;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VK_CHECK_RESULT( vkBeginCommandBuffer( batch.CommandBuffer, &beginInfo ) );
+
+		std::vector<VkImageMemoryBarrier> imageBarriers;
+		for ( auto& copy : batch.ImageCopies )
+		{
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = copy.Destination;
+			barrier.subresourceRange = copy.Range;
+			imageBarriers.push_back( barrier );
+		}
+		if ( !imageBarriers.empty() )
+			vkCmdPipelineBarrier( batch.CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, ( uint32_t )imageBarriers.size(), imageBarriers.data() );
+
+		for ( auto& copy : batch.BufferCopies )
+		{
+			vkCmdCopyBuffer( batch.CommandBuffer, copy.Source, copy.Destination, 1, &copy.Region );
+		}
+		for ( auto& copy : batch.ImageCopies )
+		{
+			vkCmdCopyBufferToImage( batch.CommandBuffer, copy.Source, copy.Destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, ( uint32_t )copy.Regions.size(), copy.Regions.data() );
+		}
+
+		// With an ownership transfer the release half is recorded here and the identical acquire half on the
+		// graphics queue. Otherwise a single barrier makes the writes available to the consuming stages.
+		PendingAcquire acquire;
+		std::vector<VkBufferMemoryBarrier> releaseBufferBarriers;
+		std::vector<VkImageMemoryBarrier> releaseImageBarriers;
+		VkPipelineStageFlags releaseDstStage = ownershipTransfer ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : 0;
+
+		for ( auto& copy : batch.BufferCopies )
+		{
+			VkBufferMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = ownershipTransfer ? 0 : copy.DstAccess;
+			barrier.srcQueueFamilyIndex = ownershipTransfer ? m_TransferFamily : VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = ownershipTransfer ? m_GraphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+			barrier.buffer = copy.Destination;
+			barrier.offset = copy.Region.dstOffset;
+			barrier.size = copy.Region.size;
+			releaseBufferBarriers.push_back( barrier );
+
+			if ( ownershipTransfer )
+			{
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = copy.DstAccess;
+				acquire.BufferBarriers.push_back( barrier );
+			}
+			else
+			{
+				releaseDstStage |= copy.DstStage;
+			}
+			acquire.DstStage |= copy.DstStage;
+		}
+
+		for ( auto& copy : batch.ImageCopies )
+		{
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = ownershipTransfer ? 0 : copy.DstAccess;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = copy.FinalLayout;
+			barrier.srcQueueFamilyIndex = ownershipTransfer ? m_TransferFamily : VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = ownershipTransfer ? m_GraphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = copy.Destination;
+			barrier.subresourceRange = copy.Range;
+			releaseImageBarriers.push_back( barrier );
+
+			if ( ownershipTransfer )
+			{
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = copy.DstAccess;
+				acquire.ImageBarriers.push_back( barrier );
+			}
+			else
+			{
+				releaseDstStage |= copy.DstStage;
+			}
+			acquire.DstStage |= copy.DstStage;
+		}
+
+		vkCmdPipelineBarrier( batch.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, releaseDstStage, 0, 0, nullptr,
+			( uint32_t )releaseBufferBarriers.size(), releaseBufferBarriers.data(), ( uint32_t )releaseImageBarriers.size(), releaseImageBarriers.data() );
+
+		VK_CHECK_RESULT( vkEndCommandBuffer( batch.CommandBuffer ) );
+
+		auto& timeline = m_Device->GetTransferTimeline();
+		batch.TimelineValue = timeline.Next();
+		acquire.TimelineValue = batch.TimelineValue;
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &batch.TimelineValue;
+
+		VkSemaphore timelineSemaphore = timeline.GetSemaphore();
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &batch.CommandBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &timelineSemaphore;
+		VK_CHECK_RESULT( vkQueueSubmit( m_Device->GetTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE ) );
+
+		m_PendingAcquires.push_back( std::move( acquire ) );
+
+		m_InFlightBatches.push_back( std::move( batch ) );
+		m_RecordingBatch = UploadBatch();
+		m_RecordingBatch.Token = m_NextToken++;
+	}
+
+	void VulkanUploadManager::RecordOwnershipAcquire( VkCommandBuffer commandBuffer, VulkanSemaphoreWaitList& waits )
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		if ( m_PendingAcquires.empty() )
+			return;
+
+		// Batches signal increasing values, so waiting for the last one covers all of them
+		uint64_t waitValue = 0;
+		VkPipelineStageFlags waitStage = 0;
+		for ( auto& acquire : m_PendingAcquires )
+		{
+			if ( !acquire.BufferBarriers.empty() || !acquire.ImageBarriers.empty() )
+			{
+				vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, acquire.DstStage, 0, 0, nullptr,
+					( uint32_t )acquire.BufferBarriers.size(), acquire.BufferBarriers.data(), ( uint32_t )acquire.ImageBarriers.size(), acquire.ImageBarriers.data() );
+			}
+
+			waitValue = std::max( waitValue, acquire.TimelineValue );
+			waitStage |= acquire.DstStage;
+		}
+
+		waits.Add( m_Device->GetTransferTimeline().GetSemaphore(), waitStage, waitValue );
+		m_PendingAcquires.clear();
+	}
+
+	bool VulkanUploadManager::IsComplete( UploadToken token )
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+
+		ReclaimCompletedBatches();
+		return token.Value <= m_CompletedToken;
+	}
+
+	void VulkanUploadManager::Wait( UploadToken token )
+	{
+		uint64_t timelineValue = 0;
+		{
+			std::lock_guard<std::mutex> lock( m_Mutex );
+			VE_ASSERT( token.Value < m_RecordingBatch.Token, "Waiting for an upload batch that has not been flushed!" );
+
+			for ( auto& batch : m_InFlightBatches )
+			{
+				if ( batch.Token == token.Value )
+					timelineValue = batch.TimelineValue;
+			}
+		}
+
+		if ( timelineValue )
+			m_Device->GetTransferTimeline().Wait( timelineValue );
+
+		IsComplete( token );
+	}
+
+	VkBuffer VulkanUploadManager::AllocateStaging( VkDeviceSize size, VkDeviceSize& outOffset, void*& outData )
+	{
+		if ( m_RingUsed == 0 )
+			m_RingHead = m_RingTail = 0;
+
+		VkDeviceSize offset = AlignUp( m_RingHead, s_StagingAlignment );
+		bool fits = false;
+		if ( m_RingUsed == 0 || m_RingHead > m_RingTail )
+		{
+			// Free space is [head, end) followed by [0, tail)
+			if ( offset + size <= m_RingSize )
+			{
+				fits = true;
+			}
+			else if ( size <= m_RingTail || ( m_RingUsed == 0 && size <= m_RingSize ) )
+			{
+				offset = 0;
+				fits = true;
+			}
+		}
+		else if ( m_RingHead < m_RingTail )
+		{
+			fits = offset + size <= m_RingTail;
+		}
+
+		if ( fits )
+		{
+			VkDeviceSize consumed = offset >= m_RingHead ? offset + size - m_RingHead : m_RingSize - m_RingHead + size;
+			m_RingUsed += consumed;
+			m_RingHead = offset + size;
+
+			m_RecordingBatch.RingBytes += consumed;
+			m_RecordingBatch.RingEnd = m_RingHead;
+
+			outOffset = offset;
+			outData = ( uint8_t* )m_StagingAllocation->MappedData + offset;
+			return m_StagingBuffer;
+		}
+
+		// The ring is full or the upload is larger than the ring, stage through a buffer of its own that is
+		// destroyed when the batch completes
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkBuffer buffer;
+		VulkanAllocation* allocation = m_Device->GetAllocator().AllocateBuffer( bufferInfo, VulkanMemoryUsage::CPUToGPU, buffer );
+		m_RecordingBatch.TemporaryBuffers.push_back( { buffer, allocation } );
+
+		outOffset = 0;
+		outData = allocation->MappedData;
+		return buffer;
+	}
+
+	void VulkanUploadManager::ReclaimCompletedBatches()
+	{
+		auto& timeline = m_Device->GetTransferTimeline();
+
+		while ( !m_InFlightBatches.empty() && timeline.IsComplete( m_InFlightBatches.front().TimelineValue ) )
+		{
+			UploadBatch& batch = m_InFlightBatches.front();
+
+			// Batches complete in submission order, so the ring tail simply follows them
+			if ( batch.RingBytes > 0 )
+			{
+				m_RingTail = batch.RingEnd;
+				m_RingUsed -= batch.RingBytes;
+			}
+			m_CompletedToken = batch.Token;
+
+			for ( auto& [buffer, allocation] : batch.TemporaryBuffers )
+			{
+				m_Device->GetAllocator().DestroyBuffer( buffer, allocation );
+			}
+
+			m_FreeCommandBuffers.push_back( batch.CommandBuffer );
+			m_InFlightBatches.pop_front();
+		}
+	}
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Platform/Vulkan/Vulkan.h"
+#include "Platform/Vulkan/VulkanAllocator.h"
+#include "Platform/Vulkan/VulkanTimelineSemaphore.h"
+
+#include <deque>
+#include <mutex>
+
+namespace VE
+{
+	class VulkanLogicalDevice;
+
+	// Identifies the batch an upload was recorded into. Tokens increase monotonically, so a completed token
+	// implies every earlier one has completed as well.
+	struct UploadToken
+	{
+		uint64_t Value = 0;
+	};
+
+	// Streams buffer and image data to the GPU through a persistently mapped staging ring and the transfer
+	// queue. Uploads can be requested from any thread: the data is copied into staging memory right away and
+	// the copy commands are recorded and submitted as one batch by Flush on the render thread. When the
+	// transfer queue belongs to another family, ownership of the destination is released on the transfer
+	// queue and acquired by the next graphics submission through RecordOwnershipAcquire.
+	class VulkanUploadManager
+	{
+	public:
+		VulkanUploadManager( VulkanLogicalDevice* device, VkDeviceSize stagingSize = 64ull * 1024 * 1024 );
+		~VulkanUploadManager();
+
+		UploadToken UploadBuffer( VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess );
+		// Region buffer offsets are relative to data. The image is transitioned from undefined to finalLayout.
+		UploadToken UploadImage( VkImage image, const void* data, VkDeviceSize size, const std::vector<VkBufferImageCopy>& regions, const VkImageSubresourceRange& range,
+			VkImageLayout finalLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess );
+
+		// Render thread: records and submits everything uploaded since the last flush
+		void Flush();
+		// Render thread: makes the uploads of every flushed batch visible to a graphics command buffer. The
+		// submission of that command buffer must wait on the transfer timeline added to waits.
+		void RecordOwnershipAcquire( VkCommandBuffer commandBuffer, VulkanSemaphoreWaitList& waits );
+
+		bool IsComplete( UploadToken token );
+		// Blocks until the batch of the token has executed. The batch must have been flushed.
+		void Wait( UploadToken token );
+
+	private:
+		struct BufferCopy
+		{
+			VkBuffer Source;
+			VkBuffer Destination;
+			VkBufferCopy Region;
+			VkPipelineStageFlags DstStage;
+			VkAccessFlags DstAccess;
+		};
+
+		struct ImageCopy
+		{
+			VkBuffer Source;
+			VkImage Destination;
+			std::vector<VkBufferImageCopy> Regions;
+			VkImageSubresourceRange Range;
+			VkImageLayout FinalLayout;
+			VkPipelineStageFlags DstStage;
+			VkAccessFlags DstAccess;
+		};
+
+		struct UploadBatch
+		{
+			uint64_t Token = 0;
+			// Value the batch signals on the transfer timeline
+			uint64_t TimelineValue = 0;
+			VkCommandBuffer CommandBuffer = nullptr;
+
+			VkDeviceSize RingEnd = 0;
+			VkDeviceSize RingBytes = 0;
+
+			std::vector<BufferCopy> BufferCopies;
+			std::vector<ImageCopy> ImageCopies;
+			// Staging buffers for uploads that did not fit into the ring
+			std::vector<std::pair<VkBuffer, VulkanAllocation*>> TemporaryBuffers;
+		};
+
+		struct PendingAcquire
+		{
+			uint64_t TimelineValue;
+			VkPipelineStageFlags DstStage = 0;
+			std::vector<VkBufferMemoryBarrier> BufferBarriers;
+			std::vector<VkImageMemoryBarrier> ImageBarriers;
+		};
+
+		VkBuffer AllocateStaging( VkDeviceSize size, VkDeviceSize& outOffset, void*& outData );
+		void ReclaimCompletedBatches();
+
+	private:
+		VulkanLogicalDevice* m_Device;
+		uint32_t m_TransferFamily = 0;
+		uint32_t m_GraphicsFamily = 0;
+
+		VkCommandPool m_CommandPool = nullptr;
+
+		VkBuffer m_StagingBuffer = nullptr;
+		VulkanAllocation* m_StagingAllocation = nullptr;
+		VkDeviceSize m_RingSize = 0;
+		VkDeviceSize m_RingHead = 0;
+		VkDeviceSize m_RingTail = 0;
+		VkDeviceSize m_RingUsed = 0;
+
+		UploadBatch m_RecordingBatch;
+		std::deque<UploadBatch> m_InFlightBatches;
+		std::vector<VkCommandBuffer> m_FreeCommandBuffers;
+		std::vector<PendingAcquire> m_PendingAcquires;
+
+		uint64_t m_NextToken = 1;
+		uint64_t m_CompletedToken = 0;
+
+		std::mutex m_Mutex;
+	};
+}
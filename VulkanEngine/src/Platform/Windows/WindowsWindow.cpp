@@ -5,6 +5,8 @@
 #include "Events/KeyEvent.h"
 #include "Events/MouseEvent.h"
 
+#include "Renderer/Renderer.h"
+
 namespace VE
 {
 
@@ -15,12 +17,6 @@ namespace VE
 
 	static bool s_GLFWInitialized = false;
 
-
-	Window* Window::Create( const WindowSpecification& specification )
-	{
-		return new WindowsWindow( specification );
-	}
-
 	WindowsWindow::WindowsWindow( const WindowSpecification& specification )
 		: m_Specification( specification )
 	{
@@ -36,6 +32,7 @@ namespace VE
 		m_Data.Title = m_Specification.Title;
 		m_Data.Width = m_Specification.Width;
 		m_Data.Height = m_Specification.Height;
+		m_Data.VSync = m_Specification.VSync;
 
 		VE_INFO( "Creating window {0} ({1}, {2})", m_Specification.Title, m_Specification.Width, m_Specification.Height );
 
@@ -52,6 +49,7 @@ namespace VE
 
 		m_Window = glfwCreateWindow( ( int )m_Specification.Width, ( int )m_Specification.Height, m_Data.Title.c_str(), nullptr, nullptr );
 
+		VE_PROFILE_SCOPE( "Vulkan initialization" );
 		m_VulkanInstance = CreateRef<VulkanInstance>();
 		m_VulkanInstance->Init();
 
@@ -67,8 +65,7 @@ namespace VE
 			{
 				auto& data = *( ( WindowData* )glfwGetWindowUserPointer( window ) );
 
-				WindowResizeEvent event( ( uint32_t )width, ( uint32_t )height );
-				data.EventCallback( event );
+				data.Events.Push<WindowResizeEvent>( ( uint32_t )width, ( uint32_t )height );
 				data.Width = width;
 				data.Height = height;
 			} );
@@ -77,8 +74,7 @@ namespace VE
 			{
 				auto& data = *( ( WindowData* )glfwGetWindowUserPointer( window ) );
 
-				WindowCloseEvent event;
-				data.EventCallback( event );
+				data.Events.Push<WindowCloseEvent>();
 			} );
 
 		glfwSetKeyCallback( m_Window, []( GLFWwindow* window, int key, int scancode, int action, int mods )
@@ -89,20 +85,17 @@ namespace VE
 				{
 					case GLFW_PRESS:
 						{
-							KeyPressedEvent event( ( KeyCode )key, 0 );
-							data.EventCallback( event );
+							data.Events.Push<KeyPressedEvent>( ( KeyCode )key, 0 );
 							break;
 						}
 					case GLFW_RELEASE:
 						{
-							KeyReleasedEvent event( ( KeyCode )key );
-							data.EventCallback( event );
+							data.Events.Push<KeyReleasedEvent>( ( KeyCode )key );
 							break;
 						}
 					case GLFW_REPEAT:
 						{
-							KeyPressedEvent event( ( KeyCode )key, 1 );
-							data.EventCallback( event );
+							data.Events.Push<KeyPressedEvent>( ( KeyCode )key, 1 );
 							break;
 						}
 				}
@@ -112,8 +105,7 @@ namespace VE
 			{
 				auto& data = *( ( WindowData* )glfwGetWindowUserPointer( window ) );
 
-				KeyTypedEvent event( ( KeyCode )codepoint );
-				data.EventCallback( event );
+				data.Events.Push<KeyTypedEvent>( ( KeyCode )codepoint );
 			} );
 
 		glfwSetMouseButtonCallback( m_Window, []( GLFWwindow* window, int button, int action, int mods )
@@ -124,14 +116,12 @@ namespace VE
 				{
 					case GLFW_PRESS:
 						{
-							MouseButtonPressedEvent event( button );
-							data.EventCallback( event );
+							data.Events.Push<MouseButtonPressedEvent>( button );
 							break;
 						}
 					case GLFW_RELEASE:
 						{
-							MouseButtonReleasedEvent event( button );
-							data.EventCallback( event );
+							data.Events.Push<MouseButtonReleasedEvent>( button );
 							break;
 						}
 				}
@@ -141,15 +131,13 @@ namespace VE
 			{
 				auto& data = *( ( WindowData* )glfwGetWindowUserPointer( window ) );
 
-				MouseScrolledEvent event( ( float )xOffset, ( float )yOffset );
-				data.EventCallback( event );
+				data.Events.Push<MouseScrolledEvent>( ( float )xOffset, ( float )yOffset );
 			} );
 
 		glfwSetCursorPosCallback( m_Window, []( GLFWwindow* window, double x, double y )
 			{
 				auto& data = *( ( WindowData* )glfwGetWindowUserPointer( window ) );
-				MouseMovedEvent event( ( float )x, ( float )y );
-				data.EventCallback( event );
+				data.Events.Push<MouseMovedEvent>( ( float )x, ( float )y );
 			} );
 
 		int width, height;
@@ -160,9 +148,23 @@ namespace VE
 
 	void WindowsWindow::ProcessEvents()
 	{
+		VE_PROFILE_FUNCTION();
+
 		glfwPollEvents();
 	}
 
+	void WindowsWindow::WaitEvents( float timeout )
+	{
+		VE_PROFILE_FUNCTION();
+
+		glfwWaitEventsTimeout( timeout );
+	}
+
+	void WindowsWindow::Wake()
+	{
+		glfwPostEmptyEvent();
+	}
+
 	std::pair<float, float> WindowsWindow::GetWindowPos() const
 	{
 		int x, y;
@@ -177,7 +179,16 @@ namespace VE
 
 	void WindowsWindow::SetVSync( bool enabled )
 	{
+		if ( enabled == m_Data.VSync )
+			return;
+
 		m_Data.VSync = enabled;
+
+		VulkanSwapChain& swapChain = m_SwapChain;
+		Renderer::Submit( [&swapChain, enabled]()
+			{
+				swapChain.SetVSync( enabled );
+			} );
 	}
 
 	bool WindowsWindow::IsVSync() const
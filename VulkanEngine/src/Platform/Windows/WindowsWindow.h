@@ -17,6 +17,8 @@ namespace VE
 
 		virtual void Init() override;
 		virtual void ProcessEvents() override;
+		virtual void WaitEvents( float timeout ) override;
+		virtual void Wake() override;
 
 		inline uint32_t GetWidth() const override
 		{
@@ -33,9 +35,9 @@ namespace VE
 		}
 		virtual std::pair<float, float> GetWindowPos() const override;
 
-		virtual void SetEventCallback( const EventCallbackFn& callback ) override
+		virtual EventQueue& GetEventQueue() override
 		{
-			m_Data.EventCallback = callback;
+			return m_Data.Events;
 		}
 		virtual void SetVSync( bool enabled ) override;
 		virtual bool IsVSync() const override;
@@ -68,7 +70,7 @@ namespace VE
 			unsigned int Width, Height;
 			bool VSync;
 
-			EventCallbackFn EventCallback;
+			EventQueue Events;
 		};
 
 		WindowData m_Data;
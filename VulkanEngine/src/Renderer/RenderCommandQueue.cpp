@@ -0,0 +1,90 @@
+#include "vepch.h"
+#include "Renderer/RenderCommandQueue.h"
+
+namespace VE
+{
+
+	static constexpr uint32_t s_PageSize = 1024 * 1024;
+	static constexpr uint32_t s_CommandAlignment = alignof( std::max_align_t );
+
+	struct RenderCommandHeader
+	{
+		RenderCommandQueue::RenderCommandFn Function;
+		uint32_t Size;
+	};
+
+	static constexpr uint32_t Align( uint32_t size )
+	{
+		return ( size + s_CommandAlignment - 1 ) & ~( s_CommandAlignment - 1 );
+	}
+
+	static constexpr uint32_t s_HeaderSize = Align( sizeof( RenderCommandHeader ) );
+
+	RenderCommandQueue::RenderCommandQueue()
+	{
+		GetPage( 0 );
+	}
+
+	RenderCommandQueue::~RenderCommandQueue()
+	{
+		VE_ASSERT( m_CommandCount == 0, "Render command queue destroyed with pending commands!" );
+	}
+
+	void* RenderCommandQueue::Allocate( RenderCommandFn func, uint32_t size )
+	{
+		const uint32_t alignedSize = Align( size );
+
+		Page& page = GetPage( s_HeaderSize + alignedSize );
+		uint8_t* memory = page.Memory.get() + page.Used;
+		page.Used += s_HeaderSize + alignedSize;
+
+		auto header = new ( memory ) RenderCommandHeader();
+		header->Function = func;
+		header->Size = alignedSize;
+
+		m_CommandCount++;
+		return memory + s_HeaderSize;
+	}
+
+	void RenderCommandQueue::Execute()
+	{
+		for ( uint32_t i = 0; i <= m_CurrentPage; i++ )
+		{
+			Page& page = m_Pages[ i ];
+
+			uint32_t offset = 0;
+			while ( offset < page.Used )
+			{
+				auto header = ( RenderCommandHeader* )( page.Memory.get() + offset );
+				header->Function( page.Memory.get() + offset + s_HeaderSize );
+				offset += s_HeaderSize + header->Size;
+			}
+
+			page.Used = 0;
+		}
+
+		m_CurrentPage = 0;
+		m_CommandCount = 0;
+	}
+
+	RenderCommandQueue::Page& RenderCommandQueue::GetPage( uint32_t size )
+	{
+		while ( m_CurrentPage < m_Pages.size() )
+		{
+			Page& page = m_Pages[ m_CurrentPage ];
+			if ( page.Capacity - page.Used >= size )
+				return page;
+
+			// Pages after the current one are empty since the last Execute
+			m_CurrentPage++;
+		}
+
+		Page page;
+		page.Capacity = std::max( s_PageSize, size );
+		page.Memory = Scope<uint8_t[]>( new uint8_t[ page.Capacity ] );
+		m_Pages.push_back( std::move( page ) );
+		m_CurrentPage = ( uint32_t )m_Pages.size() - 1;
+		return m_Pages.back();
+	}
+
+}
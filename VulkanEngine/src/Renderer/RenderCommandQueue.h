@@ -0,0 +1,56 @@
+#pragma once
+
+namespace VE
+{
+	// Linear arena of type-erased commands. Commands are written by one thread and executed in submission
+	// order by another, the arena is reset after every Execute.
+	class RenderCommandQueue
+	{
+	public:
+		typedef void( *RenderCommandFn )( void* );
+
+		RenderCommandQueue();
+		~RenderCommandQueue();
+
+		// Returns storage for a command of the given size, func is called with it on Execute
+		void* Allocate( RenderCommandFn func, uint32_t size );
+
+		template<typename FuncT>
+		void Submit( FuncT&& func )
+		{
+			using CommandT = std::decay_t<FuncT>;
+
+			auto renderCmd = []( void* ptr )
+			{
+				auto pFunc = ( CommandT* )ptr;
+				( *pFunc )();
+				pFunc->~CommandT();
+			};
+
+			auto storageBuffer = Allocate( renderCmd, sizeof( CommandT ) );
+			new ( storageBuffer ) CommandT( std::forward<FuncT>( func ) );
+		}
+
+		void Execute();
+
+		uint32_t GetCommandCount() const
+		{
+			return m_CommandCount;
+		}
+
+	private:
+		struct Page
+		{
+			Scope<uint8_t[]> Memory;
+			uint32_t Capacity = 0;
+			uint32_t Used = 0;
+		};
+
+		Page& GetPage( uint32_t size );
+
+	private:
+		std::vector<Page> m_Pages;
+		uint32_t m_CurrentPage = 0;
+		uint32_t m_CommandCount = 0;
+	};
+}
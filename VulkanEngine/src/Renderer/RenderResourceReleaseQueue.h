@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Renderer/RenderCommandQueue.h"
+
+namespace VE
+{
+	// Destruction commands for GPU objects used by one frame in flight. The queue is executed once the
+	// frame's fence has signalled, which is the earliest point the GPU can no longer reference them.
+	class RenderResourceReleaseQueue
+	{
+	public:
+		template<typename FuncT>
+		void Submit( FuncT&& func, uint64_t byteSize = 0 )
+		{
+			m_Queue.Submit( std::forward<FuncT>( func ) );
+			m_ObjectCount++;
+			m_ByteCount += byteSize;
+		}
+
+		void Execute()
+		{
+			m_Queue.Execute();
+			m_ObjectCount = 0;
+			m_ByteCount = 0;
+		}
+
+		uint32_t GetObjectCount() const
+		{
+			return m_ObjectCount;
+		}
+		uint64_t GetByteCount() const
+		{
+			return m_ByteCount;
+		}
+
+	private:
+		RenderCommandQueue m_Queue;
+		uint32_t m_ObjectCount = 0;
+		uint64_t m_ByteCount = 0;
+	};
+}
@@ -0,0 +1,120 @@
+#include "vepch.h"
+#include "Renderer/RenderThread.h"
+
+#include "Renderer/Renderer.h"
+
+namespace VE
+{
+
+	RenderThread::RenderThread( ThreadingPolicy policy )
+		: m_ThreadingPolicy( policy )
+	{
+	}
+
+	RenderThread::~RenderThread()
+	{
+		if ( m_Running )
+			Terminate();
+	}
+
+	void RenderThread::Run()
+	{
+		m_Running = true;
+		if ( m_ThreadingPolicy == ThreadingPolicy::MultiThreaded )
+			m_Thread = std::thread( &RenderThread::RenderThreadFunc, this );
+	}
+
+	void RenderThread::Terminate()
+	{
+		// Finish the frame in flight and flush the one that is still being submitted before the thread exits
+		BlockUntilRenderComplete();
+		Pump();
+
+		{
+			std::lock_guard<std::mutex> lock( m_Mutex );
+			m_Running = false;
+		}
+
+		if ( m_ThreadingPolicy == ThreadingPolicy::MultiThreaded )
+		{
+			Set( State::Kick );
+			m_Thread.join();
+		}
+	}
+
+	void RenderThread::NextFrame()
+	{
+		Renderer::SwapQueues();
+	}
+
+	void RenderThread::BlockUntilRenderComplete()
+	{
+		if ( m_ThreadingPolicy == ThreadingPolicy::SingleThreaded )
+			return;
+
+		Wait( State::Idle );
+	}
+
+	void RenderThread::Kick()
+	{
+		if ( m_ThreadingPolicy == ThreadingPolicy::MultiThreaded )
+		{
+			Set( State::Kick );
+		}
+		else
+		{
+			Renderer::WaitAndRender();
+		}
+	}
+
+	void RenderThread::Pump()
+	{
+		NextFrame();
+		Kick();
+		BlockUntilRenderComplete();
+	}
+
+	void RenderThread::Wait( State waitForState )
+	{
+		std::unique_lock<std::mutex> lock( m_Mutex );
+		m_ConditionVariable.wait( lock, [this, waitForState]() { return m_State == waitForState; } );
+	}
+
+	void RenderThread::WaitAndSet( State waitForState, State setToState )
+	{
+		std::unique_lock<std::mutex> lock( m_Mutex );
+		m_ConditionVariable.wait( lock, [this, waitForState]() { return m_State == waitForState; } );
+		m_State = setToState;
+		m_ConditionVariable.notify_all();
+	}
+
+	void RenderThread::Set( State setToState )
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_State = setToState;
+		m_ConditionVariable.notify_all();
+	}
+
+	void RenderThread::RenderThreadFunc( RenderThread* renderThread )
+	{
+		Profiler::SetThreadName( "Render Thread" );
+
+		while ( true )
+		{
+			renderThread->WaitAndSet( State::Kick, State::Busy );
+
+			{
+				std::lock_guard<std::mutex> lock( renderThread->m_Mutex );
+				if ( !renderThread->m_Running )
+					break;
+			}
+
+			Renderer::WaitAndRender();
+
+			renderThread->Set( State::Idle );
+		}
+
+		renderThread->Set( State::Idle );
+	}
+
+}
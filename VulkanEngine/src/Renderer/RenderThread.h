@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace VE
+{
+	enum class ThreadingPolicy
+	{
+		// Render commands are executed on the main thread when the frame is kicked
+		SingleThreaded = 0,
+		// Render commands are executed on a dedicated render thread, one frame behind the main thread
+		MultiThreaded
+	};
+
+	class RenderThread
+	{
+	public:
+		enum class State
+		{
+			Idle = 0,
+			Busy,
+			Kick
+		};
+
+	public:
+		RenderThread( ThreadingPolicy policy );
+		~RenderThread();
+
+		void Run();
+		void Terminate();
+
+		bool IsRunning() const
+		{
+			return m_Running;
+		}
+
+		// Main thread: swap the command queues so the frame just submitted becomes the one to render
+		void NextFrame();
+		// Main thread: wait until the render thread has executed the last kicked frame
+		void BlockUntilRenderComplete();
+		// Main thread: start executing the render queue
+		void Kick();
+		// Main thread: run one complete frame of the render thread synchronously
+		void Pump();
+
+	private:
+		void Wait( State waitForState );
+		void WaitAndSet( State waitForState, State setToState );
+		void Set( State setToState );
+
+		static void RenderThreadFunc( RenderThread* renderThread );
+
+	private:
+		ThreadingPolicy m_ThreadingPolicy;
+		std::thread m_Thread;
+		bool m_Running = false;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_ConditionVariable;
+		State m_State = State::Idle;
+	};
+}
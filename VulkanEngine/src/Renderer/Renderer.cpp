@@ -0,0 +1,118 @@
+#include "vepch.h"
+#include "Renderer/Renderer.h"
+
+#include "Core/Application.h"
+
+#include <atomic>
+
+namespace VE
+{
+
+	static RendererConfig s_Config;
+
+	// Double buffered: the main thread fills one queue while the render thread executes the other
+	static constexpr uint32_t s_RenderCommandQueueCount = 2;
+	static RenderCommandQueue* s_CommandQueue[ s_RenderCommandQueueCount ];
+	static std::atomic<uint32_t> s_RenderCommandQueueSubmissionIndex = 0;
+	static thread_local bool s_ExecutingRenderCommands = false;
+
+	static std::vector<Scope<RenderResourceReleaseQueue>> s_ResourceReleaseQueues;
+
+	void Renderer::Init()
+	{
+		s_Config.FramesInFlight = std::max( s_Config.FramesInFlight, 1u );
+
+		for ( uint32_t i = 0; i < s_Config.FramesInFlight; i++ )
+		{
+			s_ResourceReleaseQueues.push_back( CreateScope<RenderResourceReleaseQueue>() );
+		}
+
+		for ( uint32_t i = 0; i < s_RenderCommandQueueCount; i++ )
+		{
+			s_CommandQueue[ i ] = new RenderCommandQueue();
+		}
+	}
+
+	void Renderer::Shutdown()
+	{
+		// Nothing is in flight any more, everything that was waiting for a frame to complete can go
+		vkDeviceWaitIdle( VulkanInstance::GetCurrentDevice()->GetVulkanLogicalDevice() );
+		for ( auto& queue : s_ResourceReleaseQueues )
+		{
+			queue->Execute();
+		}
+		s_ResourceReleaseQueues.clear();
+
+		for ( uint32_t i = 0; i < s_RenderCommandQueueCount; i++ )
+		{
+			delete s_CommandQueue[ i ];
+			s_CommandQueue[ i ] = nullptr;
+		}
+	}
+
+	RendererConfig& Renderer::GetConfig()
+	{
+		return s_Config;
+	}
+
+	void Renderer::SetConfig( const RendererConfig& config )
+	{
+		s_Config = config;
+	}
+
+	void Renderer::WaitAndRender()
+	{
+		VE_PROFILE_FUNCTION();
+
+		s_ExecutingRenderCommands = true;
+		s_CommandQueue[ GetRenderQueueIndex() ]->Execute();
+		s_ExecutingRenderCommands = false;
+	}
+
+	void Renderer::SwapQueues()
+	{
+		s_RenderCommandQueueSubmissionIndex = ( s_RenderCommandQueueSubmissionIndex + 1 ) % s_RenderCommandQueueCount;
+	}
+
+	uint32_t Renderer::GetRenderQueueIndex()
+	{
+		return ( s_RenderCommandQueueSubmissionIndex + 1 ) % s_RenderCommandQueueCount;
+	}
+
+	uint32_t Renderer::GetRenderQueueSubmissionIndex()
+	{
+		return s_RenderCommandQueueSubmissionIndex;
+	}
+
+	RenderResourceReleaseQueue& Renderer::GetRenderResourceReleaseQueue( uint32_t index )
+	{
+		return *s_ResourceReleaseQueues[ index ];
+	}
+
+	ResourceReleaseStatistics Renderer::GetResourceReleaseStatistics()
+	{
+		ResourceReleaseStatistics statistics;
+		for ( auto& queue : s_ResourceReleaseQueues )
+		{
+			statistics.ObjectCount += queue->GetObjectCount();
+			statistics.ByteCount += queue->GetByteCount();
+		}
+		return statistics;
+	}
+
+	uint32_t Renderer::GetCurrentFrameIndex()
+	{
+		return Application::Get().GetWindow().GetSwapChain().GetCurrentBufferIndex();
+	}
+
+	bool Renderer::IsExecutingRenderCommands()
+	{
+		return s_ExecutingRenderCommands;
+	}
+
+	RenderCommandQueue& Renderer::GetRenderCommandQueue()
+	{
+		return *s_CommandQueue[ s_RenderCommandQueueSubmissionIndex ];
+	}
+
+}
@@ -1,12 +1,75 @@
 #pragma once
 
+#include "Renderer/RenderCommandQueue.h"
+#include "Renderer/RenderResourceReleaseQueue.h"
+
 namespace VE
 {
+	struct RendererConfig
+	{
+		uint32_t FramesInFlight = 3;
+		// One global descriptor table indexed by shaders instead of per-draw descriptor sets. Turned off
+		// during initialization when the device does not support descriptor indexing.
+		bool Bindless = false;
+	};
 
-#define  MAX_FRAMES_IN_FLIGHT 3
+	struct ResourceReleaseStatistics
+	{
+		uint32_t ObjectCount = 0;
+		uint64_t ByteCount = 0;
+	};
 
 	class Renderer
 	{
+	public:
+		static void Init();
+		static void Shutdown();
+
+		static RendererConfig& GetConfig();
+		static void SetConfig( const RendererConfig& config );
+
+		// Records func to be executed on the render thread. Captures are copied into the queue, so anything
+		// referenced by the command must stay alive until the frame has been rendered.
+		template<typename FuncT>
+		static void Submit( FuncT&& func )
+		{
+			GetRenderCommandQueue().Submit( std::forward<FuncT>( func ) );
+		}
+
+		// Defers func until the GPU has finished every frame that could still use the resource it destroys.
+		// byteSize is only used for statistics.
+		template<typename FuncT>
+		static void SubmitResourceFree( FuncT&& func, uint64_t byteSize = 0 )
+		{
+			if ( IsExecutingRenderCommands() )
+			{
+				GetRenderResourceReleaseQueue( GetCurrentFrameIndex() ).Submit( std::forward<FuncT>( func ), byteSize );
+			}
+			else
+			{
+				// Resources freed while building a frame may still be used by that frame's render commands
+				Submit( [func = std::forward<FuncT>( func ), byteSize]() mutable
+					{
+						GetRenderResourceReleaseQueue( GetCurrentFrameIndex() ).Submit( std::move( func ), byteSize );
+					} );
+			}
+		}
+
+		// Executes every command submitted for the frame being rendered
+		static void WaitAndRender();
+		static void SwapQueues();
+
+		static uint32_t GetRenderQueueIndex();
+		static uint32_t GetRenderQueueSubmissionIndex();
+
+		static RenderResourceReleaseQueue& GetRenderResourceReleaseQueue( uint32_t index );
+		static ResourceReleaseStatistics GetResourceReleaseStatistics();
+
+		// Frame in flight currently being recorded on the render thread
+		static uint32_t GetCurrentFrameIndex();
+		static bool IsExecutingRenderCommands();
 
+	private:
+		static RenderCommandQueue& GetRenderCommandQueue();
 	};
 }
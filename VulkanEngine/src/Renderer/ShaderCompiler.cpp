@@ -0,0 +1,401 @@
+#include "vepch.h"
+#include "Renderer/ShaderCompiler.h"
+
+#include "Core/Hash.h"
+#include "Core/JobSystem.h"
+#include "Core/Timer.h"
+
+#include <shaderc/shaderc.hpp>
+
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+#ifdef VE_PLATFORM_LINUX
+	#include <dlfcn.h>
+#endif
+
+namespace VE
+{
+
+	// Bump when the cache layout changes so that old entries are no longer found
+	static constexpr uint32_t s_CacheVersion = 1;
+	static constexpr uint32_t s_SPIRVMagic = 0x07230203;
+
+	// Every option that affects the generated code, these are part of the cache key
+	static constexpr shaderc_target_env s_TargetEnvironment = shaderc_target_env_vulkan;
+	static constexpr shaderc_env_version s_TargetEnvironmentVersion = shaderc_env_version_vulkan_1_2;
+#ifdef VE_DEBUG
+	// Debug builds compile without optimization and with debug info
+	static constexpr shaderc_optimization_level s_OptimizationLevel = shaderc_optimization_level_zero;
+	static constexpr bool s_GenerateDebugInfo = true;
+#else
+	static constexpr shaderc_optimization_level s_OptimizationLevel = shaderc_optimization_level_performance;
+	static constexpr bool s_GenerateDebugInfo = false;
+#endif
+
+	struct ShaderCompilerData
+	{
+		std::filesystem::path CacheDirectory;
+		uint64_t CompilerHash = 0;
+
+		std::atomic<uint32_t> Hits = 0;
+		std::atomic<uint32_t> Misses = 0;
+		std::atomic<uint32_t> Failures = 0;
+
+		std::mutex CompileTimeMutex;
+		float CompileTime = 0.0f;
+	};
+
+	static ShaderCompilerData* s_Data = nullptr;
+
+	// shaderc has no version query for the library itself, only for the SPIR-V it emits
+	static std::filesystem::path GetShaderCLibraryPath()
+	{
+#if defined(VE_PLATFORM_WINDOWS)
+		HMODULE module = nullptr;
+		if ( !GetModuleHandleExW( GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, ( LPCWSTR )&shaderc_compiler_initialize, &module ) )
+			return {};
+
+		wchar_t path[ MAX_PATH ];
+		DWORD length = GetModuleFileNameW( module, path, MAX_PATH );
+		return length > 0 && length < MAX_PATH ? std::filesystem::path( path ) : std::filesystem::path();
+#elif defined(VE_PLATFORM_LINUX)
+		Dl_info info;
+		if ( !dladdr( ( const void* )&shaderc_compiler_initialize, &info ) || !info.dli_fname )
+			return {};
+
+		return info.dli_fname;
+#else
+		return {};
+#endif
+	}
+
+	static bool ReadFile( const std::filesystem::path& path, std::string& outContents )
+	{
+		std::ifstream stream( path, std::ios::binary );
+		if ( !stream )
+			return false;
+
+		std::stringstream buffer;
+		buffer << stream.rdbuf();
+		outContents = buffer.str();
+		return true;
+	}
+
+	static shaderc_shader_kind ShaderStageToShaderC( ShaderStage stage )
+	{
+		switch ( stage )
+		{
+			case ShaderStage::Vertex:	return shaderc_vertex_shader;
+			case ShaderStage::Fragment:	return shaderc_fragment_shader;
+			case ShaderStage::Compute:	return shaderc_compute_shader;
+		}
+		VE_ASSERT( false, "Unknown shader stage!" );
+		return shaderc_vertex_shader;
+	}
+
+	// Includes are resolved relative to the including file
+	static std::filesystem::path ResolveInclude( const std::filesystem::path& includingFile, const std::string& requested )
+	{
+		return ( includingFile.parent_path() / requested ).lexically_normal();
+	}
+
+	// Hashes the contents of every file reachable through #include directives so that editing a header
+	// invalidates all shaders that use it. Missing includes only contribute their name, the compile will
+	// report them.
+	static uint64_t HashIncludes( const std::filesystem::path& path, const std::string& source, std::set<std::filesystem::path>& visited, uint64_t hash )
+	{
+		std::istringstream stream( source );
+		std::string line;
+		while ( std::getline( stream, line ) )
+		{
+			size_t start = line.find_first_not_of( " \t" );
+			if ( start == std::string::npos || line.compare( start, 8, "#include" ) != 0 )
+				continue;
+
+			size_t open = line.find_first_of( "\"<", start + 8 );
+			if ( open == std::string::npos )
+				continue;
+			size_t close = line.find_first_of( "\">", open + 1 );
+			if ( close == std::string::npos )
+				continue;
+
+			std::string requested = line.substr( open + 1, close - open - 1 );
+			std::filesystem::path includePath = ResolveInclude( path, requested );
+			hash = Hash::FNV( requested, hash );
+
+			if ( !visited.insert( includePath ).second )
+				continue;
+
+			std::string includeSource;
+			if ( ReadFile( includePath, includeSource ) )
+			{
+				hash = Hash::FNV( includeSource, hash );
+				hash = HashIncludes( includePath, includeSource, visited, hash );
+			}
+		}
+		return hash;
+	}
+
+	static uint64_t ComputeCacheKey( const ShaderSource& source, const std::string& sourceText )
+	{
+		uint64_t hash = Hash::FNVValue( s_Data->CompilerHash );
+		hash = Hash::FNVValue( source.Stage, hash );
+		hash = Hash::FNV( sourceText, hash );
+
+		std::set<std::filesystem::path> visited = { source.Path.lexically_normal() };
+		hash = HashIncludes( source.Path, sourceText, visited, hash );
+
+		// std::map keeps the defines sorted, so their order of insertion does not matter
+		for ( auto& [name, value] : source.Defines )
+		{
+			hash = Hash::FNV( name, hash );
+			hash = Hash::FNV( "=", hash );
+			hash = Hash::FNV( value, hash );
+		}
+		return hash;
+	}
+
+	static std::filesystem::path GetCachePath( uint64_t key )
+	{
+		std::stringstream fileName;
+		fileName << std::hex << std::setfill( '0' ) << std::setw( 16 ) << key << ".spv";
+		return s_Data->CacheDirectory / fileName.str();
+	}
+
+	static bool ReadCache( uint64_t key, std::vector<uint32_t>& outSPIRV )
+	{
+		std::ifstream stream( GetCachePath( key ), std::ios::binary | std::ios::ate );
+		if ( !stream )
+			return false;
+
+		size_t size = ( size_t )stream.tellg();
+		if ( size < sizeof( uint32_t ) || size % sizeof( uint32_t ) != 0 )
+			return false;
+
+		outSPIRV.resize( size / sizeof( uint32_t ) );
+		stream.seekg( 0 );
+		stream.read( ( char* )outSPIRV.data(), size );
+		return stream && outSPIRV[ 0 ] == s_SPIRVMagic;
+	}
+
+	static void WriteCache( uint64_t key, const std::vector<uint32_t>& spirv )
+	{
+		std::filesystem::path path = GetCachePath( key );
+		std::filesystem::path temporaryPath = path;
+		temporaryPath += ".tmp" + std::to_string( JobSystem::GetThreadIndex() );
+		{
+			std::ofstream stream( temporaryPath, std::ios::binary | std::ios::trunc );
+			if ( !stream )
+			{
+				VE_WARN( "shader cache: could not write {0}", temporaryPath.string() );
+				return;
+			}
+			stream.write( ( const char* )spirv.data(), spirv.size() * sizeof( uint32_t ) );
+		}
+
+		std::error_code error;
+		std::filesystem::rename( temporaryPath, path, error );
+	}
+
+	class ShaderIncluder : public shaderc::CompileOptions::IncluderInterface
+	{
+	public:
+		shaderc_include_result* GetInclude( const char* requestedSource, shaderc_include_type type, const char* requestingSource, size_t includeDepth ) override
+		{
+			auto* include = new Include();
+			include->Name = ResolveInclude( requestingSource, requestedSource ).string();
+			if ( !ReadFile( include->Name, include->Content ) )
+			{
+				// An empty name tells shaderc the include failed, the content is the error message
+				include->Content = "could not open " + include->Name;
+				include->Name.clear();
+			}
+
+			include->Result.source_name = include->Name.c_str();
+			include->Result.source_name_length = include->Name.size();
+			include->Result.content = include->Content.c_str();
+			include->Result.content_length = include->Content.size();
+			include->Result.user_data = include;
+			return &include->Result;
+		}
+
+		void ReleaseInclude( shaderc_include_result* data ) override
+		{
+			delete ( Include* )data->user_data;
+		}
+
+	private:
+		struct Include
+		{
+			std::string Name;
+			std::string Content;
+			shaderc_include_result Result;
+		};
+	};
+
+	void ShaderCompiler::Init( const std::filesystem::path& cacheDirectory )
+	{
+		s_Data = new ShaderCompilerData();
+		s_Data->CacheDirectory = cacheDirectory;
+
+		std::error_code error;
+		std::filesystem::create_directories( cacheDirectory, error );
+		if ( error )
+			VE_WARN( "shader cache: could not create {0}: {1}", cacheDirectory.string(), error.message() );
+
+		unsigned int version, revision;
+		shaderc_get_spv_version( &version, &revision );
+		s_Data->CompilerHash = Hash::FNVValue( s_CacheVersion );
+		s_Data->CompilerHash = Hash::FNVValue( version, s_Data->CompilerHash );
+		s_Data->CompilerHash = Hash::FNVValue( revision, s_Data->CompilerHash );
+
+		// Any shaderc build, an upgrade or just a rebuild with a codegen fix, replaces the shared library file,
+		// so its size and modification time stand in for the library version
+		std::filesystem::path libraryPath = GetShaderCLibraryPath();
+		std::error_code sizeError, timeError;
+		uint64_t librarySize = 0;
+		int64_t libraryTime = 0;
+		if ( !libraryPath.empty() )
+		{
+			librarySize = std::filesystem::file_size( libraryPath, sizeError );
+			libraryTime = ( int64_t )std::filesystem::last_write_time( libraryPath, timeError ).time_since_epoch().count();
+		}
+		if ( libraryPath.empty() || sizeError || timeError )
+			VE_WARN( "shader cache: could not find the shaderc library, cached shaders will not be invalidated by a shaderc upgrade" );
+		s_Data->CompilerHash = Hash::FNVValue( librarySize, s_Data->CompilerHash );
+		s_Data->CompilerHash = Hash::FNVValue( libraryTime, s_Data->CompilerHash );
+
+		s_Data->CompilerHash = Hash::FNVValue( s_TargetEnvironment, s_Data->CompilerHash );
+		s_Data->CompilerHash = Hash::FNVValue( s_TargetEnvironmentVersion, s_Data->CompilerHash );
+		s_Data->CompilerHash = Hash::FNVValue( s_OptimizationLevel, s_Data->CompilerHash );
+		s_Data->CompilerHash = Hash::FNVValue( s_GenerateDebugInfo, s_Data->CompilerHash );
+	}
+
+	void ShaderCompiler::Shutdown()
+	{
+		LogStatistics();
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	ShaderCompileResult ShaderCompiler::Compile( const ShaderSource& source )
+	{
+		VE_ASSERT( s_Data, "ShaderCompiler has not been initialized!" );
+
+		ShaderCompileResult result;
+
+		std::string sourceText;
+		if ( !ReadFile( source.Path, sourceText ) )
+		{
+			result.Error = "could not open " + source.Path.string();
+			VE_ERROR( "shader compiler: {0}", result.Error );
+			s_Data->Failures++;
+			return result;
+		}
+
+		uint64_t key = ComputeCacheKey( source, sourceText );
+		result.CacheKey = key;
+		if ( ReadCache( key, result.SPIRV ) )
+		{
+			result.Success = true;
+			result.FromCache = true;
+			s_Data->Hits++;
+			return result;
+		}
+
+		s_Data->Misses++;
+
+		Timer timer;
+
+		shaderc::CompileOptions options;
+		options.SetTargetEnvironment( s_TargetEnvironment, s_TargetEnvironmentVersion );
+		options.SetIncluder( std::make_unique<ShaderIncluder>() );
+		options.SetOptimizationLevel( s_OptimizationLevel );
+		if ( s_GenerateDebugInfo )
+			options.SetGenerateDebugInfo();
+		for ( auto& [name, value] : source.Defines )
+		{
+			options.AddMacroDefinition( name, value );
+		}
+
+		// Compilers are cheap to create and not shared between threads
+		shaderc::Compiler compiler;
+		shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv( sourceText, ShaderStageToShaderC( source.Stage ), source.Path.string().c_str(), options );
+
+		{
+			std::lock_guard<std::mutex> lock( s_Data->CompileTimeMutex );
+			s_Data->CompileTime += timer.ElapsedMillis();
+		}
+
+		if ( module.GetCompilationStatus() != shaderc_compilation_status_success )
+		{
+			result.Error = module.GetErrorMessage();
+			VE_ERROR( "shader compiler: {0}", result.Error );
+			s_Data->Failures++;
+			return result;
+		}
+
+		result.SPIRV.assign( module.cbegin(), module.cend() );
+		result.Success = true;
+		WriteCache( key, result.SPIRV );
+		return result;
+	}
+
+	std::vector<ShaderCompileResult> ShaderCompiler::CompileAll( const std::vector<ShaderSource>& sources )
+	{
+		std::vector<ShaderCompileResult> results( sources.size() );
+
+		ShaderCacheStatistics before = GetStatistics();
+		Timer timer;
+
+		JobSystem::ParallelFor( ( uint32_t )sources.size(), 1, [&]( uint32_t begin, uint32_t end )
+			{
+				for ( uint32_t i = begin; i < end; i++ )
+				{
+					results[ i ] = Compile( sources[ i ] );
+				}
+			} );
+
+		ShaderCacheStatistics after = GetStatistics();
+		uint32_t hits = after.Hits - before.Hits;
+		uint32_t misses = after.Misses - before.Misses;
+		float hitRate = hits + misses == 0 ? 0.0f : 100.0f * hits / ( float )( hits + misses );
+		VE_INFO( "shader compiler: {0} shaders in {1:.2f}ms, {2} cached, {3} compiled ({4:.1f}% hit rate)", sources.size(), timer.ElapsedMillis(), hits, misses, hitRate );
+
+		return results;
+	}
+
+	ShaderCacheStatistics ShaderCompiler::GetStatistics()
+	{
+		ShaderCacheStatistics statistics;
+		statistics.Hits = s_Data->Hits;
+		statistics.Misses = s_Data->Misses;
+		statistics.Failures = s_Data->Failures;
+
+		std::lock_guard<std::mutex> lock( s_Data->CompileTimeMutex );
+		statistics.CompileTime = s_Data->CompileTime;
+		return statistics;
+	}
+
+	void ShaderCompiler::LogStatistics()
+	{
+		ShaderCacheStatistics statistics = GetStatistics();
+		uint32_t requests = statistics.Hits + statistics.Misses;
+		if ( requests == 0 )
+			return;
+
+		VE_INFO( "shader cache: {0} requests, {1} hits ({2:.1f}%), {3} compiled in {4:.2f}ms, {5} failed", requests, statistics.Hits,
+			100.0f * statistics.Hits / ( float )requests, statistics.Misses, statistics.CompileTime, statistics.Failures );
+	}
+
+	const std::filesystem::path& ShaderCompiler::GetCacheDirectory()
+	{
+		return s_Data->CacheDirectory;
+	}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+
+namespace VE
+{
+	enum class ShaderStage
+	{
+		Vertex, Fragment, Compute
+	};
+
+	struct ShaderSource
+	{
+		std::filesystem::path Path;
+		ShaderStage Stage = ShaderStage::Vertex;
+		std::map<std::string, std::string> Defines;
+	};
+
+	struct ShaderCompileResult
+	{
+		std::vector<uint32_t> SPIRV;
+		bool Success = false;
+		bool FromCache = false;
+		// Key the SPIR-V is cached under, derived data such as reflection can be cached by it too
+		uint64_t CacheKey = 0;
+		std::string Error;
+	};
+
+	struct ShaderCacheStatistics
+	{
+		uint32_t Hits = 0;
+		uint32_t Misses = 0;
+		uint32_t Failures = 0;
+		// Time spent inside shaderc, summed over all threads
+		float CompileTime = 0.0f;
+	};
+
+	// Compiles GLSL to SPIR-V with shaderc. Results are cached on disk under a key made from the source,
+	// every file it includes, the defines, the stage and the compiler version, so a warm start never calls
+	// into shaderc. Changing any of those simply produces a new key.
+	class ShaderCompiler
+	{
+	public:
+		static void Init( const std::filesystem::path& cacheDirectory = "cache/shaders" );
+		static void Shutdown();
+
+		static ShaderCompileResult Compile( const ShaderSource& source );
+		// Compiles the sources in parallel on the job system workers and logs the cache hit rate
+		static std::vector<ShaderCompileResult> CompileAll( const std::vector<ShaderSource>& sources );
+
+		static ShaderCacheStatistics GetStatistics();
+		static void LogStatistics();
+
+		static const std::filesystem::path& GetCacheDirectory();
+	};
+}
@@ -1,3 +1,4 @@
 #pragma once
 
 #include "Core/Application.h"
+#include "Core/JobSystem.h"
@@ -0,0 +1,62 @@
+project "VulkanEngineBench"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "off"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"src/**.h",
+		"src/**.cpp"
+	}
+
+	includedirs
+	{
+		"%{wks.location}/VulkanEngine/vendor/spdlog/include",
+		"%{wks.location}/VulkanEngine/src",
+		"%{wks.location}/VulkanEngine/vendor",
+		"%{IncludeDir.GLM}",
+		"%{IncludeDir.VulkanSDK}"
+	}
+
+	links
+	{
+		"VulkanEngine"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+	filter "system:linux"
+		links
+		{
+			"%{Library.Vulkan_Linux}",
+			"%{Library.ShaderC_Linux}",
+			"%{Library.SPIRV_Cross_Linux}",
+			"%{Library.SPIRV_Cross_GLSL_Linux}",
+			"pthread",
+			"dl"
+		}
+
+	filter "configurations:Debug"
+		defines "VE_DEBUG"
+		runtime "Debug"
+		symbols "on"
+		
+		postbuildcommands
+		{
+			"{COPYDIR} \"%{LibraryDir.VulkanSDK_DebugDLL}\" \"%{cfg.targetdir}\""
+		}
+
+	filter "configurations:Release"
+		defines "VE_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "VE_DIST"
+		runtime "Release"
+		optimize "on"
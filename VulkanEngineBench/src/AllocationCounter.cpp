@@ -0,0 +1,145 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+	#include <malloc.h>
+#endif
+
+// Replacing the global allocation functions in the executable counts every allocation of the engine as well,
+// including the ones made by the standard library on its behalf
+
+static std::atomic<uint64_t> s_AllocationCount = 0;
+
+void* operator new( std::size_t size )
+{
+	s_AllocationCount.fetch_add( 1, std::memory_order_relaxed );
+
+	if ( void* memory = std::malloc( size ? size : 1 ) )
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[]( std::size_t size )
+{
+	return operator new( size );
+}
+
+void* operator new( std::size_t size, const std::nothrow_t& ) noexcept
+{
+	s_AllocationCount.fetch_add( 1, std::memory_order_relaxed );
+	return std::malloc( size ? size : 1 );
+}
+
+void* operator new[]( std::size_t size, const std::nothrow_t& tag ) noexcept
+{
+	return operator new( size, tag );
+}
+
+void operator delete( void* memory ) noexcept
+{
+	std::free( memory );
+}
+
+void operator delete[]( void* memory ) noexcept
+{
+	std::free( memory );
+}
+
+void operator delete( void* memory, std::size_t ) noexcept
+{
+	std::free( memory );
+}
+
+void operator delete[]( void* memory, std::size_t ) noexcept
+{
+	std::free( memory );
+}
+
+// Over-aligned types allocate through these, the default ones would skip the count
+
+static void* AlignedAllocate( std::size_t size, std::align_val_t alignment ) noexcept
+{
+	s_AllocationCount.fetch_add( 1, std::memory_order_relaxed );
+
+	std::size_t align = ( std::size_t )alignment;
+#ifdef _WIN32
+	return _aligned_malloc( size ? size : 1, align );
+#else
+	// aligned_alloc wants the size to be a multiple of the alignment
+	return std::aligned_alloc( align, ( ( size ? size : 1 ) + align - 1 ) & ~( align - 1 ) );
+#endif
+}
+
+static void AlignedFree( void* memory ) noexcept
+{
+#ifdef _WIN32
+	_aligned_free( memory );
+#else
+	std::free( memory );
+#endif
+}
+
+void* operator new( std::size_t size, std::align_val_t alignment )
+{
+	if ( void* memory = AlignedAllocate( size, alignment ) )
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[]( std::size_t size, std::align_val_t alignment )
+{
+	return operator new( size, alignment );
+}
+
+void* operator new( std::size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+	return AlignedAllocate( size, alignment );
+}
+
+void* operator new[]( std::size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+	return AlignedAllocate( size, alignment );
+}
+
+void operator delete( void* memory, std::align_val_t ) noexcept
+{
+	AlignedFree( memory );
+}
+
+void operator delete[]( void* memory, std::align_val_t ) noexcept
+{
+	AlignedFree( memory );
+}
+
+void operator delete( void* memory, std::size_t, std::align_val_t ) noexcept
+{
+	AlignedFree( memory );
+}
+
+void operator delete[]( void* memory, std::size_t, std::align_val_t ) noexcept
+{
+	AlignedFree( memory );
+}
+
+void operator delete( void* memory, std::align_val_t, const std::nothrow_t& ) noexcept
+{
+	AlignedFree( memory );
+}
+
+void operator delete[]( void* memory, std::align_val_t, const std::nothrow_t& ) noexcept
+{
+	AlignedFree( memory );
+}
+
+namespace Bench
+{
+	uint64_t GetAllocationCount()
+	{
+		return s_AllocationCount.load( std::memory_order_relaxed );
+	}
+}
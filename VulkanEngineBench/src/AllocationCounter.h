@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Bench
+{
+	// Heap allocations made through global operator new by any thread since startup, over-aligned ones
+	// included
+	uint64_t GetAllocationCount();
+}
@@ -0,0 +1,104 @@
+#include "BenchReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace Bench
+{
+
+	FrameTimeSummary Summarize( std::vector<float> samples )
+	{
+		FrameTimeSummary summary;
+		summary.SampleCount = ( uint32_t )samples.size();
+		if ( samples.empty() )
+			return summary;
+
+		std::sort( samples.begin(), samples.end() );
+
+		double sum = 0.0;
+		for ( float sample : samples )
+		{
+			sum += sample;
+		}
+
+		auto percentile = [&samples]( float p )
+		{
+			size_t rank = ( size_t )std::ceil( p * samples.size() );
+			return samples[ std::clamp<size_t>( rank, 1, samples.size() ) - 1 ];
+		};
+
+		summary.Average = ( float )( sum / samples.size() );
+		summary.P50 = percentile( 0.50f );
+		summary.P95 = percentile( 0.95f );
+		summary.P99 = percentile( 0.99f );
+		summary.Max = samples.back();
+		return summary;
+	}
+
+	static void WriteEscaped( std::ostream& stream, const std::string& string )
+	{
+		stream << '"';
+		for ( char c : string )
+		{
+			if ( c == '"' || c == '\\' )
+				stream << '\\';
+			stream << c;
+		}
+		stream << '"';
+	}
+
+	static void WriteSummary( std::ostream& stream, const char* name, const FrameTimeSummary& summary )
+	{
+		stream << "\t\t\t\"" << name << "\": { \"samples\": " << summary.SampleCount
+			<< ", \"avg\": " << summary.Average << ", \"p50\": " << summary.P50 << ", \"p95\": " << summary.P95
+			<< ", \"p99\": " << summary.P99 << ", \"max\": " << summary.Max << " }";
+	}
+
+	bool WriteReport( const Report& report, const std::filesystem::path& path )
+	{
+		if ( path.has_parent_path() )
+			std::filesystem::create_directories( path.parent_path() );
+
+		std::ofstream stream( path );
+		if ( !stream )
+			return false;
+
+		// Fixed precision and key order keep the output diffable between runs
+		stream << std::fixed << std::setprecision( 4 );
+		stream << "{\n";
+		stream << "\t\"device\": ";
+		WriteEscaped( stream, report.Device );
+		stream << ",\n\t\"configuration\": ";
+		WriteEscaped( stream, report.Configuration );
+		stream << ",\n\t\"width\": " << report.Width << ",\n\t\"height\": " << report.Height
+			<< ",\n\t\"framesInFlight\": " << report.FramesInFlight << ",\n\t\"workerCount\": " << report.WorkerCount
+			<< ",\n\t\"warmupFrames\": " << report.WarmupFrames << ",\n";
+
+		stream << "\t\"scenes\": [";
+		for ( size_t i = 0; i < report.Scenes.size(); i++ )
+		{
+			const SceneResult& scene = report.Scenes[ i ];
+
+			stream << ( i == 0 ? "\n" : ",\n" ) << "\t\t{\n\t\t\t\"name\": ";
+			WriteEscaped( stream, scene.Name );
+			stream << ",\n\t\t\t\"threads\": " << scene.ThreadCount << ",\n\t\t\t\"frames\": " << scene.FrameCount << ",\n";
+			WriteSummary( stream, "updateMs", scene.Update );
+			stream << ",\n\t\t\t\"updateSpeedup\": " << scene.UpdateSpeedup << ",\n";
+			WriteSummary( stream, "cpuFrameMs", scene.CPU );
+			stream << ",\n";
+			WriteSummary( stream, "gpuFrameMs", scene.GPU );
+			stream << ",\n";
+			WriteSummary( stream, "recordMs", scene.Record );
+			stream << ",\n\t\t\t\"recordSpeedup\": " << scene.RecordSpeedup
+				<< ",\n\t\t\t\"secondariesPerFrame\": " << scene.SecondariesPerFrame
+				<< ",\n\t\t\t\"allocationsPerFrame\": " << scene.AllocationsPerFrame
+				<< ",\n\t\t\t\"maxAllocationsPerFrame\": " << scene.MaxAllocationsPerFrame << "\n\t\t}";
+		}
+		stream << "\n\t]\n}\n";
+
+		return ( bool )stream;
+	}
+
+}
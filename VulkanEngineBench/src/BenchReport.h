@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+	// Milliseconds
+	struct FrameTimeSummary
+	{
+		uint32_t SampleCount = 0;
+		float Average = 0.0f;
+		float P50 = 0.0f;
+		float P95 = 0.0f;
+		float P99 = 0.0f;
+		float Max = 0.0f;
+	};
+
+	// Percentiles use the nearest rank, so they are always one of the samples
+	FrameTimeSummary Summarize( std::vector<float> samples );
+
+	struct SceneResult
+	{
+		std::string Name;
+		// Main thread plus active workers
+		uint32_t ThreadCount = 0;
+		uint32_t FrameCount = 0;
+
+		// Main thread time spent in the scene update
+		FrameTimeSummary Update;
+		// Update average of the one thread run of the scene over this one, only set by a thread sweep
+		float UpdateSpeedup = 1.0f;
+		// Main loop iteration, which includes waiting on the render thread
+		FrameTimeSummary CPU;
+		// Command buffer execution between the first and last timestamp of a frame
+		FrameTimeSummary GPU;
+		// Render thread time spent recording secondary command buffers
+		FrameTimeSummary Record;
+		// Record average of the one thread run over this one, only set by a thread sweep
+		float RecordSpeedup = 1.0f;
+		float SecondariesPerFrame = 0.0f;
+
+		float AllocationsPerFrame = 0.0f;
+		uint64_t MaxAllocationsPerFrame = 0;
+	};
+
+	struct Report
+	{
+		std::string Device;
+		std::string Configuration;
+		uint32_t Width = 0, Height = 0;
+		uint32_t FramesInFlight = 0;
+		uint32_t WorkerCount = 0;
+		uint32_t WarmupFrames = 0;
+
+		std::vector<SceneResult> Scenes;
+	};
+
+	bool WriteReport( const Report& report, const std::filesystem::path& path );
+}
@@ -0,0 +1,69 @@
+#include "BenchScenes.h"
+
+#include <cmath>
+
+namespace Bench
+{
+
+	// Secondary command buffer items recorded per frame by the ParallelRecord scene
+	static constexpr uint32_t s_RecordItemCount = 20000;
+	// Elements updated per frame by the JobSystem scene
+	static constexpr uint32_t s_ParticleCount = 1 << 20;
+
+	static std::vector<float> s_Particles;
+
+	static void RecordItems( VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end )
+	{
+		// Dynamic state only, so the scene measures recording overhead without needing pipelines or geometry
+		for ( uint32_t i = begin; i < end; i++ )
+		{
+			VkViewport viewport{};
+			viewport.x = ( float )( i % 64 );
+			viewport.y = ( float )( ( i / 64 ) % 64 );
+			viewport.width = 1.0f;
+			viewport.height = 1.0f;
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+			vkCmdSetViewport( commandBuffer, 0, 1, &viewport );
+
+			VkRect2D scissor{};
+			scissor.offset = { ( int32_t )viewport.x, ( int32_t )viewport.y };
+			scissor.extent = { 1, 1 };
+			vkCmdSetScissor( commandBuffer, 0, 1, &scissor );
+		}
+	}
+
+	std::vector<Scene> CreateScenes()
+	{
+		std::vector<Scene> scenes;
+
+		// Baseline: the swapchain pass clears the back buffer and nothing else is recorded
+		scenes.push_back( { "Clear", []( uint32_t frame ) {} } );
+
+		scenes.push_back( { "ParallelRecord", []( uint32_t frame )
+			{
+				VE::VulkanSwapChain& swapChain = VE::Application::Get().GetWindow().GetSwapChain();
+				VE::Renderer::Submit( [&swapChain]()
+					{
+						swapChain.SubmitParallel( s_RecordItemCount, RecordItems );
+					} );
+			} } );
+
+		scenes.push_back( { "JobSystem", []( uint32_t frame )
+			{
+				if ( s_Particles.empty() )
+					s_Particles.resize( s_ParticleCount, 1.0f );
+
+				VE::JobSystem::ParallelFor( s_ParticleCount, 4096, [frame]( uint32_t begin, uint32_t end )
+					{
+						for ( uint32_t i = begin; i < end; i++ )
+						{
+							s_Particles[ i ] = std::sin( s_Particles[ i ] + frame * 0.001f ) * 0.5f + i * 0.000001f;
+						}
+					} );
+			} } );
+
+		return scenes;
+	}
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "VulkanEngine.h"
+
+namespace Bench
+{
+	struct Scene
+	{
+		std::string Name;
+		// Main thread, once per warmup and measured frame. Submits the work of the scene for that frame.
+		std::function<void( uint32_t frame )> Update;
+	};
+
+	std::vector<Scene> CreateScenes();
+}
@@ -0,0 +1,272 @@
+#include "VulkanEngine.h"
+#include "Core/EntryPoint.h"
+
+#include "AllocationCounter.h"
+#include "BenchReport.h"
+#include "BenchScenes.h"
+
+#include <mutex>
+
+struct BenchSettings
+{
+	uint32_t FrameCount = 1000;
+	uint32_t WarmupFrames = 60;
+	// Empty runs every scene
+	std::vector<std::string> Scenes;
+	// Runs every scene once per thread count from 1 to every worker plus the main thread
+	bool SweepThreads = false;
+	std::filesystem::path OutputPath = "bench/results.json";
+};
+
+// Runs each scene for WarmupFrames and then FrameCount measured frames through the regular application loop,
+// then writes the report and closes. With SweepThreads each scene runs once per active worker count.
+class VulkanEngineBenchApplication : public VE::Application
+{
+public:
+	VulkanEngineBenchApplication( const VE::ApplicationSpecification& specification, const BenchSettings& settings )
+		: Application( specification ), m_Settings( settings )
+	{
+		for ( auto& scene : Bench::CreateScenes() )
+		{
+			bool selected = m_Settings.Scenes.empty() || std::find( m_Settings.Scenes.begin(), m_Settings.Scenes.end(), scene.Name ) != m_Settings.Scenes.end();
+			if ( selected )
+				m_Scenes.push_back( std::move( scene ) );
+		}
+
+		// GPU timings are read back once the frame slot comes round again, so the first samples of a scene
+		// belong to frames that are that far behind. Those have to be warmup frames of the same scene.
+		uint32_t framesInFlight = VE::Renderer::GetConfig().FramesInFlight;
+		m_Settings.WarmupFrames = std::max( m_Settings.WarmupFrames, framesInFlight + 1 );
+
+		uint32_t maxThreadCount = VE::JobSystem::GetWorkerCount() + 1;
+		for ( uint32_t sceneIndex = 0; sceneIndex < m_Scenes.size(); sceneIndex++ )
+		{
+			for ( uint32_t threadCount = m_Settings.SweepThreads ? 1 : maxThreadCount; threadCount <= maxThreadCount; threadCount++ )
+				m_Runs.push_back( { sceneIndex, threadCount } );
+		}
+
+		m_Samples.resize( m_Runs.size() );
+		m_Report.Scenes.resize( m_Runs.size() );
+
+		if ( m_Scenes.empty() )
+			VE_ERROR( "bench: no scene matches the selection" );
+	}
+
+	virtual void OnRender( float alpha ) override
+	{
+		uint64_t allocationCount = Bench::GetAllocationCount();
+		float frameTime = m_FrameTimer.ElapsedMillis();
+		m_FrameTimer.Reset();
+
+		// The interval that just ended is the previous frame
+		if ( m_PreviousFrameMeasured )
+		{
+			SceneSamples& samples = m_Samples[ m_RunIndex ];
+			samples.CPU.push_back( frameTime );
+			samples.Allocations.push_back( allocationCount - m_AllocationCount );
+		}
+		m_AllocationCount = Bench::GetAllocationCount();
+		m_PreviousFrameMeasured = false;
+
+		if ( m_RunIndex < m_Runs.size() && m_Samples[ m_RunIndex ].CPU.size() == m_Settings.FrameCount )
+		{
+			VE_INFO( "bench: finished {0} on {1} threads", m_Scenes[ m_Runs[ m_RunIndex ].Scene ].Name, m_Runs[ m_RunIndex ].ThreadCount );
+			m_RunIndex++;
+			m_Frame = 0;
+		}
+
+		if ( m_RunIndex >= m_Runs.size() )
+		{
+			// Render commands of frame n have executed once the main thread has waited on the render thread
+			// twice more, after that no more samples arrive
+			if ( m_DrainFrames++ == 2 )
+				Finish();
+			return;
+		}
+
+		const Run& run = m_Runs[ m_RunIndex ];
+
+		// Render thread jobs still queued from the previous run finish during warmup
+		if ( m_Frame == 0 )
+			VE::JobSystem::SetActiveWorkerCount( run.ThreadCount - 1 );
+
+		VE::Timer updateTimer;
+		m_Scenes[ run.Scene ].Update( m_Frame );
+		float updateTime = updateTimer.ElapsedMillis();
+
+		if ( m_Frame >= m_Settings.WarmupFrames )
+		{
+			m_PreviousFrameMeasured = true;
+			m_Samples[ m_RunIndex ].Update.push_back( updateTime );
+
+			uint32_t runIndex = m_RunIndex;
+			VE::Renderer::Submit( [this, runIndex]()
+				{
+					auto device = VE::VulkanInstance::GetCurrentDevice();
+					auto& gpuProfiler = device->GetGPUProfiler();
+					auto& recorder = GetWindow().GetSwapChain().GetCommandRecorder();
+
+					std::lock_guard<std::mutex> lock( m_Mutex );
+					SceneSamples& samples = m_Samples[ runIndex ];
+					VE::GPURegionTiming frameTiming = gpuProfiler.GetFrameTiming();
+					if ( gpuProfiler.IsSupported() && frameTiming.SampleCount > 0 )
+						samples.GPU.push_back( frameTiming.Last );
+					samples.Record.push_back( recorder.GetStatistics().RecordTime );
+					samples.SecondaryCount += recorder.GetStatistics().SecondaryCount;
+				} );
+		}
+
+		m_Frame++;
+	}
+
+private:
+	void Finish()
+	{
+		m_Report.Device = VE::VulkanInstance::GetCurrentDevice()->GetPhysicalDevice()->GetProperties().deviceName;
+#if defined(VE_DEBUG)
+		m_Report.Configuration = "Debug";
+#elif defined(VE_RELEASE)
+		m_Report.Configuration = "Release";
+#else
+		m_Report.Configuration = "Dist";
+#endif
+		m_Report.Width = GetWindow().GetWidth();
+		m_Report.Height = GetWindow().GetHeight();
+		m_Report.FramesInFlight = VE::Renderer::GetConfig().FramesInFlight;
+		m_Report.WorkerCount = VE::JobSystem::GetWorkerCount();
+		m_Report.WarmupFrames = m_Settings.WarmupFrames;
+
+		{
+			std::lock_guard<std::mutex> lock( m_Mutex );
+
+			for ( size_t i = 0; i < m_Runs.size(); i++ )
+			{
+				SceneSamples& samples = m_Samples[ i ];
+				Bench::SceneResult& result = m_Report.Scenes[ i ];
+
+				result.Name = m_Scenes[ m_Runs[ i ].Scene ].Name;
+				result.ThreadCount = m_Runs[ i ].ThreadCount;
+				result.FrameCount = ( uint32_t )samples.CPU.size();
+				result.Update = Bench::Summarize( samples.Update );
+				result.CPU = Bench::Summarize( samples.CPU );
+				result.GPU = Bench::Summarize( samples.GPU );
+				result.Record = Bench::Summarize( samples.Record );
+				result.SecondariesPerFrame = samples.Record.empty() ? 0.0f : ( float )samples.SecondaryCount / samples.Record.size();
+
+				uint64_t allocationCount = 0;
+				for ( uint64_t count : samples.Allocations )
+				{
+					allocationCount += count;
+					result.MaxAllocationsPerFrame = std::max( result.MaxAllocationsPerFrame, count );
+				}
+				result.AllocationsPerFrame = samples.Allocations.empty() ? 0.0f : ( float )allocationCount / samples.Allocations.size();
+
+				VE_INFO( "bench: {0}: cpu avg {1:.3f}ms p99 {2:.3f}ms, gpu avg {3:.3f}ms p99 {4:.3f}ms, {5:.1f} allocations/frame",
+					result.Name, result.CPU.Average, result.CPU.P99, result.GPU.Average, result.GPU.P99, result.AllocationsPerFrame );
+			}
+		}
+
+		// Runs of a scene are consecutive and the sweep starts at one thread
+		if ( m_Settings.SweepThreads )
+		{
+			const Bench::SceneResult* baseline = nullptr;
+			for ( Bench::SceneResult& result : m_Report.Scenes )
+			{
+				if ( result.ThreadCount == 1 )
+					baseline = &result;
+
+				if ( result.Update.Average > 0.0f )
+					result.UpdateSpeedup = baseline->Update.Average / result.Update.Average;
+				if ( result.Record.Average > 0.0f )
+					result.RecordSpeedup = baseline->Record.Average / result.Record.Average;
+
+				VE_INFO( "bench: {0} on {1} threads: update avg {2:.3f}ms, {3:.2f}x speedup, record avg {4:.3f}ms, {5:.2f}x speedup, {6:.1f} secondaries/frame",
+					result.Name, result.ThreadCount, result.Update.Average, result.UpdateSpeedup,
+					result.Record.Average, result.RecordSpeedup, result.SecondariesPerFrame );
+			}
+		}
+
+		if ( Bench::WriteReport( m_Report, m_Settings.OutputPath ) )
+			VE_INFO( "bench: wrote {0}", m_Settings.OutputPath.string() );
+		else
+			VE_ERROR( "bench: could not write {0}", m_Settings.OutputPath.string() );
+
+		Close();
+	}
+
+private:
+	struct SceneSamples
+	{
+		// Main thread
+		std::vector<float> CPU;
+		std::vector<float> Update;
+		std::vector<uint64_t> Allocations;
+		// Render thread, under m_Mutex
+		std::vector<float> GPU;
+		std::vector<float> Record;
+		uint64_t SecondaryCount = 0;
+	};
+
+	struct Run
+	{
+		uint32_t Scene;
+		uint32_t ThreadCount;
+	};
+
+	BenchSettings m_Settings;
+	std::vector<Bench::Scene> m_Scenes;
+	std::vector<Run> m_Runs;
+
+	uint32_t m_RunIndex = 0;
+	uint32_t m_Frame = 0;
+	uint32_t m_DrainFrames = 0;
+	bool m_PreviousFrameMeasured = false;
+
+	VE::Timer m_FrameTimer;
+	uint64_t m_AllocationCount = 0;
+
+	std::mutex m_Mutex;
+	std::vector<SceneSamples> m_Samples;
+	Bench::Report m_Report;
+};
+
+VE::Application* VE::CreateApplication( int argc, char** argv )
+{
+	VE::ApplicationSpecification specification;
+	specification.Name = "Vulkan Engine Bench";
+	specification.WindowWidth = 1280;
+	specification.WindowHeight = 720;
+	specification.VSync = false;
+	specification.Resizable = false;
+	specification.Headless = true;
+
+	BenchSettings settings;
+	for ( int i = 1; i < argc; i++ )
+	{
+		std::string arg = argv[ i ];
+		bool hasValue = i + 1 < argc;
+
+		if ( arg == "--frames" && hasValue )
+			settings.FrameCount = ( uint32_t )std::stoul( argv[ ++i ] );
+		else if ( arg == "--warmup" && hasValue )
+			settings.WarmupFrames = ( uint32_t )std::stoul( argv[ ++i ] );
+		else if ( arg == "--scene" && hasValue )
+			settings.Scenes.push_back( argv[ ++i ] );
+		else if ( arg == "--sweep-threads" )
+			settings.SweepThreads = true;
+		else if ( arg == "--output" && hasValue )
+			settings.OutputPath = argv[ ++i ];
+		else if ( arg == "--width" && hasValue )
+			specification.WindowWidth = ( uint32_t )std::stoul( argv[ ++i ] );
+		else if ( arg == "--height" && hasValue )
+			specification.WindowHeight = ( uint32_t )std::stoul( argv[ ++i ] );
+		else if ( arg == "--workers" && hasValue )
+			specification.WorkerThreadCount = ( uint32_t )std::stoul( argv[ ++i ] );
+		else
+			VE_WARN( "bench: ignoring argument {0}", arg );
+	}
+
+	VE_ASSERT( settings.FrameCount > 0, "--frames must be at least 1!" );
+
+	return new VulkanEngineBenchApplication( specification, settings );
+}
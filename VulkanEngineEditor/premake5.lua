@@ -29,6 +29,17 @@ project "VulkanEngineEditor"
 	filter "system:windows"
 		systemversion "latest"
 
+	filter "system:linux"
+		links
+		{
+			"%{Library.Vulkan_Linux}",
+			"%{Library.ShaderC_Linux}",
+			"%{Library.SPIRV_Cross_Linux}",
+			"%{Library.SPIRV_Cross_GLSL_Linux}",
+			"pthread",
+			"dl"
+		}
+
 	filter "configurations:Debug"
 		defines "VE_DEBUG"
 		runtime "Debug"
@@ -22,6 +22,17 @@ VE::Application* VE::CreateApplication( int argc, char** argv )
 	specification.WindowHeight = 900;
 	specification.VSync = true;
 	specification.Resizable = true;
+	// The editor mostly shows a static scene, frames are only rendered when something changes
+	specification.RenderOnDemand = true;
+#ifdef VE_PLATFORM_WINDOWS
+	for ( int i = 1; i < argc; i++ )
+	{
+		if ( std::string( argv[ i ] ) == "--headless" )
+			specification.Headless = true;
+	}
+#else
+	specification.Headless = true;
+#endif
 
 	return new VulkanEngineEditorApplication( specification );
 }
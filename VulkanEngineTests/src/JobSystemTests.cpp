@@ -0,0 +1,63 @@
+#include "TestFramework.h"
+
+#include "Core/JobSystem.h"
+
+using namespace VE;
+
+// Counters live on the stack and are destroyed as soon as Wait returns, so any access by a job after the
+// final decrement is a use after free. Run under a thread sanitizer to catch one that does not crash.
+
+VE_TEST( JobSystem_BackToBackParallelFor )
+{
+	JobSystem::Init( 4 );
+
+	for ( uint32_t iteration = 0; iteration < 20000; iteration++ )
+	{
+		std::atomic<uint32_t> sum = 0;
+		JobSystem::ParallelFor( 64, 1, [&sum]( uint32_t begin, uint32_t end )
+			{
+				for ( uint32_t i = begin; i < end; i++ )
+				{
+					sum.fetch_add( i, std::memory_order_relaxed );
+				}
+			} );
+
+		if ( sum != 64 * 63 / 2 )
+		{
+			VE_CHECK_EQUAL( sum.load(), 64u * 63u / 2u );
+			break;
+		}
+	}
+
+	JobSystem::Shutdown();
+}
+
+VE_TEST( JobSystem_DependenciesOnStackCounters )
+{
+	JobSystem::Init( 4 );
+
+	for ( uint32_t iteration = 0; iteration < 20000; iteration++ )
+	{
+		std::atomic<uint32_t> first = 0;
+		uint32_t secondSawFirst = 0;
+
+		JobCounter firstCounter;
+		JobCounter secondCounter;
+		for ( uint32_t i = 0; i < 4; i++ )
+		{
+			JobSystem::Run( [&first]() { first.fetch_add( 1, std::memory_order_relaxed ); }, &firstCounter );
+		}
+		JobSystem::Run( [&first, &secondSawFirst]() { secondSawFirst = first.load( std::memory_order_relaxed ); }, &secondCounter, &firstCounter );
+
+		JobSystem::Wait( secondCounter );
+		JobSystem::Wait( firstCounter );
+
+		if ( secondSawFirst != 4 )
+		{
+			VE_CHECK_EQUAL( secondSawFirst, 4u );
+			break;
+		}
+	}
+
+	JobSystem::Shutdown();
+}
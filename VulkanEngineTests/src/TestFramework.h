@@ -0,0 +1,45 @@
+#pragma once
+
+#include "vepch.h"
+
+namespace Test
+{
+	using TestFunc = void( * )();
+
+	struct TestCase
+	{
+		const char* Name;
+		TestFunc Func;
+	};
+
+	// Every test of the executable, in the order their files were initialized
+	std::vector<TestCase>& GetTests();
+
+	// Records a failed check of the running test, the test keeps running
+	void Fail( const char* file, int line, const std::string& message );
+
+	struct Registrar
+	{
+		Registrar( const char* name, TestFunc func )
+		{
+			GetTests().push_back( { name, func } );
+		}
+	};
+}
+
+#define VE_TEST(name) \
+	static void name(); \
+	static ::Test::Registrar s_##name##Registrar( #name, name ); \
+	static void name()
+
+#define VE_CHECK(check) \
+	do { if ( !( check ) ) ::Test::Fail( __FILE__, __LINE__, #check ); } while ( 0 )
+
+#define VE_CHECK_EQUAL(actual, expected) \
+	do \
+	{ \
+		auto&& checkActual = ( actual ); \
+		auto&& checkExpected = ( expected ); \
+		if ( !( checkActual == checkExpected ) ) \
+			::Test::Fail( __FILE__, __LINE__, fmt::format( "{0} == {1} ({2} vs {3})", #actual, #expected, checkActual, checkExpected ) ); \
+	} while ( 0 )
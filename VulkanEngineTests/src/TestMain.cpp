@@ -0,0 +1,52 @@
+#include "TestFramework.h"
+
+#include <cstdio>
+#include <filesystem>
+
+namespace Test
+{
+
+	static uint32_t s_FailureCount = 0;
+
+	std::vector<TestCase>& GetTests()
+	{
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+
+	void Fail( const char* file, int line, const std::string& message )
+	{
+		std::printf( "  %s:%d: check failed: %s\n", std::filesystem::path( file ).filename().string().c_str(), line, message.c_str() );
+		s_FailureCount++;
+	}
+
+}
+
+// Runs every test, or with an argument only those whose name contains it. Exits with 1 if any check failed.
+int main( int argc, char** argv )
+{
+	VE::Log::Init();
+
+	std::string filter = argc > 1 ? argv[ 1 ] : "";
+
+	uint32_t runCount = 0, failedCount = 0;
+	for ( const auto& test : Test::GetTests() )
+	{
+		if ( !filter.empty() && std::string( test.Name ).find( filter ) == std::string::npos )
+			continue;
+
+		uint32_t failuresBefore = Test::s_FailureCount;
+		test.Func();
+		runCount++;
+
+		bool passed = Test::s_FailureCount == failuresBefore;
+		if ( !passed )
+			failedCount++;
+		std::printf( "[%s] %s\n", passed ? " OK " : "FAIL", test.Name );
+	}
+
+	std::printf( "%u tests, %u failed\n", runCount, failedCount );
+
+	VE::Log::Shutdown();
+	return failedCount > 0 ? 1 : 0;
+}
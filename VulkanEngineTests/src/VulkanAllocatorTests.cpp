@@ -0,0 +1,304 @@
+#include "TestFramework.h"
+
+#include "Platform/Vulkan/VulkanAllocator.h"
+
+#include <map>
+
+using namespace VE;
+
+namespace
+{
+	// Device memory as seen by the fake, owned by the test so it can be inspected after the allocator is gone
+	struct FakeDevice
+	{
+		struct Allocation
+		{
+			VkDeviceSize Size;
+			uint32_t MemoryTypeIndex;
+			bool Mapped = false;
+		};
+
+		std::map<VkDeviceMemory, Allocation> Live;
+		uint64_t NextHandle = 0;
+	};
+
+	// Hands out made up handles and mapped pointers
+	class FakeDeviceMemory : public VulkanDeviceMemory
+	{
+	public:
+		FakeDeviceMemory( FakeDevice& device )
+			: m_Device( device )
+		{
+		}
+
+		virtual VkResult Allocate( const VkMemoryAllocateInfo& allocateInfo, VkDeviceMemory& outMemory ) override
+		{
+			outMemory = ( VkDeviceMemory )( uintptr_t )++m_Device.NextHandle;
+			m_Device.Live[ outMemory ] = { allocateInfo.allocationSize, allocateInfo.memoryTypeIndex };
+			return VK_SUCCESS;
+		}
+
+		virtual void Free( VkDeviceMemory memory ) override
+		{
+			auto it = m_Device.Live.find( memory );
+			VE_CHECK( it != m_Device.Live.end() );
+			if ( it == m_Device.Live.end() )
+				return;
+
+			VE_CHECK( !it->second.Mapped );
+			m_Device.Live.erase( it );
+		}
+
+		virtual VkResult Map( VkDeviceMemory memory, void*& outData ) override
+		{
+			m_Device.Live.at( memory ).Mapped = true;
+			outData = GetMappedBase( memory );
+			return VK_SUCCESS;
+		}
+
+		virtual void Unmap( VkDeviceMemory memory ) override
+		{
+			m_Device.Live.at( memory ).Mapped = false;
+		}
+
+		static uint8_t* GetMappedBase( VkDeviceMemory memory )
+		{
+			return ( uint8_t* )( ( uintptr_t )memory << 32 );
+		}
+
+	private:
+		FakeDevice& m_Device;
+	};
+
+	constexpr VkDeviceSize MB = 1024 * 1024;
+
+	// Heap 0 is 256MB of device local memory, heap 1 64MB of host memory, so blocks are 32MB and 8MB
+	VkPhysicalDeviceMemoryProperties GetMemoryProperties()
+	{
+		VkPhysicalDeviceMemoryProperties properties{};
+		properties.memoryHeapCount = 2;
+		properties.memoryHeaps[ 0 ].size = 256 * MB;
+		properties.memoryHeaps[ 1 ].size = 64 * MB;
+
+		properties.memoryTypeCount = 3;
+		properties.memoryTypes[ 0 ] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+		properties.memoryTypes[ 1 ] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1 };
+		properties.memoryTypes[ 2 ] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 1 };
+		return properties;
+	}
+
+	struct AllocatorFixture
+	{
+		FakeDevice Device;
+		Scope<VulkanAllocator> Allocator;
+
+		AllocatorFixture( uint32_t maxAllocationCount = 4096 )
+		{
+			Allocator = CreateScope<VulkanAllocator>( CreateScope<FakeDeviceMemory>( Device ), GetMemoryProperties(), maxAllocationCount );
+		}
+
+		VulkanAllocation* Allocate( VkDeviceSize size, VulkanMemoryUsage usage = VulkanMemoryUsage::GPUOnly, bool linear = true, bool dedicated = false )
+		{
+			VkMemoryRequirements requirements{};
+			requirements.size = size;
+			requirements.alignment = 256;
+			requirements.memoryTypeBits = 0x7;
+			return Allocator->AllocateMemory( requirements, usage, linear, dedicated );
+		}
+	};
+}
+
+VE_TEST( Allocator_SubAllocatesFromOneBlock )
+{
+	AllocatorFixture fixture;
+
+	std::vector<VulkanAllocation*> allocations;
+	for ( uint32_t i = 0; i < 10; i++ )
+	{
+		allocations.push_back( fixture.Allocate( 1 * MB ) );
+	}
+
+	VE_CHECK_EQUAL( fixture.Device.Live.size(), ( size_t )1 );
+	VE_CHECK_EQUAL( fixture.Device.Live.begin()->second.Size, 32 * MB );
+	for ( uint32_t i = 0; i < 10; i++ )
+	{
+		VE_CHECK( allocations[ i ]->Block != nullptr );
+		VE_CHECK( allocations[ i ]->Memory == allocations[ 0 ]->Memory );
+		VE_CHECK_EQUAL( allocations[ i ]->MemoryTypeIndex, 0u );
+		for ( uint32_t j = 0; j < i; j++ )
+		{
+			VE_CHECK( allocations[ i ]->Offset != allocations[ j ]->Offset );
+		}
+	}
+
+	for ( auto* allocation : allocations )
+	{
+		fixture.Allocator->Free( allocation );
+	}
+}
+
+VE_TEST( Allocator_GrowsAndFreesEmptyBlocks )
+{
+	AllocatorFixture fixture;
+
+	// Half a block is the largest size still sub-allocated, so each block holds two
+	VulkanAllocation* a = fixture.Allocate( 16 * MB );
+	VulkanAllocation* b = fixture.Allocate( 16 * MB );
+	VulkanAllocation* c = fixture.Allocate( 16 * MB );
+	VE_CHECK_EQUAL( fixture.Device.Live.size(), ( size_t )2 );
+	VE_CHECK( a->Memory == b->Memory );
+	VE_CHECK( c->Memory != a->Memory );
+	VE_CHECK_EQUAL( fixture.Allocator->GetDeviceAllocationCount(), 2u );
+
+	// An empty block is released as long as the pool keeps another one
+	fixture.Allocator->Free( c );
+	VE_CHECK_EQUAL( fixture.Device.Live.size(), ( size_t )1 );
+
+	// The last block stays around for the next allocation
+	fixture.Allocator->Free( a );
+	fixture.Allocator->Free( b );
+	VE_CHECK_EQUAL( fixture.Device.Live.size(), ( size_t )1 );
+
+	// Destroying the allocator releases the blocks it kept, unmapping host visible ones first
+	fixture.Allocator->Free( fixture.Allocate( 1 * MB, VulkanMemoryUsage::CPUToGPU ) );
+	VE_CHECK_EQUAL( fixture.Device.Live.size(), ( size_t )2 );
+	fixture.Allocator.reset();
+	VE_CHECK( fixture.Device.Live.empty() );
+}
+
+VE_TEST( Allocator_DedicatedThreshold )
+{
+	AllocatorFixture fixture;
+
+	VulkanAllocation* large = fixture.Allocate( 16 * MB + 1 );
+	VE_CHECK( large->Block == nullptr );
+	VE_CHECK_EQUAL( large->Offset, 0ull );
+	VE_CHECK_EQUAL( fixture.Device.Live.at( large->Memory ).Size, 16 * MB + 1 );
+
+	VulkanAllocation* requested = fixture.Allocate( 64 * 1024, VulkanMemoryUsage::GPUOnly, true, true );
+	VE_CHECK( requested->Block == nullptr );
+	VE_CHECK_EQUAL( fixture.Device.Live.at( requested->Memory ).Size, 64ull * 1024 );
+
+	auto heaps = fixture.Allocator->GetHeapStatistics();
+	VE_CHECK_EQUAL( heaps[ 0 ].DedicatedAllocationCount, 2u );
+	VE_CHECK_EQUAL( heaps[ 0 ].BlockCount, 0u );
+	VE_CHECK_EQUAL( heaps[ 0 ].UsedBytes, 16 * MB + 1 + 64 * 1024 );
+
+	// Dedicated memory goes straight back to the device
+	fixture.Allocator->Free( large );
+	fixture.Allocator->Free( requested );
+	VE_CHECK( fixture.Device.Live.empty() );
+	VE_CHECK_EQUAL( fixture.Allocator->GetHeapStatistics()[ 0 ].DedicatedAllocationCount, 0u );
+}
+
+VE_TEST( Allocator_SeparatesLinearAndOptimalResources )
+{
+	AllocatorFixture fixture;
+
+	VulkanAllocation* buffer = fixture.Allocate( 1 * MB, VulkanMemoryUsage::GPUOnly, true );
+	VulkanAllocation* image = fixture.Allocate( 1 * MB, VulkanMemoryUsage::GPUOnly, false );
+	VulkanAllocation* secondBuffer = fixture.Allocate( 1 * MB, VulkanMemoryUsage::GPUOnly, true );
+
+	VE_CHECK_EQUAL( fixture.Device.Live.size(), ( size_t )2 );
+	VE_CHECK( buffer->Memory != image->Memory );
+	VE_CHECK( buffer->Memory == secondBuffer->Memory );
+	VE_CHECK_EQUAL( buffer->MemoryTypeIndex, image->MemoryTypeIndex );
+
+	fixture.Allocator->Free( buffer );
+	fixture.Allocator->Free( image );
+	fixture.Allocator->Free( secondBuffer );
+}
+
+VE_TEST( Allocator_MapsHostVisibleMemory )
+{
+	AllocatorFixture fixture;
+
+	VulkanAllocation* deviceLocal = fixture.Allocate( 1 * MB, VulkanMemoryUsage::GPUOnly );
+	VulkanAllocation* upload = fixture.Allocate( 1 * MB, VulkanMemoryUsage::CPUToGPU );
+	VulkanAllocation* secondUpload = fixture.Allocate( 1 * MB, VulkanMemoryUsage::CPUToGPU );
+	VulkanAllocation* readback = fixture.Allocate( 1 * MB, VulkanMemoryUsage::GPUToCPU );
+
+	VE_CHECK_EQUAL( deviceLocal->MemoryTypeIndex, 0u );
+	VE_CHECK( deviceLocal->MappedData == nullptr );
+	VE_CHECK_EQUAL( upload->MemoryTypeIndex, 1u );
+	VE_CHECK_EQUAL( readback->MemoryTypeIndex, 2u );
+
+	// Blocks stay mapped and every allocation points at its own offset into the block
+	VE_CHECK( fixture.Device.Live.at( upload->Memory ).Mapped );
+	VE_CHECK( upload->MappedData == FakeDeviceMemory::GetMappedBase( upload->Memory ) + upload->Offset );
+	VE_CHECK( secondUpload->MappedData == FakeDeviceMemory::GetMappedBase( secondUpload->Memory ) + secondUpload->Offset );
+	VE_CHECK( readback->MappedData == FakeDeviceMemory::GetMappedBase( readback->Memory ) + readback->Offset );
+
+	// Freeing checks that the memory was unmapped first
+	for ( auto* allocation : { deviceLocal, upload, secondUpload, readback } )
+	{
+		fixture.Allocator->Free( allocation );
+	}
+}
+
+VE_TEST( Allocator_CountsDeviceAllocations )
+{
+	AllocatorFixture fixture( 4 );
+
+	std::vector<VulkanAllocation*> allocations;
+	for ( uint32_t i = 0; i < 6; i++ )
+	{
+		allocations.push_back( fixture.Allocate( 64 * 1024, VulkanMemoryUsage::GPUOnly, true, true ) );
+	}
+
+	// Going over the limit only warns, the count keeps tracking the device
+	VE_CHECK_EQUAL( fixture.Allocator->GetDeviceAllocationCount(), 6u );
+	VE_CHECK_EQUAL( fixture.Device.Live.size(), ( size_t )6 );
+
+	// Sub-allocations share one device allocation
+	VulkanAllocation* small = fixture.Allocate( 64 * 1024 );
+	VulkanAllocation* secondSmall = fixture.Allocate( 64 * 1024 );
+	VE_CHECK_EQUAL( fixture.Allocator->GetDeviceAllocationCount(), 7u );
+
+	for ( auto* allocation : allocations )
+	{
+		fixture.Allocator->Free( allocation );
+	}
+	fixture.Allocator->Free( small );
+	fixture.Allocator->Free( secondSmall );
+	VE_CHECK_EQUAL( fixture.Allocator->GetDeviceAllocationCount(), 1u );
+}
+
+VE_TEST( Allocator_HeapStatistics )
+{
+	AllocatorFixture fixture;
+
+	VulkanAllocation* a = fixture.Allocate( 1 * MB, VulkanMemoryUsage::GPUOnly );
+	VulkanAllocation* b = fixture.Allocate( 3 * MB, VulkanMemoryUsage::GPUOnly );
+	VulkanAllocation* upload = fixture.Allocate( 2 * MB, VulkanMemoryUsage::CPUToGPU );
+	VulkanAllocation* dedicated = fixture.Allocate( 5 * MB, VulkanMemoryUsage::CPUToGPU );
+
+	auto heaps = fixture.Allocator->GetHeapStatistics();
+	VE_CHECK_EQUAL( heaps.size(), ( size_t )2 );
+
+	// Sizes round up to powers of two inside a block
+	VE_CHECK_EQUAL( heaps[ 0 ].HeapSize, 256 * MB );
+	VE_CHECK_EQUAL( heaps[ 0 ].BlockCount, 1u );
+	VE_CHECK_EQUAL( heaps[ 0 ].AllocationCount, 2u );
+	VE_CHECK_EQUAL( heaps[ 0 ].DedicatedAllocationCount, 0u );
+	VE_CHECK_EQUAL( heaps[ 0 ].ReservedBytes, 32 * MB );
+	VE_CHECK_EQUAL( heaps[ 0 ].UsedBytes, 5 * MB );
+
+	// 5MB is over half of the 8MB host blocks and gets its own allocation
+	VE_CHECK_EQUAL( heaps[ 1 ].HeapSize, 64 * MB );
+	VE_CHECK_EQUAL( heaps[ 1 ].BlockCount, 1u );
+	VE_CHECK_EQUAL( heaps[ 1 ].AllocationCount, 2u );
+	VE_CHECK_EQUAL( heaps[ 1 ].DedicatedAllocationCount, 1u );
+	VE_CHECK_EQUAL( heaps[ 1 ].ReservedBytes, 8 * MB + 5 * MB );
+	VE_CHECK_EQUAL( heaps[ 1 ].UsedBytes, 2 * MB + 5 * MB );
+
+	for ( auto* allocation : { a, b, upload, dedicated } )
+	{
+		fixture.Allocator->Free( allocation );
+	}
+
+	heaps = fixture.Allocator->GetHeapStatistics();
+	VE_CHECK_EQUAL( heaps[ 0 ].UsedBytes, 0ull );
+	VE_CHECK_EQUAL( heaps[ 1 ].UsedBytes, 0ull );
+	VE_CHECK_EQUAL( heaps[ 1 ].DedicatedAllocationCount, 0u );
+}
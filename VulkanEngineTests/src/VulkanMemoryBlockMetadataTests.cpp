@@ -0,0 +1,152 @@
+#include "TestFramework.h"
+
+#include "Platform/Vulkan/VulkanMemoryBlockMetadata.h"
+
+using namespace VE;
+
+// The metadata only tracks offsets, so a block of any size can be driven without a device
+
+VE_TEST( MemoryBlockMetadata_FreeMergesBuddies )
+{
+	VulkanMemoryBlockMetadata metadata( 1024, 64 );
+
+	uint64_t a, b;
+	VE_CHECK( metadata.Allocate( 64, 1, a ) );
+	VE_CHECK( metadata.Allocate( 64, 1, b ) );
+	VE_CHECK_EQUAL( a, 0ull );
+	VE_CHECK_EQUAL( b, 64ull );
+	VE_CHECK_EQUAL( metadata.GetLargestFreeRange(), 512ull );
+
+	metadata.Free( a );
+	VE_CHECK_EQUAL( metadata.GetLargestFreeRange(), 512ull );
+
+	// Freeing the second half of the pair merges all the way back up to the whole block
+	metadata.Free( b );
+	VE_CHECK( metadata.IsEmpty() );
+	VE_CHECK_EQUAL( metadata.GetLargestFreeRange(), 1024ull );
+	VE_CHECK_EQUAL( metadata.GetUsedSize(), 0ull );
+}
+
+VE_TEST( MemoryBlockMetadata_SizesRoundUpToPowersOfTwo )
+{
+	VulkanMemoryBlockMetadata metadata( 1024, 64 );
+
+	uint64_t offset;
+	VE_CHECK( metadata.Allocate( 100, 1, offset ) );
+	VE_CHECK_EQUAL( metadata.GetUsedSize(), 128ull );
+
+	// Below the minimum allocation size
+	VE_CHECK( metadata.Allocate( 1, 1, offset ) );
+	VE_CHECK_EQUAL( metadata.GetUsedSize(), 192ull );
+}
+
+VE_TEST( MemoryBlockMetadata_Alignment )
+{
+	VulkanMemoryBlockMetadata metadata( 4096, 64 );
+
+	uint64_t first, aligned;
+	VE_CHECK( metadata.Allocate( 64, 1, first ) );
+	VE_CHECK( metadata.Allocate( 64, 1024, aligned ) );
+	VE_CHECK_EQUAL( aligned % 1024, 0ull );
+	VE_CHECK( aligned != first );
+	// The alignment is paid for with a range of that size
+	VE_CHECK_EQUAL( metadata.GetUsedSize(), 64ull + 1024ull );
+
+	for ( uint64_t alignment = 64; alignment <= 1024; alignment *= 2 )
+	{
+		uint64_t offset;
+		VE_CHECK( metadata.Allocate( 64, alignment, offset ) );
+		VE_CHECK_EQUAL( offset % alignment, 0ull );
+	}
+}
+
+VE_TEST( MemoryBlockMetadata_Exhaustion )
+{
+	VulkanMemoryBlockMetadata metadata( 1024, 64 );
+
+	uint64_t offset;
+	VE_CHECK( !metadata.Allocate( 2048, 1, offset ) );
+	VE_CHECK( !metadata.Allocate( 64, 2048, offset ) );
+
+	std::vector<uint64_t> offsets;
+	while ( metadata.Allocate( 64, 1, offset ) )
+		offsets.push_back( offset );
+
+	VE_CHECK_EQUAL( offsets.size(), ( size_t )16 );
+	VE_CHECK_EQUAL( metadata.GetFreeSize(), 0ull );
+	VE_CHECK_EQUAL( metadata.GetLargestFreeRange(), 0ull );
+
+	// A freed range is handed out again
+	metadata.Free( offsets[ 5 ] );
+	VE_CHECK( metadata.Allocate( 64, 1, offset ) );
+	VE_CHECK_EQUAL( offset, offsets[ 5 ] );
+	VE_CHECK( !metadata.Allocate( 64, 1, offset ) );
+}
+
+VE_TEST( MemoryBlockMetadata_Statistics )
+{
+	VulkanMemoryBlockMetadata metadata( 1024, 64 );
+
+	std::vector<uint64_t> offsets( 4 );
+	for ( auto& offset : offsets )
+		VE_CHECK( metadata.Allocate( 256, 1, offset ) );
+
+	VE_CHECK_EQUAL( metadata.GetSize(), 1024ull );
+	VE_CHECK_EQUAL( metadata.GetAllocationCount(), 4u );
+	VE_CHECK_EQUAL( metadata.GetUsedSize(), 1024ull );
+
+	// Two free ranges that are not buddies stay apart, half the block is free but only a quarter is usable at once
+	metadata.Free( offsets[ 0 ] );
+	metadata.Free( offsets[ 2 ] );
+	VE_CHECK_EQUAL( metadata.GetAllocationCount(), 2u );
+	VE_CHECK_EQUAL( metadata.GetFreeSize(), 512ull );
+	VE_CHECK_EQUAL( metadata.GetLargestFreeRange(), 256ull );
+
+	uint64_t offset;
+	VE_CHECK( !metadata.Allocate( 512, 1, offset ) );
+}
+
+VE_TEST( MemoryBlockMetadata_RandomAllocateFree )
+{
+	const uint64_t blockSize = 1 << 20;
+	VulkanMemoryBlockMetadata metadata( blockSize, 256 );
+
+	std::mt19937 random( 1234 );
+	std::uniform_int_distribution<uint64_t> sizes( 1, 16384 );
+
+	std::vector<std::pair<uint64_t, uint64_t>> allocations;
+	for ( uint32_t i = 0; i < 2000; i++ )
+	{
+		if ( !allocations.empty() && random() % 3 == 0 )
+		{
+			size_t index = random() % allocations.size();
+			metadata.Free( allocations[ index ].first );
+			allocations.erase( allocations.begin() + index );
+			continue;
+		}
+
+		uint64_t size = sizes( random );
+		uint64_t offset;
+		if ( !metadata.Allocate( size, 256, offset ) )
+			continue;
+
+		VE_CHECK_EQUAL( offset % 256, 0ull );
+		VE_CHECK( offset + size <= blockSize );
+
+		// No live allocation overlaps another
+		for ( const auto& [otherOffset, otherSize] : allocations )
+			VE_CHECK( offset + size <= otherOffset || otherOffset + otherSize <= offset );
+
+		allocations.push_back( { offset, size } );
+	}
+
+	VE_CHECK_EQUAL( metadata.GetAllocationCount(), ( uint32_t )allocations.size() );
+
+	std::shuffle( allocations.begin(), allocations.end(), random );
+	for ( const auto& allocation : allocations )
+		metadata.Free( allocation.first );
+
+	VE_CHECK( metadata.IsEmpty() );
+	VE_CHECK_EQUAL( metadata.GetUsedSize(), 0ull );
+	VE_CHECK_EQUAL( metadata.GetLargestFreeRange(), blockSize );
+}
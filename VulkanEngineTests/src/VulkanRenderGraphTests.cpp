@@ -0,0 +1,256 @@
+#include "TestFramework.h"
+
+#include "Platform/Vulkan/VulkanRenderGraph.h"
+
+using namespace VE;
+
+// Graphs without a device are only planned, the statistics and the dump describe what Compile decided
+
+static RenderGraphTextureDesc TextureDesc( uint32_t width, uint32_t height, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM )
+{
+	RenderGraphTextureDesc desc;
+	desc.Width = width;
+	desc.Height = height;
+	desc.Format = format;
+	return desc;
+}
+
+static RenderGraphResource ImportBackBuffer( VulkanRenderGraph& graph, uint32_t width, uint32_t height, VkFormat format = VK_FORMAT_B8G8R8A8_UNORM )
+{
+	return graph.ImportTexture( "BackBuffer", TextureDesc( width, height, format ), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR );
+}
+
+// GBuffer and Lighting share their attachments and become two subpasses, Tonemap samples an attachment of
+// that render pass and needs one of its own
+static void BuildDeferredGraph( VulkanRenderGraph& graph, uint32_t width, uint32_t height, VkFormat backBufferFormat = VK_FORMAT_B8G8R8A8_UNORM )
+{
+	RenderGraphResource backBuffer = ImportBackBuffer( graph, width, height, backBufferFormat );
+	RenderGraphResource albedo = graph.CreateTexture( "Albedo", TextureDesc( width, height ) );
+	RenderGraphResource depth = graph.CreateTexture( "Depth", TextureDesc( width, height, VK_FORMAT_D32_SFLOAT ) );
+
+	auto& gbuffer = graph.AddGraphicsPass( "GBuffer" );
+	gbuffer.WriteColor( albedo, RenderGraphLoadOp::Clear );
+	gbuffer.WriteDepthStencil( depth, RenderGraphLoadOp::Clear );
+
+	auto& lighting = graph.AddGraphicsPass( "Lighting" );
+	lighting.ReadDepthStencil( depth );
+	lighting.WriteColor( backBuffer, RenderGraphLoadOp::Clear );
+
+	auto& tonemap = graph.AddGraphicsPass( "Tonemap" );
+	tonemap.ReadTexture( albedo );
+	tonemap.WriteColor( backBuffer );
+}
+
+VE_TEST( RenderGraph_CullsPassesWithoutReaders )
+{
+	VulkanRenderGraph graph( nullptr );
+	RenderGraphResource backBuffer = ImportBackBuffer( graph, 256, 256 );
+	RenderGraphResource shadowMap = graph.CreateTexture( "ShadowMap", TextureDesc( 512, 512, VK_FORMAT_D32_SFLOAT ) );
+	RenderGraphResource debug = graph.CreateTexture( "Debug", TextureDesc( 256, 256 ) );
+
+	// Debug is never read, so neither it nor the shadow map it is the only reader of are needed
+	auto& shadow = graph.AddGraphicsPass( "Shadow" );
+	shadow.WriteDepthStencil( shadowMap, RenderGraphLoadOp::Clear );
+
+	auto& debugView = graph.AddGraphicsPass( "DebugView" );
+	debugView.ReadTexture( shadowMap );
+	debugView.WriteColor( debug, RenderGraphLoadOp::Clear );
+
+	auto& main = graph.AddGraphicsPass( "Main" );
+	main.WriteColor( backBuffer, RenderGraphLoadOp::Clear );
+
+	graph.Compile();
+
+	const RenderGraphStatistics& statistics = graph.GetStatistics();
+	VE_CHECK_EQUAL( statistics.PassCount, 3u );
+	VE_CHECK_EQUAL( statistics.CulledPassCount, 2u );
+	VE_CHECK_EQUAL( statistics.RenderPassCount, 1u );
+	VE_CHECK_EQUAL( statistics.TransientCount, 0u );
+	VE_CHECK( shadow.IsCulled() );
+	VE_CHECK( debugView.IsCulled() );
+	VE_CHECK( !main.IsCulled() );
+	VE_CHECK( graph.Dump().find( "culled: DebugView" ) != std::string::npos );
+}
+
+VE_TEST( RenderGraph_OutputsAndSideEffectsKeepPasses )
+{
+	VulkanRenderGraph graph( nullptr );
+	RenderGraphResource shadowMap = graph.CreateTexture( "ShadowMap", TextureDesc( 512, 512, VK_FORMAT_D32_SFLOAT ) );
+	RenderGraphResource debug = graph.CreateTexture( "Debug", TextureDesc( 256, 256 ) );
+	RenderGraphResource readback = graph.CreateTexture( "Readback", TextureDesc( 64, 64 ) );
+
+	auto& shadow = graph.AddGraphicsPass( "Shadow" );
+	shadow.WriteDepthStencil( shadowMap, RenderGraphLoadOp::Clear );
+
+	auto& debugView = graph.AddGraphicsPass( "DebugView" );
+	debugView.ReadTexture( shadowMap );
+	debugView.WriteColor( debug, RenderGraphLoadOp::Clear );
+	graph.MarkOutput( debug );
+
+	auto& capture = graph.AddComputePass( "Capture" );
+	capture.WriteStorage( readback );
+	capture.SetSideEffects();
+
+	graph.Compile();
+
+	const RenderGraphStatistics& statistics = graph.GetStatistics();
+	VE_CHECK_EQUAL( statistics.CulledPassCount, 0u );
+	VE_CHECK_EQUAL( statistics.TransientCount, 3u );
+	VE_CHECK( !shadow.IsCulled() );
+	VE_CHECK( !capture.IsCulled() );
+}
+
+VE_TEST( RenderGraph_MergesCompatiblePasses )
+{
+	VulkanRenderGraph graph( nullptr );
+	BuildDeferredGraph( graph, 256, 256 );
+	graph.Compile();
+
+	const RenderGraphStatistics& statistics = graph.GetStatistics();
+	VE_CHECK_EQUAL( statistics.RenderPassCount, 2u );
+	VE_CHECK_EQUAL( statistics.MergedPassCount, 1u );
+
+	std::string dump = graph.Dump();
+	VE_CHECK( dump.find( "subpass 1: Lighting" ) != std::string::npos );
+	VE_CHECK( dump.find( "subpass 0: Tonemap" ) != std::string::npos );
+
+	// Albedo is the only texture used outside an attachment, the back buffer reaches its final layout through
+	// the render passes
+	VE_CHECK_EQUAL( statistics.ImageBarrierCount, 1u );
+	VE_CHECK_EQUAL( statistics.PipelineBarrierCount, 1u );
+	VE_CHECK( dump.find( "barrier Albedo: COLOR_ATTACHMENT -> SHADER_READ_ONLY" ) != std::string::npos );
+}
+
+VE_TEST( RenderGraph_DoesNotMergeDifferentSizes )
+{
+	VulkanRenderGraph graph( nullptr );
+	RenderGraphResource backBuffer = ImportBackBuffer( graph, 256, 256 );
+	RenderGraphResource shadowMap = graph.CreateTexture( "ShadowMap", TextureDesc( 512, 512, VK_FORMAT_D32_SFLOAT ) );
+	RenderGraphResource depth = graph.CreateTexture( "Depth", TextureDesc( 256, 256, VK_FORMAT_D32_SFLOAT ) );
+
+	auto& shadow = graph.AddGraphicsPass( "Shadow" );
+	shadow.WriteDepthStencil( shadowMap, RenderGraphLoadOp::Clear );
+	shadow.SetSideEffects();
+
+	auto& main = graph.AddGraphicsPass( "Main" );
+	main.WriteDepthStencil( depth, RenderGraphLoadOp::Clear );
+	main.WriteColor( backBuffer, RenderGraphLoadOp::Clear );
+
+	graph.Compile();
+
+	VE_CHECK_EQUAL( graph.GetStatistics().RenderPassCount, 2u );
+	VE_CHECK_EQUAL( graph.GetStatistics().MergedPassCount, 0u );
+}
+
+VE_TEST( RenderGraph_BarrierCounts )
+{
+	VulkanRenderGraph graph( nullptr );
+	RenderGraphResource backBuffer = ImportBackBuffer( graph, 256, 256 );
+	RenderGraphResource particles = graph.CreateTexture( "Particles", TextureDesc( 256, 256, VK_FORMAT_R16G16B16A16_SFLOAT ) );
+	RenderGraphResource blurred = graph.CreateTexture( "Blurred", TextureDesc( 256, 256 ) );
+
+	auto& simulate = graph.AddComputePass( "Simulate" );
+	simulate.WriteStorage( particles );
+
+	auto& blur = graph.AddGraphicsPass( "Blur" );
+	blur.ReadTexture( particles );
+	blur.WriteColor( blurred, RenderGraphLoadOp::Clear );
+
+	auto& composite = graph.AddGraphicsPass( "Composite" );
+	composite.ReadTexture( particles );
+	composite.ReadTexture( blurred );
+	composite.WriteColor( backBuffer, RenderGraphLoadOp::Clear );
+
+	graph.Compile();
+
+	// Particles: into GENERAL for the compute write, then to SHADER_READ_ONLY once. The second read in the
+	// same layout needs no barrier. Blurred: from its attachment layout to SHADER_READ_ONLY.
+	const RenderGraphStatistics& statistics = graph.GetStatistics();
+	VE_CHECK_EQUAL( statistics.RenderPassCount, 2u );
+	VE_CHECK_EQUAL( statistics.ImageBarrierCount, 3u );
+	VE_CHECK_EQUAL( statistics.PipelineBarrierCount, 3u );
+	// One per use without state tracking: four sampled or storage uses and two attachments
+	VE_CHECK_EQUAL( statistics.UntrackedBarrierCount, 6u );
+
+	std::string dump = graph.Dump();
+	VE_CHECK( dump.find( "barrier Particles: UNDEFINED -> GENERAL" ) != std::string::npos );
+	VE_CHECK( dump.find( "barrier Particles: GENERAL -> SHADER_READ_ONLY" ) != std::string::npos );
+	VE_CHECK( dump.find( "barrier Blurred: COLOR_ATTACHMENT -> SHADER_READ_ONLY" ) != std::string::npos );
+}
+
+VE_TEST( RenderGraph_AliasesTransientMemory )
+{
+	// A ping-pong chain: A is dead once B has been written, so C can take its memory
+	auto buildChain = []( VulkanRenderGraph& graph, bool readFirstAtEnd )
+	{
+		RenderGraphResource backBuffer = ImportBackBuffer( graph, 256, 256 );
+		RenderGraphResource a = graph.CreateTexture( "A", TextureDesc( 256, 256 ) );
+		RenderGraphResource b = graph.CreateTexture( "B", TextureDesc( 256, 256 ) );
+		RenderGraphResource c = graph.CreateTexture( "C", TextureDesc( 256, 256 ) );
+
+		auto& passA = graph.AddGraphicsPass( "PassA" );
+		passA.WriteColor( a, RenderGraphLoadOp::Clear );
+
+		auto& passB = graph.AddGraphicsPass( "PassB" );
+		passB.ReadTexture( a );
+		passB.WriteColor( b, RenderGraphLoadOp::Clear );
+
+		auto& passC = graph.AddGraphicsPass( "PassC" );
+		passC.ReadTexture( b );
+		passC.WriteColor( c, RenderGraphLoadOp::Clear );
+
+		auto& final = graph.AddGraphicsPass( "Final" );
+		final.ReadTexture( c );
+		if ( readFirstAtEnd )
+			final.ReadTexture( a );
+		final.WriteColor( backBuffer, RenderGraphLoadOp::Clear );
+	};
+
+	// 256x256 RGBA8 is exactly 256KB
+	const VkDeviceSize textureSize = 256 * 1024;
+
+	{
+		VulkanRenderGraph graph( nullptr );
+		buildChain( graph, false );
+		graph.Compile();
+
+		const RenderGraphStatistics& statistics = graph.GetStatistics();
+		VE_CHECK_EQUAL( statistics.TransientCount, 3u );
+		VE_CHECK_EQUAL( statistics.TransientBytes, 3 * textureSize );
+		VE_CHECK_EQUAL( statistics.AllocationCount, 2u );
+		VE_CHECK_EQUAL( statistics.AllocatedBytes, 2 * textureSize );
+		VE_CHECK( graph.Dump().find( "768KB aliased into 512KB in 2 allocations" ) != std::string::npos );
+	}
+
+	// Keeping A alive until the end overlaps every lifetime, nothing can be shared
+	{
+		VulkanRenderGraph graph( nullptr );
+		buildChain( graph, true );
+		graph.Compile();
+
+		const RenderGraphStatistics& statistics = graph.GetStatistics();
+		VE_CHECK_EQUAL( statistics.AllocationCount, 3u );
+		VE_CHECK_EQUAL( statistics.AllocatedBytes, statistics.TransientBytes );
+	}
+}
+
+VE_TEST( RenderGraph_ReusesRenderPassesAcrossResizes )
+{
+	VulkanRenderGraph graph( nullptr );
+	BuildDeferredGraph( graph, 256, 256 );
+	graph.Compile();
+	VE_CHECK_EQUAL( graph.GetStatistics().ReusedRenderPassCount, 0u );
+
+	// Only the extent changed, both render passes come from the cache
+	graph.Clear();
+	BuildDeferredGraph( graph, 1280, 720 );
+	graph.Compile();
+	VE_CHECK_EQUAL( graph.GetStatistics().RenderPassCount, 2u );
+	VE_CHECK_EQUAL( graph.GetStatistics().ReusedRenderPassCount, 2u );
+
+	// Both render passes write the back buffer, a new surface format changes both
+	graph.Clear();
+	BuildDeferredGraph( graph, 1280, 720, VK_FORMAT_R8G8B8A8_UNORM );
+	graph.Compile();
+	VE_CHECK_EQUAL( graph.GetStatistics().ReusedRenderPassCount, 0u );
+}
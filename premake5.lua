@@ -20,8 +20,12 @@ workspace "VulkanEngine"
 outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
 group "Dependencies"
-	include "VulkanEngine/vendor/GLFW"
+	if os.istarget( "windows" ) then
+		include "VulkanEngine/vendor/GLFW"
+	end
 group ""
 
 include "VulkanEngine"
-include "VulkanEngineEditor"
\ No newline at end of file
+include "VulkanEngineEditor"
+include "VulkanEngineBench"
+include "VulkanEngineTests"
\ No newline at end of file